@@ -0,0 +1,93 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   BackfillDatabase.h
+///
+
+#ifndef QUALITYCONTROL_BACKFILLDATABASE_H
+#define QUALITYCONTROL_BACKFILLDATABASE_H
+
+#include "QualityControl/DatabaseInterface.h"
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2::quality_control::postprocessing
+{
+
+/// \brief A database which serves the objects as they were at the timestamp being backfilled
+///
+/// It wraps another database, forwarding all the calls. Retrievals done without an explicit timestamp are done at the
+/// current timestamp of the backfill timeline, so post-processing tasks get the past versions of the objects without
+/// any changes. The monitor and quality objects retrieved for the first timestamp are remembered and then retrieved
+/// ahead for the upcoming timestamps by prefetching threads, thus the task usually gets objects which are already
+/// downloaded. The underlying database has to support concurrent retrievals. The prefetching threads do not log.
+class BackfillDatabase : public repository::DatabaseInterface
+{
+ public:
+  /// \param database       The database to retrieve objects from and to store them to
+  /// \param timeline       Timestamps to backfill (ms since epoch), in ascending order
+  /// \param prefetchDepth  Number of the upcoming timestamps retrieved in parallel, 0 disables prefetching
+  BackfillDatabase(std::shared_ptr<repository::DatabaseInterface> database, std::vector<long> timeline, size_t prefetchDepth = 8);
+  ~BackfillDatabase() override;
+
+  /// \brief Moves to the next timestamp of the timeline. Returns false if there are no more timestamps.
+  bool next();
+  /// \brief The timestamp which is being backfilled (ms since epoch).
+  long getCurrentTimestamp() const;
+
+  void connect(std::string host, std::string database, std::string username, std::string password) override;
+  void connect(const std::unordered_map<std::string, std::string>& config) override;
+  void storeMO(std::shared_ptr<o2::quality_control::core::MonitorObject> mo) override;
+  void storeQO(std::shared_ptr<o2::quality_control::core::QualityObject> qo) override;
+  std::shared_ptr<o2::quality_control::core::MonitorObject> retrieveMO(std::string taskName, std::string objectName, long timestamp = -1) override;
+  std::shared_ptr<o2::quality_control::core::QualityObject> retrieveQO(std::string qoPath, long timestamp = -1) override;
+  TObject* retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp = -1, std::map<std::string, std::string>* headers = nullptr) override;
+  std::string retrieveMOJson(std::string taskName, std::string objectName, long timestamp = -1) override;
+  std::string retrieveQOJson(std::string qoPath, long timestamp = -1) override;
+  std::string retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata) override;
+  void disconnect() override;
+  void prepareTaskDataContainer(std::string taskName) override;
+  std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  std::vector<long> getTimestampsForObject(std::string path, long from, long to) override;
+  void truncate(std::string taskName, std::string objectName) override;
+
+ private:
+  struct Request {
+    bool quality = false;
+    std::string taskName; // or path of a quality object
+    std::string objectName;
+  };
+  struct Objects {
+    std::map<std::string, std::shared_ptr<o2::quality_control::core::MonitorObject>> monitorObjects;
+    std::map<std::string, std::shared_ptr<o2::quality_control::core::QualityObject>> qualityObjects;
+  };
+
+  long resolve(long timestamp) const;
+  void prefetch();
+  static Objects fetch(std::shared_ptr<repository::DatabaseInterface> database, std::vector<Request> requests, long timestamp);
+
+  std::shared_ptr<repository::DatabaseInterface> mDatabase;
+  std::vector<long> mTimeline;
+  size_t mPrefetchDepth;
+  size_t mCurrent;
+  bool mRecording = true;
+  std::vector<Request> mRequests;
+  std::map<size_t, std::future<Objects>> mPrefetched;
+  Objects mCurrentObjects;
+};
+
+} // namespace o2::quality_control::postprocessing
+
+#endif //QUALITYCONTROL_BACKFILLDATABASE_H
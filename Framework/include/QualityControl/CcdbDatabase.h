@@ -75,6 +75,7 @@ class CcdbDatabase : public DatabaseInterface
   void disconnect() override;
   void prepareTaskDataContainer(std::string taskName) override;
   std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  std::vector<long> getTimestampsForObject(std::string path, long from, long to) override;
   void truncate(std::string taskName, std::string objectName) override;
   void storeStreamerInfosToFile(std::string filename);
   static long getCurrentTimestamp();
@@ -85,6 +86,13 @@ class CcdbDatabase : public DatabaseInterface
   * @return The listing of folder and/or objects at the subpath.
   */
   std::vector<std::string> getListing(std::string subpath = "");
+  /**
+   * Return the identifiers (ETags) of the latest versions of all the objects matching the path pattern.
+   * Only one request is sent to the server, regardless of the number of matching objects.
+   * @param pathPattern Path or a regular expression matching the paths, e.g. "qc/TST/.*"
+   * @return Map of object paths (without the leading slash) to the identifiers of their latest versions.
+   */
+  std::unordered_map<std::string, std::string> getLatestVersionIds(std::string pathPattern);
 
  private:
   /**
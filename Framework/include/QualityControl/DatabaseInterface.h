@@ -128,6 +128,15 @@ class DatabaseInterface
    */
   virtual void prepareTaskDataContainer(std::string taskName) = 0;
   virtual std::vector<std::string> getPublishedObjectNames(std::string taskName) = 0;
+  /**
+   * \brief Look up the versions of an object stored in the given interval.
+   * @param path Path of the object
+   * @param from Beginning of the interval, in ms since epoch
+   * @param to End of the interval (included), in ms since epoch
+   * @return Timestamps (validity start, ms since epoch) of the versions, in ascending order.
+   * @throw DatabaseException if the database does not keep the previous versions of objects.
+   */
+  virtual std::vector<long> getTimestampsForObject(std::string path, long from, long to) = 0;
   /**
    * Delete all versions of a given object
    * @param taskName Task sending the object
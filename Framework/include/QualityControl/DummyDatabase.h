@@ -45,6 +45,7 @@ class DummyDatabase : public DatabaseInterface
   void disconnect() override;
   void prepareTaskDataContainer(std::string taskName) override;
   std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  std::vector<long> getTimestampsForObject(std::string path, long from, long to) override;
   void truncate(std::string taskName, std::string objectName) override;
 
  private:
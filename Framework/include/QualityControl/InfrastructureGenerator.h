@@ -25,6 +25,7 @@ class CompletionPolicy;
 }
 #include <Framework/WorkflowSpec.h>
 #include <Framework/DataProcessorSpec.h>
+#include <Mergers/MergerConfig.h>
 
 namespace o2::quality_control
 {
@@ -125,23 +126,39 @@ class InfrastructureGenerator
   static void generateDataSamplingPolicyLocalProxy(framework::WorkflowSpec& workflow,
                                                    const std::string& policyName,
                                                    const framework::Inputs& inputSpecs,
-                                                   const std::string& localPort);
+                                                   const std::string& localPort,
+                                                   const std::string& transport);
   static void generateDataSamplingPolicyRemoteProxy(framework::WorkflowSpec& workflow,
                                                     const framework::Outputs& outputSpecs,
                                                     const std::string& localMachine,
-                                                    const std::string& localPort);
+                                                    const std::string& localPort,
+                                                    const std::string& transport);
   static void generateLocalTaskLocalProxy(framework::WorkflowSpec& workflow,
                                           size_t id,
                                           std::string taskName,
                                           std::string remoteHost,
-                                          std::string remotePort);
+                                          std::string remotePort,
+                                          const std::string& transport);
   static void generateLocalTaskRemoteProxy(framework::WorkflowSpec& workflow,
                                            std::string taskName,
                                            size_t numberOfLocalMachines,
-                                           std::string remotePort);
+                                           std::string remotePort,
+                                           const std::string& transport);
+  static void generateLocalTaskReplicas(framework::WorkflowSpec& workflow,
+                                        std::string taskName,
+                                        std::string configurationSource,
+                                        size_t id,
+                                        size_t numberOfLocalMachines,
+                                        size_t parallelism,
+                                        bool shardBySubSpec,
+                                        bool publishDifferences,
+                                        double cycleDurationSeconds);
   static void generateMergers(framework::WorkflowSpec& workflow,
+                              std::string infrastructureName,
                               std::string taskName,
-                              size_t numberOfLocalMachines,
+                              const std::vector<size_t>& inputIds,
+                              size_t outputId,
+                              mergers::MergedObjectTimespan mergedObjectTimespan,
                               double cycleDurationSeconds);
   static void generateCheckRunners(framework::WorkflowSpec& workflow, std::string configurationSource);
 };
@@ -53,6 +53,7 @@ class MySqlDatabase : public DatabaseInterface
 
   void disconnect() override;
   std::vector<std::string> getPublishedObjectNames(std::string taskName) override;
+  std::vector<long> getTimestampsForObject(std::string path, long from, long to) override;
   std::vector<std::string> getListOfTasksWithPublications();
   void truncate(std::string taskName, std::string objectName) override;
 
@@ -0,0 +1,92 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    NewObjectWatcher.h
+///
+
+#ifndef QUALITYCONTROL_NEWOBJECTWATCHER_H
+#define QUALITYCONTROL_NEWOBJECTWATCHER_H
+
+#include "QualityControl/Triggers.h"
+
+#include <Common/Timer.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace o2::quality_control::repository
+{
+class CcdbDatabase;
+}
+
+namespace o2::quality_control::postprocessing
+{
+
+/// \brief Detects new versions of objects in the QC repository on behalf of NewObject triggers.
+///
+/// All the NewObject triggers created with the same watcher share one listing of the repository per polling period,
+/// regardless of how many objects they observe. The listing returns the identifiers (ETags) of the latest versions,
+/// which are compared with the ones seen during the previous poll. The first poll only establishes the baseline.
+class NewObjectWatcher
+{
+ public:
+  /// \brief Returns a map of object paths to the identifiers of their latest versions, which match the pattern.
+  using ListingFcn = std::function<std::unordered_map<std::string, std::string>(const std::string& databaseUrl, const std::string& pathPattern)>;
+
+  /// \param listing    Function used to list the repository, CCDB is used if empty.
+  /// \param periodSec  Minimum time between two consecutive listings of the repository.
+  explicit NewObjectWatcher(ListingFcn listing = {}, double periodSec = 5.0);
+  ~NewObjectWatcher();
+
+  /// \brief The watcher shared by all the triggers in the process.
+  static NewObjectWatcher& getInstance();
+
+  /// \brief Creates a trigger which fires once for each new version of the object in the repository.
+  TriggerFcn createTrigger(std::string databaseUrl, std::string objectPath);
+  /// \brief Sets the minimum time between two consecutive listings of the repository.
+  void setPollingPeriod(double seconds);
+  /// \brief Number of repository listings done so far.
+  size_t getNumberOfListings() const;
+
+  static std::string normalizePath(const std::string& path);
+
+ private:
+  struct ObjectState {
+    std::string version;
+    uint64_t generation = 0; // increased each time a new version is seen
+    bool initialized = false;
+    size_t subscribers = 0;
+  };
+  struct Subscription;
+
+  bool hasNewVersion(Subscription& subscription);
+  void pollIfNeeded();
+  void poll();
+  void unsubscribe(const std::string& databaseUrl, const std::string& objectPath);
+  std::unordered_map<std::string, std::string> listCcdb(const std::string& databaseUrl, const std::string& pathPattern);
+
+  mutable std::mutex mMutex;
+  ListingFcn mListing;
+  double mPeriodSec;
+  AliceO2::Common::Timer mPollTimer;
+  bool mPollRequested = true;
+  size_t mListingsCount = 0;
+  // database url -> object path -> state
+  std::map<std::string, std::map<std::string, ObjectState>> mObjects;
+  std::map<std::string, std::unique_ptr<repository::CcdbDatabase>> mDatabases;
+};
+
+} // namespace o2::quality_control::postprocessing
+
+#endif //QUALITYCONTROL_NEWOBJECTWATCHER_H
@@ -36,6 +36,8 @@ struct PostProcessingConfig {
   std::string moduleName = "";
   std::string className = "";
   std::string detectorName = "MISC";
+  std::string qcdbUrl = "";
+  double periodSeconds = -1.0; // period of checking triggers, negative means it is decided by the runner
   std::vector<std::string> initTriggers = {};
   std::vector<std::string> updateTriggers = {};
   std::vector<std::string> stopTriggers = {};
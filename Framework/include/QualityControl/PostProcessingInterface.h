@@ -17,6 +17,7 @@
 #define QUALITYCONTROL_POSTPROCESSINTERFACE_H
 
 #include <string>
+#include <vector>
 #include <Framework/ServiceRegistry.h>
 #include "QualityControl/Triggers.h"
 
@@ -66,6 +67,11 @@ class PostProcessingInterface
   /// \param services Interface containing optional interfaces, for example DatabaseInterface
   virtual void finalize(Trigger trigger, framework::ServiceRegistry& services) = 0;
 
+  /// \brief Paths of the objects in QC repository which are processed by the task.
+  /// They are used to find the object versions to replay when backfilling. Tasks which do not override it cannot be
+  /// backfilled.
+  virtual std::vector<std::string> getInputPaths() const;
+
   // todo: ccdb api which does not allow to delete?
 
   void setName(const std::string& name);
@@ -53,6 +53,19 @@ class PostProcessingRunner
   void stop();
   /// \brief Reset transition. Throws on errors.
   void reset();
+  /// \brief Runs the task over the past versions of its input objects. Throws on errors.
+  ///
+  /// The task is initialized, updated once for each version of its input objects stored in the [from, to] interval,
+  /// in time order and as fast as possible, and finalized. Objects retrieved by the task without giving a timestamp
+  /// are the ones valid at the time of the version being replayed. It can be used instead of start(), after init().
+  /// \param from           Beginning of the interval, in ms since epoch
+  /// \param to             End of the interval, in ms since epoch
+  /// \param prefetchDepth  Number of the upcoming versions retrieved in parallel
+  void backfill(long from, long to, size_t prefetchDepth = 8);
+
+  /// \brief Sets a database which should be used instead of creating a new one in init(). It might be shared.
+  void setDatabase(std::shared_ptr<o2::quality_control::repository::DatabaseInterface> database);
+  const std::string& getName() const;
 
  private:
   void doInitialize(Trigger trigger);
@@ -0,0 +1,79 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PostProcessingScheduler.h
+///
+
+#ifndef QUALITYCONTROL_POSTPROCESSINGSCHEDULER_H
+#define QUALITYCONTROL_POSTPROCESSINGSCHEDULER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <Common/Timer.h>
+#include "QualityControl/PostProcessingRunner.h"
+#include "QualityControl/TimerWheel.h"
+
+namespace o2::quality_control::postprocessing
+{
+
+/// \brief A class driving the execution of many post-processing tasks in one process
+///
+/// It hosts one PostProcessingRunner per task. All of them share one database connection, so e.g. the streamer infos
+/// are loaded only once. The triggers of a task are checked every "periodSeconds" (taken from the task configuration,
+/// or the default period of the scheduler if not set) with the help of a timer wheel, so each iteration only looks at
+/// the tasks which are due. Due tasks are executed one after another in the thread calling run(), since the tasks share
+/// the database connection and the QcInfoLogger, which cannot be used by many threads at the same time.
+class PostProcessingScheduler
+{
+ public:
+  /// \param names          Names of the post-processing tasks to run
+  /// \param configPath     Path to the configuration file
+  /// \param periodSeconds  Default period of checking triggers of a task, also the resolution of the scheduler
+  PostProcessingScheduler(std::vector<std::string> names, std::string configPath, double periodSeconds = 1.0);
+  ~PostProcessingScheduler() = default;
+
+  /// \brief Initialization. Throws on errors.
+  void init();
+  /// \brief One iteration over the event loop. Throws on errors. Returns false when all tasks finished.
+  bool run();
+  /// \brief Start transition. Throws on errors.
+  void start();
+  /// \brief Stop transition. Throws on errors.
+  void stop();
+  /// \brief Reset transition. Throws on errors.
+  void reset();
+
+  /// \brief The time until the next tick of the scheduler, when there might be tasks to execute.
+  double getRemainingTimeToTick();
+
+ private:
+  struct Task {
+    std::unique_ptr<PostProcessingRunner> runner;
+    uint64_t periodTicks = 1;
+    bool finished = false;
+  };
+
+  std::vector<std::string> mNames;
+  std::string mConfigPath;
+  double mPeriodSeconds;
+
+  std::vector<Task> mTasks;
+  std::shared_ptr<o2::quality_control::repository::DatabaseInterface> mDatabase;
+
+  TimerWheel mWheel;
+  AliceO2::Common::Timer mClock;
+  std::vector<size_t> mDue;
+};
+
+} // namespace o2::quality_control::postprocessing
+
+#endif //QUALITYCONTROL_POSTPROCESSINGSCHEDULER_H
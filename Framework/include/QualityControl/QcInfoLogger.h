@@ -17,6 +17,10 @@
 #define QC_CORE_QCINFOLOGGER_H
 
 #include <InfoLogger/InfoLogger.hxx>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
 
 typedef AliceO2::InfoLogger::InfoLogger infologger; // not to have to type the full stuff each time
 typedef AliceO2::InfoLogger::InfoLoggerContext infoContext;
@@ -34,6 +38,8 @@ namespace o2::quality_control::core
 ///           ILOGI << "info message" << ENDM;      // shorter
 ///           ILOG_INST << InfoLogger::InfoLoggerMessageOption{ InfoLogger::Fatal, 1, 1, "asdf", 3 }
 ///                     << "fatal message with extra fields" << ENDM; // complex version
+///           ILOG_FILTERED(Debug) << "page " << i << ENDM;           // not evaluated below the filter level
+///           ILOG_RATE_LIMITED(Error, 10) << "decoding error" << ENDM; // at most once per 10 s at this line
 ///
 /// \author Barthelemy von Haller
 class QcInfoLogger : public AliceO2::InfoLogger::InfoLogger
@@ -47,7 +53,69 @@ class QcInfoLogger : public AliceO2::InfoLogger::InfoLogger
     return foo;
   }
 
+  /// \brief Rank of a severity, from Debug (0) to Fatal (4).
+  static constexpr int level(Severity severity)
+  {
+    switch (severity) {
+      case Severity::Debug:
+        return 0;
+      case Severity::Info:
+        return 1;
+      case Severity::Warning:
+        return 2;
+      case Severity::Error:
+        return 3;
+      case Severity::Fatal:
+        return 4;
+      default:
+        return 1;
+    }
+  }
+  /// \brief Sets the lowest severity logged by ILOG_FILTERED and ILOG_RATE_LIMITED, Info by default.
+  static void setFilterLevel(Severity severity) { sFilterLevel.store(level(severity), std::memory_order_relaxed); }
+  /// \brief Sets the filter level from its name ("debug", "info", "warning", "error" or "fatal").
+  /// \return false if the name is unknown, in which case the level is not changed.
+  static bool setFilterLevel(const std::string& severity);
+  static Severity getFilterLevel();
+  /// \brief Tells if a message of this severity passes the filter level. It is only an atomic load.
+  static bool isLogged(Severity severity) { return level(severity) >= sFilterLevel.load(std::memory_order_relaxed); }
+
+  /// \brief Mutes the ILOG messages of the calling thread while it exists.
+  /// The QcInfoLogger cannot be used by many threads at the same time, thus helper threads which may run next to the
+  /// main one should be muted, e.g. the threads retrieving objects in advance. ILOG_INST is not muted.
+  class ThreadMute
+  {
+   public:
+    ThreadMute() { sThreadMuted = true; }
+    ~ThreadMute() { sThreadMuted = false; }
+    ThreadMute(const ThreadMute&) = delete;
+    ThreadMute& operator=(const ThreadMute&) = delete;
+  };
+  static bool isThreadMuted() { return sThreadMuted; }
+
+  /// \brief Lets through one message per period, the state of one call site of ILOG_RATE_LIMITED.
+  class RateLimiter
+  {
+   public:
+    explicit RateLimiter(double periodSeconds)
+      : mPeriod(static_cast<int64_t>(periodSeconds * 1e9)) {}
+    /// \brief Tells if a message can be logged now, only one of concurrent callers gets true.
+    bool allow()
+    {
+      int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+      int64_t next = mNext.load(std::memory_order_relaxed);
+      return now >= next && mNext.compare_exchange_strong(next, now + mPeriod, std::memory_order_relaxed);
+    }
+
+   private:
+    const int64_t mPeriod;
+    std::atomic<int64_t> mNext{ INT64_MIN };
+  };
+
  private:
+  static std::atomic<int> sFilterLevel;
+  static inline thread_local bool sThreadMuted = false;
+
   QcInfoLogger();
   ~QcInfoLogger() override = default;
 
@@ -61,11 +129,39 @@ class QcInfoLogger : public AliceO2::InfoLogger::InfoLogger
 // Define the ILOG() macro.
 // Unfortunately it is not possible to have a zero argument MACRO here without generating warnings
 #define ILOG_INST o2::quality_control::core::QcInfoLogger::GetInstance()
-#define ILOG(severity) ILOG_INST << AliceO2::InfoLogger::InfoLogger::Severity::severity
-#define ILOGI ILOG_INST << AliceO2::InfoLogger::InfoLogger::Info
-#define ILOGW ILOG_INST << AliceO2::InfoLogger::InfoLogger::Warning
-#define ILOGE ILOG_INST << AliceO2::InfoLogger::InfoLogger::Error
-#define ILOGF ILOG_INST << AliceO2::InfoLogger::InfoLogger::Fatal
+// The ILOG macros are statements, the rest of the statement is not evaluated in a muted thread (see ThreadMute).
+#define ILOG_UNMUTED                                              \
+  if (o2::quality_control::core::QcInfoLogger::isThreadMuted()) { \
+  } else                                                          \
+    ILOG_INST
+#define ILOG(severity) ILOG_UNMUTED << AliceO2::InfoLogger::InfoLogger::Severity::severity
+#define ILOGI ILOG_UNMUTED << AliceO2::InfoLogger::InfoLogger::Info
+#define ILOGW ILOG_UNMUTED << AliceO2::InfoLogger::InfoLogger::Warning
+#define ILOGE ILOG_UNMUTED << AliceO2::InfoLogger::InfoLogger::Error
+#define ILOGF ILOG_UNMUTED << AliceO2::InfoLogger::InfoLogger::Fatal
 #define ENDM AliceO2::InfoLogger::InfoLogger::endm;
 
+// Messages below this level are removed at compile time from ILOG_FILTERED and ILOG_RATE_LIMITED,
+// e.g. -DQC_INFOLOGGER_MIN_LEVEL=1 removes the Debug messages. See QcInfoLogger::level.
+#ifndef QC_INFOLOGGER_MIN_LEVEL
+#define QC_INFOLOGGER_MIN_LEVEL 0
+#endif
+
+#define ILOG_SEVERITY(severity) AliceO2::InfoLogger::InfoLogger::Severity::severity
+#define ILOG_ENABLED(severity)                                                                           \
+  (o2::quality_control::core::QcInfoLogger::level(ILOG_SEVERITY(severity)) >= QC_INFOLOGGER_MIN_LEVEL && \
+   o2::quality_control::core::QcInfoLogger::isLogged(ILOG_SEVERITY(severity)))
+// Same as ILOG, but the rest of the statement is evaluated only if the severity passes the filter level,
+// it should be used for the messages in the loops over the data.
+#define ILOG_FILTERED(severity)  \
+  if (!ILOG_ENABLED(severity)) { \
+  } else                         \
+    ILOG(severity)
+// Same as ILOG_FILTERED, but this line logs at most once every given number of seconds.
+#define ILOG_RATE_LIMITED(severity, seconds)                                                     \
+  if (static o2::quality_control::core::QcInfoLogger::RateLimiter qcLogRateLimiter{ (seconds) }; \
+      !(ILOG_ENABLED(severity) && qcLogRateLimiter.allow())) {                                   \
+  } else                                                                                         \
+    ILOG(severity)
+
 #endif // QC_CORE_QCINFOLOGGER_H
@@ -33,6 +33,7 @@ struct TaskConfig {
   std::string conditionUrl = "";
   std::unordered_map<std::string, std::string> customParameters = {};
   std::string detectorName = "MISC"; // intended to be the 3 letters code
+  std::string traceFile = "";        // if not empty, the task is traced and the trace is written there after each cycle
 };
 
 } // namespace o2::quality_control::core
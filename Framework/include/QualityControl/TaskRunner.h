@@ -90,6 +90,13 @@ class TaskRunner : public framework::Task
 
   void setResetAfterPublish(bool);
 
+  /// \brief Makes this TaskRunner one of the replicas of its task, which process separate data inputs.
+  ///
+  /// The data inputs, which need concrete subSpecs, are divided among the replicas.
+  /// \param replica - index of this replica, from 0 to replicas - 1
+  /// \param replicas - total number of replicas of the task
+  void setReplica(size_t replica, size_t replicas);
+
   /// \brief ID string for all TaskRunner devices
   static std::string createTaskRunnerIdString();
   /// \brief Unified DataOrigin for Quality Control tasks
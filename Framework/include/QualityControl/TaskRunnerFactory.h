@@ -45,6 +45,18 @@ class TaskRunnerFactory
   o2::framework::DataProcessorSpec
     create(std::string taskName, std::string configurationSource, size_t id = 0, bool resetAfterPublish = false);
 
+  /// \brief Creator of task replicas
+  ///
+  /// Creates one of the TaskRunners which divide the data inputs of a task on one machine. Their outputs are supposed
+  /// to be merged, thus they reset the user's task after each MO publication.
+  /// \param taskName - name of the task, which exists in tasks list in the configuration file
+  /// \param configurationSource - absolute path to configuration file, preceded with backend (f.e. "json://")
+  /// \param id - subSpecification for taskRunner's OutputSpec, it has to be different for each replica
+  /// \param replica - index of the replica, from 0 to replicas - 1
+  /// \param replicas - total number of replicas
+  o2::framework::DataProcessorSpec
+    createReplica(std::string taskName, std::string configurationSource, size_t id, size_t replica, size_t replicas);
+
   /// \brief Provides necessary customization of the TaskRunners.
   ///
   /// Provides necessary customization of the Completion Policies of the TaskRunners. This is necessary to make
@@ -0,0 +1,98 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    TimerWheel.h
+///
+
+#ifndef QUALITYCONTROL_TIMERWHEEL_H
+#define QUALITYCONTROL_TIMERWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace o2::quality_control::postprocessing
+{
+
+/// \brief A hashed timer wheel, which tells which of the scheduled items are due after each tick.
+///
+/// Scheduling and expiring an item costs O(1), while advancing by one tick costs only as much as the number of items in
+/// one slot. It allows to check the triggers of many post-processing tasks with different periods, without looking at
+/// all of them at every iteration. Items scheduled further than one rotation of the wheel wait for the corresponding
+/// number of rounds in their slot.
+class TimerWheel
+{
+ public:
+  /// \param slots  Number of slots, i.e. ticks in one rotation of the wheel.
+  explicit TimerWheel(size_t slots = 512) : mSlots(slots == 0 ? 1 : slots) {}
+  ~TimerWheel() = default;
+
+  /// \brief Schedules the item to be due after the given number of ticks (at least one).
+  void schedule(size_t item, uint64_t ticks)
+  {
+    ticks = ticks == 0 ? 1 : ticks;
+    auto& slot = mSlots[(mCurrentSlot + ticks) % mSlots.size()];
+    slot.push_back({ item, (ticks - 1) / mSlots.size() });
+    mSize++;
+  }
+
+  /// \brief Advances the wheel by the given number of ticks and appends the items which became due to the vector.
+  void advance(uint64_t ticks, std::vector<size_t>& due)
+  {
+    for (uint64_t t = 0; t < ticks && mSize > 0; t++) {
+      mCurrentSlot = (mCurrentSlot + 1) % mSlots.size();
+      auto& slot = mSlots[mCurrentSlot];
+      size_t kept = 0;
+      for (auto& entry : slot) {
+        if (entry.rounds == 0) {
+          due.push_back(entry.item);
+          mSize--;
+        } else {
+          entry.rounds--;
+          slot[kept++] = entry;
+        }
+      }
+      slot.resize(kept);
+    }
+    mTicks += ticks;
+  }
+
+  /// \brief Removes all the scheduled items and rewinds the wheel.
+  void clear()
+  {
+    for (auto& slot : mSlots) {
+      slot.clear();
+    }
+    mCurrentSlot = 0;
+    mSize = 0;
+    mTicks = 0;
+  }
+
+  /// \brief Number of ticks since construction or the last clear().
+  uint64_t getTicks() const { return mTicks; }
+  /// \brief Number of scheduled items.
+  size_t size() const { return mSize; }
+
+ private:
+  struct Entry {
+    size_t item;
+    uint64_t rounds;
+  };
+
+  std::vector<std::vector<Entry>> mSlots;
+  size_t mCurrentSlot = 0;
+  size_t mSize = 0;
+  uint64_t mTicks = 0;
+};
+
+} // namespace o2::quality_control::postprocessing
+
+#endif //QUALITYCONTROL_TIMERWHEEL_H
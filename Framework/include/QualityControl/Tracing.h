@@ -0,0 +1,134 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    Tracing.h
+///
+
+#ifndef QUALITYCONTROL_TRACING_H
+#define QUALITYCONTROL_TRACING_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace o2::quality_control::core
+{
+
+/// \brief Low-overhead tracing of the code sections executed by the QC devices and tasks.
+///
+/// Each thread records the beginning and the end of the traced sections in its own ring buffer, as pairs of an event
+/// id and a timestamp, thus recording does not lock, allocate nor format anything. When a buffer is full, the oldest
+/// records are overwritten. The buffers of all the threads can be dumped on demand in the Chrome trace event format,
+/// which can be opened with chrome://tracing or https://ui.perfetto.dev. The dump should be done while the traced
+/// threads are idle (e.g. at the end of a cycle), otherwise the records being written at that moment may be lost.
+///
+/// Tracing is disabled by default, in which case a trace marker costs one relaxed atomic load.
+class Tracing
+{
+ public:
+  using EventId = uint32_t;
+  using Clock = std::chrono::steady_clock;
+
+  enum class Phase : uint8_t {
+    Begin,
+    End
+  };
+
+  struct Record {
+    int64_t timestamp; // nanoseconds since the epoch of Clock
+    EventId event;
+    Phase phase;
+  };
+
+  /// \brief Returns the id of the event with the given name, registering it if needed. It is not meant for hot paths.
+  static EventId registerEvent(const std::string& name);
+  /// \brief Returns the name of a registered event.
+  static std::string getEventName(EventId event);
+
+  static void enable(bool enabled = true) { sEnabled.store(enabled, std::memory_order_relaxed); }
+  static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+
+  /// \brief Sets the number of records kept by each thread. It applies to the buffers created afterwards.
+  static void setBufferSize(size_t records);
+
+  static void begin(EventId event)
+  {
+    if (isEnabled()) {
+      record(event, Phase::Begin);
+    }
+  }
+  static void end(EventId event)
+  {
+    if (isEnabled()) {
+      record(event, Phase::End);
+    }
+  }
+
+  /// \brief Returns the records kept by all the threads, oldest first, grouped by thread.
+  static std::vector<std::pair<int, std::vector<Record>>> getRecords();
+  /// \brief Removes the records of all the threads.
+  static void clear();
+
+  /// \brief Writes the records of all the threads in the Chrome trace event format.
+  static void dumpChromeTrace(std::ostream& out);
+  /// \brief Writes the records of all the threads in the Chrome trace event format to the given file.
+  /// \return false if the file could not be written.
+  static bool dumpChromeTrace(const std::string& fileName);
+
+ private:
+  friend class TraceScope;
+  static void record(EventId event, Phase phase);
+
+  static std::atomic<bool> sEnabled;
+};
+
+/// \brief Traces the enclosing scope, from its construction to its destruction.
+class TraceScope
+{
+ public:
+  explicit TraceScope(Tracing::EventId event) : mEvent(event), mEnabled(Tracing::isEnabled())
+  {
+    if (mEnabled) {
+      Tracing::record(mEvent, Tracing::Phase::Begin);
+    }
+  }
+  ~TraceScope()
+  {
+    // the end is always recorded if the beginning was, such that the sections are balanced
+    if (mEnabled) {
+      Tracing::record(mEvent, Tracing::Phase::End);
+    }
+  }
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  Tracing::EventId mEvent;
+  bool mEnabled;
+};
+
+} // namespace o2::quality_control::core
+
+#define QC_TRACE_CONCAT_IMPL(a, b) a##b
+#define QC_TRACE_CONCAT(a, b) QC_TRACE_CONCAT_IMPL(a, b)
+
+/// \brief Traces the enclosing scope under the given name. The name is registered only once per call site.
+#define QC_TRACE_SCOPE(name)                                                     \
+  static const auto QC_TRACE_CONCAT(qcTraceEvent, __LINE__) =                    \
+    o2::quality_control::core::Tracing::registerEvent(name);                     \
+  o2::quality_control::core::TraceScope QC_TRACE_CONCAT(qcTraceScope, __LINE__)( \
+    QC_TRACE_CONCAT(qcTraceEvent, __LINE__))
+
+#endif // QUALITYCONTROL_TRACING_H
@@ -50,6 +50,7 @@ class TrendingTask : public PostProcessingInterface
   void initialize(Trigger, framework::ServiceRegistry&) override;
   void update(Trigger, framework::ServiceRegistry&) override;
   void finalize(Trigger, framework::ServiceRegistry&) override;
+  std::vector<std::string> getInputPaths() const override;
 
  private:
   struct MetaData {
@@ -35,6 +35,7 @@ enum Trigger {
   Periodic,
   NewObject,
   UserOrControl, // reacts start and stop transitions (not an update trigger).
+  Backfill,      // replays the past versions of objects, see PostProcessingRunner::backfill
   INVALID
 };
 
@@ -53,8 +54,8 @@ TriggerFcn StartOfFill();
 TriggerFcn EndOfFill();
 /// \brief Triggers when a period of time passes
 TriggerFcn Periodic(double seconds);
-/// \brief Triggers when it detect a new object in QC repository with given name
-TriggerFcn NewObject(std::string name);
+/// \brief Triggers when it detects a new version of an object in QC repository with given path
+TriggerFcn NewObject(std::string databaseUrl, std::string objectPath);
 /// \brief Triggers only first time it is executed
 TriggerFcn Once();
 /// \brief Triggers always
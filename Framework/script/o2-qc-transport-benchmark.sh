@@ -0,0 +1,106 @@
+#!/usr/bin/env bash
+set -e ;# exit on error
+set -u ;# exit when using undeclared variable
+#set -x ;# debugging
+
+### Notes
+# Compares the throughput of the Data Sampling proxies with the zeromq and shmem transports, when the local and remote
+# parts of the QC run on the same machine. Everything runs locally, the QC environment has to be loaded beforehand.
+# The proxies log the rates every 60 seconds, these are extracted at the end of each test.
+
+### Define matrix of tests
+TRANSPORTS=(zeromq shmem)
+MESSAGE_SIZES=(1000000 10000000 50000000) ;# in bytes
+MESSAGE_RATE=1000 ;# messages per second, the producer runs as fast as it can if it cannot keep up
+
+### Misc variables
+LOG_FILE_PREFIX=/tmp/logQcTransportBenchmark_
+CONFIG_FILE=/tmp/qcTransportBenchmark.json
+TEST_DURATION=130 ;# in seconds, it should contain at least two rate logging periods
+PAUSE_BTW_RUNS=5 ;# in seconds, pause between tests
+SESSION=qc-transport-benchmark ;# both workflows have to use the same shared memory session
+
+### Utility functions
+# Prepare the config file
+# \param 1 : transport
+function prepareConfigFile {
+  transport=$1
+  cat > ${CONFIG_FILE} <<EOF
+{
+  "qc": {
+    "config": {
+      "database": { "implementation": "CCDB", "host": "ccdb-test.cern.ch:8080", "username": "not_applicable", "password": "not_applicable", "name": "not_applicable" },
+      "Activity": { "number": "42", "type": "2" },
+      "monitoring": { "url": "infologger:///debug?qc" },
+      "consul": { "url": "" },
+      "conditionDB": { "url": "ccdb-test.cern.ch:8080" }
+    },
+    "tasks": {
+      "TransportBenchmark": {
+        "active": "true",
+        "className": "o2::quality_control_modules::skeleton::SkeletonTask",
+        "moduleName": "QcSkeleton",
+        "detectorName": "TST",
+        "cycleDurationSeconds": "60",
+        "maxNumberCycles": "-1",
+        "dataSource": { "type": "dataSamplingPolicy", "name": "all" },
+        "location": "remote"
+      }
+    }
+  },
+  "dataSamplingPolicies": [
+    {
+      "id": "all",
+      "active": "true",
+      "machines": [ "localhost" ],
+      "port": "30334",
+      "transport": "${transport}",
+      "query": "data:TST/RAWDATA",
+      "samplingConditions": [ { "condition": "random", "fraction": "1", "seed": "1234" } ],
+      "blocking": "false"
+    }
+  ]
+}
+EOF
+}
+
+# Run the local and remote parts of the QC for the test duration
+# \param 1 : message size
+# \param 2 : log file suffix
+function runTest {
+  size=$1
+  log_file_suffix=$2
+  local_log=${LOG_FILE_PREFIX}local_${log_file_suffix}.log
+  remote_log=${LOG_FILE_PREFIX}remote_${log_file_suffix}.log
+  echo "Starting the local part, logs in ${local_log}"
+  o2-qc-run-producer --min-size ${size} --max-size ${size} --message-rate ${MESSAGE_RATE} --empty -b --session ${SESSION} \
+    | o2-qc --config json:/${CONFIG_FILE} --local --host localhost -b --session ${SESSION} > ${local_log} 2>&1 &
+  local_pid=$!
+  echo "Starting the remote part, logs in ${remote_log}"
+  o2-qc --config json:/${CONFIG_FILE} --remote -b --session ${SESSION} > ${remote_log} 2>&1 &
+  remote_pid=$!
+
+  sleep ${TEST_DURATION}
+  kill ${local_pid} ${remote_pid} > /dev/null 2>&1 || true
+  wait > /dev/null 2>&1 || true
+}
+
+### Benchmark starts here
+for transport in ${TRANSPORTS[@]}; do
+  prepareConfigFile ${transport}
+  for size in ${MESSAGE_SIZES[@]}; do
+    echo "*************************** $(date)
+    Launching test for the ${transport} transport, messages of ${size} bytes"
+    runTest ${size} "${transport}_${size}"
+    sleep ${PAUSE_BTW_RUNS}
+  done
+done
+
+### Results
+echo "*************************** Results (rates reported by the remote proxy)"
+for transport in ${TRANSPORTS[@]}; do
+  for size in ${MESSAGE_SIZES[@]}; do
+    echo "${transport}, ${size} bytes:"
+    grep -E "MB/s|msg/s" ${LOG_FILE_PREFIX}remote_${transport}_${size}.log | tail -n 2 || echo "  no rates found"
+  done
+done
@@ -0,0 +1,217 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   BackfillDatabase.cxx
+///
+
+#include "QualityControl/BackfillDatabase.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <TROOT.h>
+#include <algorithm>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+
+namespace o2::quality_control::postprocessing
+{
+
+constexpr size_t beforeStart = static_cast<size_t>(-1);
+
+BackfillDatabase::BackfillDatabase(std::shared_ptr<DatabaseInterface> database, std::vector<long> timeline, size_t prefetchDepth)
+  : mDatabase(std::move(database)), mTimeline(std::move(timeline)), mPrefetchDepth(prefetchDepth), mCurrent(beforeStart)
+{
+  if (mPrefetchDepth > 0) {
+    // objects are deserialized by the prefetching threads
+    ROOT::EnableThreadSafety();
+  }
+}
+
+BackfillDatabase::~BackfillDatabase()
+{
+  // waiting for the prefetching threads before the database goes away
+  for (auto& [index, objects] : mPrefetched) {
+    if (objects.valid()) {
+      objects.wait();
+    }
+  }
+}
+
+bool BackfillDatabase::next()
+{
+  mCurrent = mCurrent == beforeStart ? 0 : mCurrent + 1;
+  mCurrentObjects = {};
+  if (mCurrent >= mTimeline.size()) {
+    return false;
+  }
+  // we know which objects are needed once the first timestamp has been processed
+  mRecording = mCurrent == 0;
+
+  prefetch();
+  if (auto prefetched = mPrefetched.find(mCurrent); prefetched != mPrefetched.end()) {
+    try {
+      mCurrentObjects = prefetched->second.get();
+    } catch (const std::exception& ex) {
+      ILOG(Warning) << "Could not prefetch the objects for the timestamp " << mTimeline[mCurrent] << ", they will be retrieved on demand: " << ex.what() << ENDM;
+    }
+    mPrefetched.erase(prefetched);
+  }
+  return true;
+}
+
+long BackfillDatabase::getCurrentTimestamp() const
+{
+  return mCurrent < mTimeline.size() ? mTimeline[mCurrent] : -1;
+}
+
+long BackfillDatabase::resolve(long timestamp) const
+{
+  return timestamp == -1 ? getCurrentTimestamp() : timestamp;
+}
+
+void BackfillDatabase::prefetch()
+{
+  if (mRecording || mRequests.empty() || mPrefetchDepth == 0) {
+    return;
+  }
+  for (size_t index = mCurrent; index < std::min(mCurrent + mPrefetchDepth, mTimeline.size()); index++) {
+    if (mPrefetched.count(index) == 0) {
+      mPrefetched[index] = std::async(std::launch::async, &BackfillDatabase::fetch, mDatabase, mRequests, mTimeline[index]);
+    }
+  }
+}
+
+BackfillDatabase::Objects BackfillDatabase::fetch(std::shared_ptr<DatabaseInterface> database, std::vector<Request> requests, long timestamp)
+{
+  // the databases log the failed retrievals, this cannot be done next to the main thread. The objects which could not
+  // be retrieved are left out, so they are retrieved again on demand by the main thread, which logs the problem.
+  QcInfoLogger::ThreadMute mute;
+  Objects objects;
+  for (const auto& request : requests) {
+    if (request.quality) {
+      if (auto qo = database->retrieveQO(request.taskName, timestamp)) {
+        objects.qualityObjects[request.taskName] = std::move(qo);
+      }
+    } else {
+      if (auto mo = database->retrieveMO(request.taskName, request.objectName, timestamp)) {
+        objects.monitorObjects[request.taskName + "/" + request.objectName] = std::move(mo);
+      }
+    }
+  }
+  return objects;
+}
+
+void BackfillDatabase::connect(std::string host, std::string database, std::string username, std::string password)
+{
+  mDatabase->connect(host, database, username, password);
+}
+
+void BackfillDatabase::connect(const std::unordered_map<std::string, std::string>& config)
+{
+  mDatabase->connect(config);
+}
+
+void BackfillDatabase::storeMO(std::shared_ptr<MonitorObject> mo)
+{
+  mDatabase->storeMO(mo);
+}
+
+void BackfillDatabase::storeQO(std::shared_ptr<QualityObject> qo)
+{
+  mDatabase->storeQO(qo);
+}
+
+std::shared_ptr<MonitorObject> BackfillDatabase::retrieveMO(std::string taskName, std::string objectName, long timestamp)
+{
+  if (timestamp != -1) {
+    return mDatabase->retrieveMO(taskName, objectName, timestamp);
+  }
+
+  if (auto prefetched = mCurrentObjects.monitorObjects.find(taskName + "/" + objectName); prefetched != mCurrentObjects.monitorObjects.end()) {
+    auto mo = std::move(prefetched->second);
+    mCurrentObjects.monitorObjects.erase(prefetched);
+    return mo;
+  }
+  if (mRecording) {
+    auto sameRequest = [&](const Request& r) { return !r.quality && r.taskName == taskName && r.objectName == objectName; };
+    if (std::none_of(mRequests.begin(), mRequests.end(), sameRequest)) {
+      mRequests.push_back({ false, taskName, objectName });
+    }
+  }
+  return mDatabase->retrieveMO(taskName, objectName, getCurrentTimestamp());
+}
+
+std::shared_ptr<QualityObject> BackfillDatabase::retrieveQO(std::string qoPath, long timestamp)
+{
+  if (timestamp != -1) {
+    return mDatabase->retrieveQO(qoPath, timestamp);
+  }
+
+  if (auto prefetched = mCurrentObjects.qualityObjects.find(qoPath); prefetched != mCurrentObjects.qualityObjects.end()) {
+    auto qo = std::move(prefetched->second);
+    mCurrentObjects.qualityObjects.erase(prefetched);
+    return qo;
+  }
+  if (mRecording) {
+    auto sameRequest = [&](const Request& r) { return r.quality && r.taskName == qoPath; };
+    if (std::none_of(mRequests.begin(), mRequests.end(), sameRequest)) {
+      mRequests.push_back({ true, qoPath, "" });
+    }
+  }
+  return mDatabase->retrieveQO(qoPath, getCurrentTimestamp());
+}
+
+TObject* BackfillDatabase::retrieveTObject(std::string path, const std::map<std::string, std::string>& metadata, long timestamp, std::map<std::string, std::string>* headers)
+{
+  return mDatabase->retrieveTObject(path, metadata, resolve(timestamp), headers);
+}
+
+std::string BackfillDatabase::retrieveMOJson(std::string taskName, std::string objectName, long timestamp)
+{
+  return mDatabase->retrieveMOJson(taskName, objectName, resolve(timestamp));
+}
+
+std::string BackfillDatabase::retrieveQOJson(std::string qoPath, long timestamp)
+{
+  return mDatabase->retrieveQOJson(qoPath, resolve(timestamp));
+}
+
+std::string BackfillDatabase::retrieveJson(std::string path, long timestamp, const std::map<std::string, std::string>& metadata)
+{
+  return mDatabase->retrieveJson(path, resolve(timestamp), metadata);
+}
+
+void BackfillDatabase::disconnect()
+{
+  mDatabase->disconnect();
+}
+
+void BackfillDatabase::prepareTaskDataContainer(std::string taskName)
+{
+  mDatabase->prepareTaskDataContainer(taskName);
+}
+
+std::vector<std::string> BackfillDatabase::getPublishedObjectNames(std::string taskName)
+{
+  return mDatabase->getPublishedObjectNames(taskName);
+}
+
+std::vector<long> BackfillDatabase::getTimestampsForObject(std::string path, long from, long to)
+{
+  return mDatabase->getTimestampsForObject(path, from, to);
+}
+
+void BackfillDatabase::truncate(std::string taskName, std::string objectName)
+{
+  mDatabase->truncate(taskName, objectName);
+}
+
+} // namespace o2::quality_control::postprocessing
@@ -342,6 +342,54 @@ std::vector<std::string> CcdbDatabase::getPublishedObjectNames(std::string taskN
   return result;
 }
 
+std::vector<long> CcdbDatabase::getTimestampsForObject(std::string path, long from, long to)
+{
+  std::vector<long> result;
+  // the listing contains all the versions of the object when we do not ask only for the latest ones
+  string listing = ccdbApi.list(path, false, "Application/JSON");
+
+  boost::property_tree::ptree pt;
+  stringstream ss;
+  ss << listing;
+  boost::property_tree::read_json(ss, pt);
+
+  BOOST_FOREACH (boost::property_tree::ptree::value_type& v, pt.get_child("objects")) {
+    assert(v.first.empty()); // array elements have no names
+    // the path might be matched as a prefix, we do not want the objects in its subfolders
+    if (v.second.get<string>("path") != path) {
+      continue;
+    }
+    long validFrom = v.second.get<long>("validFrom");
+    if (validFrom >= from && validFrom <= to) {
+      result.push_back(validFrom);
+    }
+  }
+  std::sort(result.begin(), result.end());
+
+  return result;
+}
+
+std::unordered_map<std::string, std::string> CcdbDatabase::getLatestVersionIds(std::string pathPattern)
+{
+  std::unordered_map<std::string, std::string> result;
+  string listing = ccdbApi.list(pathPattern, true, "Application/JSON");
+
+  boost::property_tree::ptree pt;
+  stringstream ss;
+  ss << listing;
+  boost::property_tree::read_json(ss, pt);
+
+  BOOST_FOREACH (boost::property_tree::ptree::value_type& v, pt.get_child("objects")) {
+    assert(v.first.empty()); // array elements have no names
+    string path = v.second.get<string>("path");
+    // the object id is also its ETag, it changes with each new version
+    string id = v.second.get<string>("id", v.second.get<string>("createTime", ""));
+    result[path] = id;
+  }
+
+  return result;
+}
+
 long CcdbDatabase::getFutureTimestamp(int secondsInFuture)
 {
   std::chrono::seconds sec(secondsInFuture);
@@ -69,6 +69,11 @@ std::vector<std::string> DummyDatabase::getPublishedObjectNames(std::string)
   return std::vector<std::string>();
 }
 
+std::vector<long> DummyDatabase::getTimestampsForObject(std::string, long, long)
+{
+  return std::vector<long>();
+}
+
 void DummyDatabase::truncate(std::string, std::string)
 {
 }
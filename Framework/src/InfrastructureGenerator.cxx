@@ -32,6 +32,7 @@
 #include <Mergers/MergerBuilder.h>
 
 #include <algorithm>
+#include <numeric>
 
 using namespace o2::framework;
 using namespace o2::configuration;
@@ -43,6 +44,36 @@ using SubSpec = o2::header::DataHeader::SubSpecificationType;
 namespace o2::quality_control::core
 {
 
+namespace
+{
+// Both ends of a proxy channel are generated separately (local and remote parts), so the transport has to be decided
+// only with the information available in the configuration file, the same for both of them. Shared memory is used only
+// when requested explicitly, because it requires both workflows to run on the same host with the same --session.
+std::string checkTransport(const std::string& transport)
+{
+  if (transport == "zeromq" || transport == "shmem") {
+    return transport;
+  } else {
+    throw std::runtime_error("Configuration error: transport unknown : " + transport);
+  }
+}
+
+std::string transportForTask(const ptree& taskConfig)
+{
+  return checkTransport(taskConfig.get<std::string>("transport", "zeromq"));
+}
+
+std::string transportForPolicy(ConfigurationInterface* config, const std::string& policyName)
+{
+  for (const auto& policy : config->getRecursive("dataSamplingPolicies")) {
+    if (policy.second.get<std::string>("id") == policyName) {
+      return checkTransport(policy.second.get<std::string>("transport", "zeromq"));
+    }
+  }
+  return "zeromq";
+}
+} // namespace
+
 framework::WorkflowSpec InfrastructureGenerator::generateStandaloneInfrastructure(std::string configurationSource)
 {
   WorkflowSpec workflow;
@@ -83,16 +114,32 @@ WorkflowSpec InfrastructureGenerator::generateLocalInfrastructure(std::string co
           throw std::runtime_error("No local machines specified for task " + taskName + " in its configuration");
         }
 
-        bool needsMergers = taskConfig.get_child("localMachines").size() > 1;
+        size_t numberOfLocalMachines = taskConfig.get_child("localMachines").size();
+        bool needsMergers = numberOfLocalMachines > 1;
+        auto parallelism = taskConfig.get<size_t>("parallelism", 1);
+        if (parallelism == 0) {
+          throw std::runtime_error("Configuration error: parallelism of the task " + taskName + " should be at least 1");
+        }
         size_t id = needsMergers ? 1 : 0;
         for (const auto& machine : taskConfig.get_child("localMachines")) {
           // We spawn a task and proxy only if we are on the right machine.
           if (machine.second.get<std::string>("") == host) {
-            // Generate QC Task Runner
-            workflow.emplace_back(taskRunnerFactory.create(taskName, configurationSource, id, needsMergers));
+            if (parallelism > 1) {
+              // Generate QC Task Runner replicas and a Merger which combines their results
+              auto sharding = taskConfig.get<std::string>("sharding", "roundRobin");
+              if (sharding != "roundRobin" && sharding != "subSpec") {
+                throw std::runtime_error("Configuration error: sharding of the task " + taskName + " unknown : " + sharding);
+              }
+              generateLocalTaskReplicas(workflow, taskName, configurationSource, id, numberOfLocalMachines, parallelism,
+                                        sharding == "subSpec", needsMergers, taskConfig.get<double>("cycleDurationSeconds"));
+            } else {
+              // Generate QC Task Runner
+              workflow.emplace_back(taskRunnerFactory.create(taskName, configurationSource, id, needsMergers));
+            }
             // Generate an output proxy
             // These should be removed when we are able to declare dangling output in normal DPL devices
-            generateLocalTaskLocalProxy(workflow, id, taskName, taskConfig.get<std::string>("remoteMachine"), taskConfig.get<std::string>("remotePort"));
+            generateLocalTaskLocalProxy(workflow, id, taskName, taskConfig.get<std::string>("remoteMachine"), taskConfig.get<std::string>("remotePort"),
+                                        transportForTask(taskConfig));
             break;
           }
           id++;
@@ -121,7 +168,8 @@ WorkflowSpec InfrastructureGenerator::generateLocalInfrastructure(std::string co
     std::vector<std::string> machines = DataSampling::MachinesForPolicy(config.get(), policyName);
     for (const auto& machine : machines) {
       if (machine == host) {
-        generateDataSamplingPolicyLocalProxy(workflow, policyName, inputSpecs, port);
+        generateDataSamplingPolicyLocalProxy(workflow, policyName, inputSpecs, port,
+                                             transportForPolicy(config.get(), policyName));
       }
     }
   }
@@ -153,13 +201,17 @@ o2::framework::WorkflowSpec InfrastructureGenerator::generateRemoteInfrastructur
 
         // Generate an input proxy
         // These should be removed when we are able to declare dangling inputs in normal DPL devices
-        generateLocalTaskRemoteProxy(workflow, taskName, numberOfLocalMachines, taskConfig.get<std::string>("remotePort"));
+        generateLocalTaskRemoteProxy(workflow, taskName, numberOfLocalMachines, taskConfig.get<std::string>("remotePort"),
+                                     transportForTask(taskConfig));
 
         // Generate a Merger only when there is a need to merge something - there is more than one machine with the QC Task
         // I don't expect the list of machines to be reconfigured - all of them should be declared beforehand,
         // even if some of them will be on standby.
         if (numberOfLocalMachines > 1) {
-          generateMergers(workflow, taskName, numberOfLocalMachines, taskConfig.get<double>("cycleDurationSeconds"));
+          std::vector<size_t> inputIds(numberOfLocalMachines);
+          std::iota(inputIds.begin(), inputIds.end(), 1);
+          generateMergers(workflow, taskName, taskName, inputIds, 0, MergedObjectTimespan::FullHistory,
+                          taskConfig.get<double>("cycleDurationSeconds"));
         }
 
       } else if (taskConfig.get<std::string>("location") == "remote") {
@@ -196,7 +248,8 @@ o2::framework::WorkflowSpec InfrastructureGenerator::generateRemoteInfrastructur
     Outputs outputSpecs = DataSampling::OutputSpecsForPolicy(config.get(), policyName);
     std::vector<std::string> machines = DataSampling::MachinesForPolicy(config.get(), policyName);
     for (const auto& machine : machines) {
-      generateDataSamplingPolicyRemoteProxy(workflow, outputSpecs, machine, port);
+      generateDataSamplingPolicyRemoteProxy(workflow, outputSpecs, machine, port,
+                                            transportForPolicy(config.get(), policyName));
     }
   }
 
@@ -227,12 +280,13 @@ void InfrastructureGenerator::printVersion()
 void InfrastructureGenerator::generateDataSamplingPolicyLocalProxy(framework::WorkflowSpec& workflow,
                                                                    const string& policyName,
                                                                    const framework::Inputs& inputSpecs,
-                                                                   const string& localPort)
+                                                                   const string& localPort,
+                                                                   const std::string& transport)
 {
   std::string proxyName = policyName + "-proxy";
   std::string channelName = inputSpecs.at(0).binding; // channel name has to match binding name.
   std::string channelConfig = "name=" + channelName + ",type=push,method=bind,address=tcp://*:" + localPort +
-                              ",rateLogging=60,transport=zeromq";
+                              ",rateLogging=60,transport=" + transport;
 
   workflow.emplace_back(
     specifyFairMQDeviceOutputProxy(
@@ -244,13 +298,14 @@ void InfrastructureGenerator::generateDataSamplingPolicyLocalProxy(framework::Wo
 void InfrastructureGenerator::generateDataSamplingPolicyRemoteProxy(framework::WorkflowSpec& workflow,
                                                                     const Outputs& outputSpecs,
                                                                     const std::string& localMachine,
-                                                                    const std::string& localPort)
+                                                                    const std::string& localPort,
+                                                                    const std::string& transport)
 {
   std::string channelName = outputSpecs.at(0).binding.value; // channel name has to match binding name.
   std::string proxyName = channelName;                       // channel name has to match proxy name
 
   std::string channelConfig = "name=" + channelName + ",type=pull,method=connect,address=tcp://" +
-                              localMachine + ":" + localPort + ",rateLogging=60,transport=zeromq";
+                              localMachine + ":" + localPort + ",rateLogging=60,transport=" + transport;
 
   workflow.emplace_back(specifyExternalFairMQDeviceProxy(
     proxyName.c_str(),
@@ -261,13 +316,13 @@ void InfrastructureGenerator::generateDataSamplingPolicyRemoteProxy(framework::W
 
 void InfrastructureGenerator::generateLocalTaskLocalProxy(framework::WorkflowSpec& workflow, size_t id,
                                                           std::string taskName, std::string remoteHost,
-                                                          std::string remotePort)
+                                                          std::string remotePort, const std::string& transport)
 {
   std::string proxyName = taskName + "-proxy-" + std::to_string(id);
   std::string channelName = taskName + "-proxy";
   InputSpec proxyInput{ channelName, TaskRunner::createTaskDataOrigin(), TaskRunner::createTaskDataDescription(taskName), static_cast<SubSpec>(id) };
   std::string channelConfig = "name=" + channelName + ",type=push,method=connect,address=tcp://" +
-                              remoteHost + ":" + remotePort + ",rateLogging=60,transport=zeromq";
+                              remoteHost + ":" + remotePort + ",rateLogging=60,transport=" + transport;
 
   workflow.emplace_back(
     specifyFairMQDeviceOutputProxy(
@@ -277,7 +332,8 @@ void InfrastructureGenerator::generateLocalTaskLocalProxy(framework::WorkflowSpe
 }
 
 void InfrastructureGenerator::generateLocalTaskRemoteProxy(framework::WorkflowSpec& workflow, std::string taskName,
-                                                           size_t numberOfLocalMachines, std::string remotePort)
+                                                           size_t numberOfLocalMachines, std::string remotePort,
+                                                           const std::string& transport)
 {
   std::string proxyName = taskName + "-proxy"; // channel name has to match proxy name
   std::string channelName = taskName + "-proxy";
@@ -294,7 +350,7 @@ void InfrastructureGenerator::generateLocalTaskRemoteProxy(framework::WorkflowSp
   }
 
   std::string channelConfig = "name=" + channelName + ",type=pull,method=bind,address=tcp://*:" + remotePort +
-                              ",rateLogging=60,transport=zeromq";
+                              ",rateLogging=60,transport=" + transport;
 
   workflow.emplace_back(specifyExternalFairMQDeviceProxy(
     proxyName.c_str(),
@@ -303,11 +359,43 @@ void InfrastructureGenerator::generateLocalTaskRemoteProxy(framework::WorkflowSp
     dplModelAdaptor()));
 }
 
-void InfrastructureGenerator::generateMergers(framework::WorkflowSpec& workflow, std::string taskName,
-                                              size_t numberOfLocalMachines, double cycleDurationSeconds)
+void InfrastructureGenerator::generateLocalTaskReplicas(framework::WorkflowSpec& workflow, std::string taskName,
+                                                         std::string configurationSource, size_t id,
+                                                         size_t numberOfLocalMachines, size_t parallelism,
+                                                         bool shardBySubSpec, bool publishDifferences,
+                                                         double cycleDurationSeconds)
+{
+  // Replicas get subSpecs which cannot be taken by the outputs of any machine, so they are never confused with the
+  // merged output of the machine, which is sent to the remote side.
+  TaskRunnerFactory taskRunnerFactory;
+  std::vector<size_t> replicaIds;
+  if (shardBySubSpec) {
+    for (size_t replica = 0; replica < parallelism; replica++) {
+      size_t replicaId = numberOfLocalMachines + 1 + replica;
+      workflow.emplace_back(taskRunnerFactory.createReplica(taskName, configurationSource, replicaId, replica, parallelism));
+      replicaIds.push_back(replicaId);
+    }
+  } else {
+    // DPL sends each timeslice to only one of the time-pipelined replicas, they all share the same output
+    size_t replicaId = numberOfLocalMachines + 1;
+    workflow.emplace_back(timePipeline(taskRunnerFactory.create(taskName, configurationSource, replicaId, true), parallelism));
+    replicaIds.push_back(replicaId);
+  }
+
+  // If there are Mergers on the remote side, they expect the differences since the last publication, as sent by
+  // a single TaskRunner which resets its task after publishing.
+  generateMergers(workflow, taskName + "-replicas", taskName, replicaIds, id,
+                  publishDifferences ? MergedObjectTimespan::LastDifference : MergedObjectTimespan::FullHistory,
+                  cycleDurationSeconds);
+}
+
+void InfrastructureGenerator::generateMergers(framework::WorkflowSpec& workflow, std::string infrastructureName,
+                                              std::string taskName, const std::vector<size_t>& inputIds,
+                                              size_t outputId, MergedObjectTimespan mergedObjectTimespan,
+                                              double cycleDurationSeconds)
 {
   Inputs mergerInputs;
-  for (size_t id = 1; id <= numberOfLocalMachines; id++) {
+  for (auto id : inputIds) {
     mergerInputs.emplace_back(
       InputSpec{ { taskName + std::to_string(id) },
                  TaskRunner::createTaskDataOrigin(),
@@ -316,17 +404,17 @@ void InfrastructureGenerator::generateMergers(framework::WorkflowSpec& workflow,
   }
 
   MergerInfrastructureBuilder mergersBuilder;
-  mergersBuilder.setInfrastructureName(taskName);
+  mergersBuilder.setInfrastructureName(infrastructureName);
   mergersBuilder.setInputSpecs(mergerInputs);
   mergersBuilder.setOutputSpec(
-    { { "main" }, TaskRunner::createTaskDataOrigin(), TaskRunner::createTaskDataDescription(taskName), 0 });
+    { { "main" }, TaskRunner::createTaskDataOrigin(), TaskRunner::createTaskDataDescription(taskName), static_cast<SubSpec>(outputId) });
   MergerConfig mergerConfig;
   // if we are to change the mode to Full, disable reseting tasks after each cycle.
   mergerConfig.inputObjectTimespan = { InputObjectsTimespan::LastDifference, 0 };
   mergerConfig.publicationDecision = {
     PublicationDecision::EachNSeconds, cycleDurationSeconds
   };
-  mergerConfig.mergedObjectTimespan = { MergedObjectTimespan::FullHistory, 0 };
+  mergerConfig.mergedObjectTimespan = { mergedObjectTimespan, 0 };
   // for now one merger should be enough, multiple layers to be supported later
   mergerConfig.topologySize = { TopologySize::NumberOfLayers, 1 };
   mergersBuilder.setConfig(mergerConfig);
@@ -449,6 +449,13 @@ std::vector<std::string> MySqlDatabase::getListOfTasksWithPublications()
   return result;
 }
 
+std::vector<long> MySqlDatabase::getTimestampsForObject(std::string path, long, long)
+{
+  // the tables keep only the last version of each object, so there is no history to look into
+  BOOST_THROW_EXCEPTION(DatabaseException()
+                        << errinfo_details("MySqlDatabase does not support listing the versions of an object (" + path + "), it keeps only the last one"));
+}
+
 void MySqlDatabase::truncate(std::string taskName, std::string objectName)
 {
   string queryString = string("delete ignore from `data_") + taskName + "` where object_name='" + objectName + "'";
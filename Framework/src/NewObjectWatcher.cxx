@@ -0,0 +1,195 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    NewObjectWatcher.cxx
+///
+
+#include "QualityControl/NewObjectWatcher.h"
+#include "QualityControl/CcdbDatabase.h"
+#include "QualityControl/QcInfoLogger.h"
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+
+namespace o2::quality_control::postprocessing
+{
+
+struct NewObjectWatcher::Subscription {
+  Subscription(NewObjectWatcher* watcher, std::string databaseUrl, std::string objectPath, uint64_t generation)
+    : watcher(watcher), databaseUrl(std::move(databaseUrl)), objectPath(std::move(objectPath)), lastGeneration(generation)
+  {
+  }
+  ~Subscription()
+  {
+    watcher->unsubscribe(databaseUrl, objectPath);
+  }
+
+  NewObjectWatcher* watcher;
+  std::string databaseUrl;
+  std::string objectPath;
+  uint64_t lastGeneration;
+};
+
+NewObjectWatcher::NewObjectWatcher(ListingFcn listing, double periodSec)
+  : mListing(std::move(listing)), mPeriodSec(periodSec)
+{
+  if (!mListing) {
+    mListing = [this](const std::string& databaseUrl, const std::string& pathPattern) {
+      return listCcdb(databaseUrl, pathPattern);
+    };
+  }
+  mPollTimer.reset(static_cast<int>(mPeriodSec * 1000000));
+}
+
+NewObjectWatcher::~NewObjectWatcher() = default;
+
+NewObjectWatcher& NewObjectWatcher::getInstance()
+{
+  static NewObjectWatcher watcher;
+  return watcher;
+}
+
+std::string NewObjectWatcher::normalizePath(const std::string& path)
+{
+  // the repository lists paths without the leading slash
+  size_t begin = path.find_first_not_of('/');
+  return begin == std::string::npos ? "" : path.substr(begin);
+}
+
+TriggerFcn NewObjectWatcher::createTrigger(std::string databaseUrl, std::string objectPath)
+{
+  objectPath = normalizePath(objectPath);
+  if (objectPath.empty()) {
+    throw std::invalid_argument("empty object path in the NewObject trigger");
+  }
+
+  uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto& state = mObjects[databaseUrl][objectPath];
+    state.subscribers++;
+    generation = state.generation;
+    if (!state.initialized) {
+      // we want to know the current version as soon as possible, so only newer ones are reported
+      mPollRequested = true;
+    }
+  }
+
+  auto subscription = std::make_shared<Subscription>(this, databaseUrl, objectPath, generation);
+  return [subscription]() mutable -> Trigger {
+    return subscription->watcher->hasNewVersion(*subscription) ? Trigger::NewObject : Trigger::No;
+  };
+}
+
+void NewObjectWatcher::setPollingPeriod(double seconds)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  mPeriodSec = seconds;
+  mPollTimer.reset(static_cast<int>(mPeriodSec * 1000000));
+}
+
+size_t NewObjectWatcher::getNumberOfListings() const
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  return mListingsCount;
+}
+
+bool NewObjectWatcher::hasNewVersion(Subscription& subscription)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  pollIfNeeded();
+
+  const auto& state = mObjects[subscription.databaseUrl][subscription.objectPath];
+  if (state.generation != subscription.lastGeneration) {
+    // if there were many versions since the last check, we trigger only once
+    subscription.lastGeneration = state.generation;
+    return true;
+  }
+  return false;
+}
+
+void NewObjectWatcher::pollIfNeeded()
+{
+  if (mPollRequested || mPollTimer.isTimeout()) {
+    poll();
+    mPollRequested = false;
+    mPollTimer.reset(static_cast<int>(mPeriodSec * 1000000));
+  }
+}
+
+void NewObjectWatcher::poll()
+{
+  for (auto& [url, objects] : mObjects) {
+    if (objects.empty()) {
+      continue;
+    }
+
+    // We make one listing per repository, asking for all objects under the longest common directory of watched paths.
+    const std::string& first = objects.begin()->first;
+    const std::string& last = objects.rbegin()->first;
+    size_t common = 0;
+    while (common < first.size() && common < last.size() && first[common] == last[common]) {
+      common++;
+    }
+    size_t slash = first.rfind('/', common == 0 ? 0 : common - 1);
+    std::string pattern = (slash == std::string::npos ? "" : first.substr(0, slash + 1)) + ".*";
+
+    std::unordered_map<std::string, std::string> latestVersions;
+    try {
+      latestVersions = mListing(url, pattern);
+      mListingsCount++;
+    } catch (const std::exception& ex) {
+      ILOG(Warning) << "Could not list the objects '" << pattern << "' in the repository '" << url << "': " << ex.what() << ENDM;
+      continue;
+    }
+
+    for (auto& [path, state] : objects) {
+      auto latest = latestVersions.find(path);
+      if (!state.initialized) {
+        state.version = latest != latestVersions.end() ? latest->second : "";
+        state.initialized = true;
+      } else if (latest != latestVersions.end() && latest->second != state.version) {
+        ILOG(Debug) << "New version of the object '" << path << "' detected: " << latest->second << ENDM;
+        state.version = latest->second;
+        state.generation++;
+      }
+    }
+  }
+}
+
+void NewObjectWatcher::unsubscribe(const std::string& databaseUrl, const std::string& objectPath)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto objects = mObjects.find(databaseUrl);
+  if (objects == mObjects.end()) {
+    return;
+  }
+  auto state = objects->second.find(objectPath);
+  if (state != objects->second.end() && --state->second.subscribers == 0) {
+    objects->second.erase(state);
+  }
+  if (objects->second.empty()) {
+    mObjects.erase(objects);
+    mDatabases.erase(databaseUrl);
+  }
+}
+
+std::unordered_map<std::string, std::string> NewObjectWatcher::listCcdb(const std::string& databaseUrl, const std::string& pathPattern)
+{
+  auto& database = mDatabases[databaseUrl];
+  if (!database) {
+    database = std::make_unique<CcdbDatabase>();
+    database->connect(databaseUrl, "", "", "");
+  }
+  return database->getLatestVersionIds(pathPattern);
+}
+
+} // namespace o2::quality_control::postprocessing
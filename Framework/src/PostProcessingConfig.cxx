@@ -23,7 +23,9 @@ PostProcessingConfig::PostProcessingConfig(std::string name, configuration::Conf
   : taskName(name),
     moduleName(config.get<std::string>("qc.postprocessing." + name + ".moduleName")),
     className(config.get<std::string>("qc.postprocessing." + name + ".className")),
-    detectorName(config.get<std::string>("qc.postprocessing." + name + ".detectorName", "MISC"))
+    detectorName(config.get<std::string>("qc.postprocessing." + name + ".detectorName", "MISC")),
+    qcdbUrl(config.get<std::string>("qc.config.database.host", "")),
+    periodSeconds(config.get<double>("qc.postprocessing." + name + ".periodSeconds", -1.0))
 {
   for (const auto& initTrigger : config.getRecursive("qc.postprocessing." + name + ".initTrigger")) {
     initTriggers.push_back(initTrigger.second.get_value<std::string>());
@@ -30,4 +30,9 @@ void PostProcessingInterface::configure(std::string name, configuration::Configu
   mName = name;
 }
 
+std::vector<std::string> PostProcessingInterface::getInputPaths() const
+{
+  return {};
+}
+
 } // namespace o2::quality_control::postprocessing
\ No newline at end of file
@@ -14,8 +14,10 @@
 #include "QualityControl/TriggerHelpers.h"
 #include "QualityControl/DatabaseFactory.h"
 #include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/BackfillDatabase.h"
 
 #include <Configuration/ConfigurationFactory.h>
+#include <set>
 
 using namespace o2::configuration;
 using namespace o2::quality_control::core;
@@ -37,9 +39,11 @@ void PostProcessingRunner::init()
   mConfig = PostProcessingConfig(mName, *mConfigFile);
   mConfigFile->setPrefix(""); // protect from having the prefix changed by PostProcessingConfig
 
-  // configuration of the database
-  mDatabase = DatabaseFactory::create(mConfigFile->get<std::string>("qc.config.database.implementation"));
-  mDatabase->connect(mConfigFile->getRecursiveMap("qc.config.database"));
+  // configuration of the database, unless we were given one
+  if (!mDatabase) {
+    mDatabase = DatabaseFactory::create(mConfigFile->get<std::string>("qc.config.database.implementation"));
+    mDatabase->connect(mConfigFile->getRecursiveMap("qc.config.database"));
+  }
   ILOG(Info) << "Database that is going to be used : " << ENDM;
   ILOG(Info) << ">> Implementation : " << mConfigFile->get<std::string>("qc.config.database.implementation") << ENDM;
   ILOG(Info) << ">> Host : " << mConfigFile->get<std::string>("qc.config.database.host") << ENDM;
@@ -92,7 +96,7 @@ bool PostProcessingRunner::run()
 void PostProcessingRunner::start()
 {
   if (mTaskState == TaskState::Created || mTaskState == TaskState::Finished) {
-    mInitTriggers = trigger_helpers::createTriggers(mConfig.initTriggers);
+    mInitTriggers = trigger_helpers::createTriggers(mConfig.initTriggers, mConfig);
     if (trigger_helpers::hasUserOrControlTrigger(mConfig.initTriggers)) {
       doInitialize(Trigger::UserOrControl);
     }
@@ -133,6 +137,51 @@ void PostProcessingRunner::reset()
   mStopTriggers.clear();
 }
 
+void PostProcessingRunner::backfill(long from, long to, size_t prefetchDepth)
+{
+  if (mTaskState != TaskState::Created && mTaskState != TaskState::Finished) {
+    throw std::runtime_error("The user task can be backfilled only after initialization or when it has finished");
+  }
+
+  auto inputPaths = mTask->getInputPaths();
+  if (inputPaths.empty()) {
+    throw std::runtime_error("The user task '" + mConfig.taskName + "' does not declare its input objects, it cannot be backfilled");
+  }
+  std::set<long> timestamps;
+  for (const auto& path : inputPaths) {
+    auto objectTimestamps = mDatabase->getTimestampsForObject(path, from, to);
+    timestamps.insert(objectTimestamps.begin(), objectTimestamps.end());
+  }
+  ILOG(Info) << "Backfilling the user task '" << mConfig.taskName << "' with " << timestamps.size() << " versions of "
+             << inputPaths.size() << " objects stored between " << from << " and " << to << ENDM;
+
+  BackfillDatabase database(mDatabase, { timestamps.begin(), timestamps.end() }, prefetchDepth);
+  framework::ServiceRegistry services;
+  services.registerService<DatabaseInterface>(&database);
+
+  if (!database.next()) {
+    ILOG(Warning) << "No versions of the input objects found in the requested interval, nothing to backfill" << ENDM;
+    return;
+  }
+  mTask->initialize(Trigger::Backfill, services);
+  mTaskState = TaskState::Running;
+  do {
+    mTask->update(Trigger::Backfill, services);
+  } while (database.next());
+  mTask->finalize(Trigger::Backfill, services);
+  mTaskState = TaskState::Finished;
+}
+
+void PostProcessingRunner::setDatabase(std::shared_ptr<DatabaseInterface> database)
+{
+  mDatabase = std::move(database);
+}
+
+const std::string& PostProcessingRunner::getName() const
+{
+  return mName;
+}
+
 void PostProcessingRunner::doInitialize(Trigger trigger)
 {
   ILOG(Info) << "Initializing the user task due to trigger '" << trigger << "'" << ENDM;
@@ -141,8 +190,8 @@ void PostProcessingRunner::doInitialize(Trigger trigger)
   mTaskState = TaskState::Running;
 
   // We create the triggers just after task init (and not any sooner), so the timer triggers work as expected.
-  mUpdateTriggers = trigger_helpers::createTriggers(mConfig.updateTriggers);
-  mStopTriggers = trigger_helpers::createTriggers(mConfig.stopTriggers);
+  mUpdateTriggers = trigger_helpers::createTriggers(mConfig.updateTriggers, mConfig);
+  mStopTriggers = trigger_helpers::createTriggers(mConfig.stopTriggers, mConfig);
 }
 
 void PostProcessingRunner::doUpdate(Trigger trigger)
@@ -0,0 +1,127 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PostProcessingScheduler.cxx
+///
+
+#include "QualityControl/PostProcessingScheduler.h"
+
+#include "QualityControl/PostProcessingConfig.h"
+#include "QualityControl/DatabaseFactory.h"
+#include "QualityControl/QcInfoLogger.h"
+
+#include <Configuration/ConfigurationFactory.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace o2::configuration;
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+
+namespace o2::quality_control::postprocessing
+{
+
+PostProcessingScheduler::PostProcessingScheduler(std::vector<std::string> names, std::string configPath, double periodSeconds) //
+  : mNames(std::move(names)),
+    mConfigPath(std::move(configPath)),
+    mPeriodSeconds(periodSeconds > 0 ? periodSeconds : 1.0)
+{
+}
+
+void PostProcessingScheduler::init()
+{
+  ILOG(Info) << "Initializing PostProcessingScheduler with " << mNames.size() << " tasks" << ENDM;
+
+  auto configFile = ConfigurationFactory::getConfiguration(mConfigPath);
+
+  // one database connection for all the tasks
+  mDatabase = DatabaseFactory::create(configFile->get<std::string>("qc.config.database.implementation"));
+  mDatabase->connect(configFile->getRecursiveMap("qc.config.database"));
+
+  mTasks.clear();
+  for (const auto& name : mNames) {
+    PostProcessingConfig config(name, *configFile);
+    configFile->setPrefix(""); // protect from having the prefix changed by PostProcessingConfig
+
+    Task task;
+    task.runner = std::make_unique<PostProcessingRunner>(name, mConfigPath);
+    task.runner->setDatabase(mDatabase);
+    task.runner->init();
+    double period = config.periodSeconds > 0 ? config.periodSeconds : mPeriodSeconds;
+    task.periodTicks = std::max<uint64_t>(1, std::llround(period / mPeriodSeconds));
+    mTasks.push_back(std::move(task));
+  }
+}
+
+bool PostProcessingScheduler::run()
+{
+  auto ticks = static_cast<uint64_t>(mClock.getTime() / mPeriodSeconds);
+  if (ticks > mWheel.getTicks()) {
+    mWheel.advance(ticks - mWheel.getTicks(), mDue);
+  }
+
+  for (size_t taskIndex : mDue) {
+    auto& task = mTasks[taskIndex];
+    if (task.finished) {
+      continue;
+    }
+    mWheel.schedule(taskIndex, task.periodTicks);
+    task.finished = !task.runner->run();
+  }
+  mDue.clear();
+
+  return std::any_of(mTasks.begin(), mTasks.end(), [](const Task& task) { return !task.finished; });
+}
+
+void PostProcessingScheduler::start()
+{
+  mWheel.clear();
+  mDue.clear();
+  mClock.reset();
+  for (size_t i = 0; i < mTasks.size(); i++) {
+    auto& task = mTasks[i];
+    task.runner->start();
+    task.finished = false;
+
+    // we spread the tasks with the same period evenly, so they do not all wake up at the same tick
+    uint64_t offset = i * task.periodTicks / mTasks.size();
+    if (offset == 0) {
+      mDue.push_back(i);
+    } else {
+      mWheel.schedule(i, offset);
+    }
+  }
+}
+
+void PostProcessingScheduler::stop()
+{
+  for (auto& task : mTasks) {
+    task.runner->stop();
+  }
+}
+
+void PostProcessingScheduler::reset()
+{
+  for (auto& task : mTasks) {
+    task.runner->reset();
+  }
+  mTasks.clear();
+  mWheel.clear();
+  mDue.clear();
+  mDatabase.reset();
+}
+
+double PostProcessingScheduler::getRemainingTimeToTick()
+{
+  return (mWheel.getTicks() + 1) * mPeriodSeconds - mClock.getTime();
+}
+
+} // namespace o2::quality_control::postprocessing
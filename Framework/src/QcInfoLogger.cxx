@@ -15,10 +15,13 @@
 
 #include "QualityControl/QcInfoLogger.h"
 #include <InfoLogger/InfoLoggerFMQ.hxx>
+#include <cctype>
 
 namespace o2::quality_control::core
 {
 
+std::atomic<int> QcInfoLogger::sFilterLevel{ QcInfoLogger::level(QcInfoLogger::Severity::Info) };
+
 QcInfoLogger::QcInfoLogger()
 {
   infoContext context;
@@ -29,4 +32,32 @@ QcInfoLogger::QcInfoLogger()
   *this << "QC infologger initialized" << infologger::endm;
 }
 
+bool QcInfoLogger::setFilterLevel(const std::string& severity)
+{
+  std::string name;
+  for (auto c : severity) {
+    name += std::tolower(static_cast<unsigned char>(c));
+  }
+  if (name == "debug") {
+    setFilterLevel(Severity::Debug);
+  } else if (name == "info") {
+    setFilterLevel(Severity::Info);
+  } else if (name == "warning") {
+    setFilterLevel(Severity::Warning);
+  } else if (name == "error") {
+    setFilterLevel(Severity::Error);
+  } else if (name == "fatal") {
+    setFilterLevel(Severity::Fatal);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+QcInfoLogger::Severity QcInfoLogger::getFilterLevel()
+{
+  static constexpr Severity severities[] = { Severity::Debug, Severity::Info, Severity::Warning, Severity::Error, Severity::Fatal };
+  return severities[sFilterLevel.load(std::memory_order_relaxed)];
+}
+
 } // namespace o2::quality_control::core
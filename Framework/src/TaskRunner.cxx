@@ -31,6 +31,7 @@
 
 #include "QualityControl/QcInfoLogger.h"
 #include "QualityControl/TaskFactory.h"
+#include "QualityControl/Tracing.h"
 
 #include <string>
 #include <memory>
@@ -81,9 +82,20 @@ void TaskRunner::init(InitContext& iCtx)
   mCollector->addGlobalTag(tags::Key::Subsystem, tags::Value::QC);
   mCollector->addGlobalTag("TaskName", mTaskConfig.taskName);
 
+  // setup the level of the filtered logs
+  auto filterLevel = mConfigFile->get<std::string>("qc.config.infologger.filterLevel", "info");
+  if (!QcInfoLogger::setFilterLevel(filterLevel)) {
+    ILOG(Warning) << "Unknown infologger filter level \"" << filterLevel << "\", it is not changed" << ENDM;
+  }
+
   // setup publisher
   mObjectsManager = std::make_shared<ObjectsManager>(mTaskConfig);
 
+  if (!mTaskConfig.traceFile.empty()) {
+    ILOG(Info) << "The task will be traced, the trace is written to " << mTaskConfig.traceFile << " after each cycle" << ENDM;
+    Tracing::enable();
+  }
+
   // setup user's task
   TaskFactory f;
   mTask.reset(f.create(mTaskConfig, mObjectsManager));
@@ -111,6 +123,7 @@ void TaskRunner::run(ProcessingContext& pCtx)
   auto [dataReady, timerReady] = validateInputs(pCtx.inputs());
 
   if (dataReady) {
+    QC_TRACE_SCOPE("monitorData");
     mTask->monitorData(pCtx);
     mNumberMessages++;
   }
@@ -168,6 +181,38 @@ CompletionPolicy::CompletionOp TaskRunner::completionPolicyCallback(o2::framewor
 
 void TaskRunner::setResetAfterPublish(bool resetAfterPublish) { mResetAfterPublish = resetAfterPublish; }
 
+void TaskRunner::setReplica(size_t replica, size_t replicas)
+{
+  if (replica >= replicas) {
+    throw std::invalid_argument("Invalid replica " + std::to_string(replica) + " out of " + std::to_string(replicas) + " for task " + mTaskConfig.taskName);
+  }
+  mDeviceName = createTaskRunnerIdString() + "-" + mTaskConfig.taskName + "-" + std::to_string(replica);
+
+  // the timer is always the last input, the rest are data inputs
+  InputSpec timer = mInputSpecs.back();
+  mInputSpecs.pop_back();
+
+  Inputs shard;
+  for (size_t i = 0; i < mInputSpecs.size(); i++) {
+    if (!DataSpecUtils::getOptionalSubSpec(mInputSpecs[i]).has_value()) {
+      throw std::runtime_error("Configuration error: the input '" + mInputSpecs[i].binding + "' of the task " + mTaskConfig.taskName +
+                               " does not have a concrete subSpec, thus it cannot be sharded by subSpec");
+    }
+    if (i % replicas == replica) {
+      shard.push_back(mInputSpecs[i]);
+    }
+  }
+  if (shard.empty()) {
+    throw std::runtime_error("Configuration error: the task " + mTaskConfig.taskName + " has less data inputs (" +
+                             std::to_string(mInputSpecs.size()) + ") than replicas (" + std::to_string(replicas) + ")");
+  }
+  mInputSpecs = shard;
+
+  // each replica has its own timer
+  mInputSpecs.emplace_back(InputSpec{ timer.binding, createTaskDataOrigin(), createTaskDataDescription("TIMER-" + mTaskConfig.taskName),
+                                      static_cast<DataHeader::SubSpecificationType>(replica), Lifetime::Timer });
+}
+
 std::string TaskRunner::createTaskRunnerIdString()
 {
   return std::string("QC-TASK-RUNNER");
@@ -267,6 +312,7 @@ void TaskRunner::populateConfig(std::string taskName)
   mTaskConfig.maxNumberCycles = taskConfigTree->second.get<int>("maxNumberCycles", -1);
   mTaskConfig.consulUrl = mConfigFile->get<std::string>("qc.config.consul.url", "http://consul-test.cern.ch:8500");
   mTaskConfig.conditionUrl = mConfigFile->get<std::string>("qc.config.conditionDB.url", "http://ccdb-test.cern.ch:8080");
+  mTaskConfig.traceFile = taskConfigTree->second.get<std::string>("traceFile", "");
   try {
     mTaskConfig.customParameters = mConfigFile->getRecursiveMap("qc.tasks." + taskName + ".taskParameters");
   } catch (...) {
@@ -362,9 +408,14 @@ void TaskRunner::startCycle()
 
 void TaskRunner::finishCycle(DataAllocator& outputs)
 {
-  mTask->endOfCycle();
-
-  mNumberObjectsPublishedInCycle += publish(outputs);
+  {
+    QC_TRACE_SCOPE("endOfCycle");
+    mTask->endOfCycle();
+  }
+  {
+    QC_TRACE_SCOPE("publish");
+    mNumberObjectsPublishedInCycle += publish(outputs);
+  }
   mTotalNumberObjectsPublished += mNumberObjectsPublishedInCycle;
 
   publishCycleStats();
@@ -373,6 +424,10 @@ void TaskRunner::finishCycle(DataAllocator& outputs)
   mCycleNumber++;
   mCycleOn = false;
 
+  if (!mTaskConfig.traceFile.empty() && !Tracing::dumpChromeTrace(mTaskConfig.traceFile)) {
+    ILOG(Warning) << "Could not write the trace to " << mTaskConfig.traceFile << ENDM;
+  }
+
   if (mTaskConfig.maxNumberCycles == mCycleNumber) {
     ILOG(Info) << "The maximum number of cycles (" << mTaskConfig.maxNumberCycles << ") has been reached."
                << " The task will not do anything from now on." << ENDM;
@@ -24,12 +24,10 @@ namespace o2::quality_control::core
 
 using namespace o2::framework;
 
-o2::framework::DataProcessorSpec
-  TaskRunnerFactory::create(std::string taskName, std::string configurationSource, size_t id, bool resetAfterPublish)
+namespace
+{
+DataProcessorSpec createSpec(TaskRunner&& qcTask)
 {
-  TaskRunner qcTask{ taskName, configurationSource, id };
-  qcTask.setResetAfterPublish(resetAfterPublish);
-
   DataProcessorSpec newTask{
     qcTask.getDeviceName(),
     qcTask.getInputsSpecs(),
@@ -42,6 +40,26 @@ o2::framework::DataProcessorSpec
 
   return newTask;
 }
+} // namespace
+
+o2::framework::DataProcessorSpec
+  TaskRunnerFactory::create(std::string taskName, std::string configurationSource, size_t id, bool resetAfterPublish)
+{
+  TaskRunner qcTask{ taskName, configurationSource, id };
+  qcTask.setResetAfterPublish(resetAfterPublish);
+
+  return createSpec(std::move(qcTask));
+}
+
+o2::framework::DataProcessorSpec
+  TaskRunnerFactory::createReplica(std::string taskName, std::string configurationSource, size_t id, size_t replica, size_t replicas)
+{
+  TaskRunner qcTask{ taskName, configurationSource, id };
+  qcTask.setResetAfterPublish(true);
+  qcTask.setReplica(replica, replicas);
+
+  return createSpec(std::move(qcTask));
+}
 
 void TaskRunnerFactory::customizeInfrastructure(std::vector<framework::CompletionPolicy>& policies)
 {
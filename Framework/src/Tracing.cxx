@@ -0,0 +1,210 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    Tracing.cxx
+///
+
+#include "QualityControl/Tracing.h"
+
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+
+namespace o2::quality_control::core
+{
+
+std::atomic<bool> Tracing::sEnabled{ false };
+
+namespace
+{
+
+// The ring buffer of one thread. Only its thread writes to it, the others only read it when dumping.
+struct Buffer {
+  Buffer(int thread, size_t size) : thread(thread), records(std::max<size_t>(size, 1)) {}
+
+  int thread;
+  std::vector<Tracing::Record> records;
+  std::atomic<uint64_t> written{ 0 };
+};
+
+struct Registry {
+  std::mutex mutex;
+  std::vector<std::string> eventNames;
+  std::unordered_map<std::string, Tracing::EventId> eventIds;
+  // the buffers are shared with their threads, so that the records of the threads which are gone can be dumped
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  size_t bufferSize = 1 << 16;
+};
+
+Registry& registry()
+{
+  static Registry instance;
+  return instance;
+}
+
+Buffer& threadBuffer()
+{
+  thread_local std::shared_ptr<Buffer> buffer = [] {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    auto created = std::make_shared<Buffer>(static_cast<int>(reg.buffers.size()) + 1, reg.bufferSize);
+    reg.buffers.push_back(created);
+    return created;
+  }();
+  return *buffer;
+}
+
+void writeEscaped(std::ostream& out, const std::string& text)
+{
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      out << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out << escaped;
+    } else {
+      out << c;
+    }
+  }
+}
+
+} // namespace
+
+Tracing::EventId Tracing::registerEvent(const std::string& name)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  auto [it, inserted] = reg.eventIds.emplace(name, static_cast<EventId>(reg.eventNames.size()));
+  if (inserted) {
+    reg.eventNames.push_back(name);
+  }
+  return it->second;
+}
+
+std::string Tracing::getEventName(EventId event)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return event < reg.eventNames.size() ? reg.eventNames[event] : "unknown";
+}
+
+void Tracing::setBufferSize(size_t records)
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  reg.bufferSize = records;
+}
+
+void Tracing::record(EventId event, Phase phase)
+{
+  auto& buffer = threadBuffer();
+  uint64_t written = buffer.written.load(std::memory_order_relaxed);
+  auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+  buffer.records[written % buffer.records.size()] = { timestamp, event, phase };
+  buffer.written.store(written + 1, std::memory_order_release);
+}
+
+std::vector<std::pair<int, std::vector<Tracing::Record>>> Tracing::getRecords()
+{
+  std::vector<std::shared_ptr<Buffer>> buffers;
+  {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    buffers = reg.buffers;
+  }
+
+  std::vector<std::pair<int, std::vector<Record>>> result;
+  for (const auto& buffer : buffers) {
+    uint64_t written = buffer->written.load(std::memory_order_acquire);
+    size_t size = buffer->records.size();
+    uint64_t first = written > size ? written - size : 0;
+    std::vector<Record> records;
+    records.reserve(written - first);
+    for (uint64_t i = first; i < written; i++) {
+      records.push_back(buffer->records[i % size]);
+    }
+    if (!records.empty()) {
+      result.emplace_back(buffer->thread, std::move(records));
+    }
+  }
+  return result;
+}
+
+void Tracing::clear()
+{
+  auto& reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (auto& buffer : reg.buffers) {
+    buffer->written.store(0, std::memory_order_release);
+  }
+}
+
+void Tracing::dumpChromeTrace(std::ostream& out)
+{
+  auto records = getRecords();
+  std::vector<std::string> names;
+  {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    names = reg.eventNames;
+  }
+
+  // the timestamps are written in microseconds since the oldest record
+  int64_t origin = std::numeric_limits<int64_t>::max();
+  for (const auto& [thread, threadRecords] : records) {
+    origin = std::min(origin, threadRecords.front().timestamp);
+  }
+
+  const int pid = getpid();
+  bool first = true;
+  out << "{\"traceEvents\":[";
+  for (const auto& [thread, threadRecords] : records) {
+    // the ends of the sections whose beginning was overwritten in the ring buffer are skipped
+    size_t depth = 0;
+    for (const auto& record : threadRecords) {
+      if (record.phase == Phase::End) {
+        if (depth == 0) {
+          continue;
+        }
+        depth--;
+      } else {
+        depth++;
+      }
+      out << (first ? "\n" : ",\n") << "{\"name\":\"";
+      writeEscaped(out, record.event < names.size() ? names[record.event] : "unknown");
+      char timestamp[32];
+      snprintf(timestamp, sizeof(timestamp), "%.3f", (record.timestamp - origin) / 1000.0);
+      out << "\",\"cat\":\"qc\",\"ph\":\"" << (record.phase == Phase::Begin ? 'B' : 'E')
+          << "\",\"ts\":" << timestamp << ",\"pid\":" << pid << ",\"tid\":" << thread << "}";
+      first = false;
+    }
+  }
+  out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+bool Tracing::dumpChromeTrace(const std::string& fileName)
+{
+  std::ofstream out(fileName);
+  if (!out) {
+    return false;
+  }
+  dumpChromeTrace(out);
+  return static_cast<bool>(out);
+}
+
+} // namespace o2::quality_control::core
@@ -52,12 +52,15 @@ void TrendingTask::initialize(Trigger, framework::ServiceRegistry& services)
 }
 
 //todo: see if OptimizeBaskets() indeed helps after some time
-void TrendingTask::update(Trigger, framework::ServiceRegistry&)
+void TrendingTask::update(Trigger trigger, framework::ServiceRegistry&)
 {
   trendValues();
 
-  storePlots();
-  storeTrend();
+  // when backfilling, we want to go through the history as fast as possible, so we store only in finalize()
+  if (trigger != Trigger::Backfill) {
+    storePlots();
+    storeTrend();
+  }
 }
 
 void TrendingTask::finalize(Trigger, framework::ServiceRegistry&)
@@ -66,6 +69,15 @@ void TrendingTask::finalize(Trigger, framework::ServiceRegistry&)
   storeTrend();
 }
 
+std::vector<std::string> TrendingTask::getInputPaths() const
+{
+  std::vector<std::string> paths;
+  for (const auto& dataSource : mConfig.dataSources) {
+    paths.push_back(dataSource.path + "/" + dataSource.name);
+  }
+  return paths;
+}
+
 void TrendingTask::storeTrend()
 {
   ILOG(Info) << "Storing the trend, entries: " << mTrend->GetEntries() << ENDM;
@@ -77,9 +89,18 @@ void TrendingTask::storeTrend()
 
 void TrendingTask::trendValues()
 {
-  // We use current date and time. This for planned processing (not history). We still might need to use the objects
-  // timestamps in the end, but this would become ambiguous if there is more than one data source.
-  mTime = TDatime().Convert();
+  // We use the timestamp of the most recent object among the data sources, so the trend is correct also when we
+  // process the history. If none of the objects has a timestamp, we fall back to the current date and time.
+  long latestTimestamp = -1;
+  auto updateTimestamp = [&latestTimestamp](const std::map<std::string, std::string>& metadata) {
+    if (auto validFrom = metadata.find("Valid-From"); validFrom != metadata.end()) {
+      try {
+        latestTimestamp = std::max(latestTimestamp, std::stol(validFrom->second));
+      } catch (const std::exception&) {
+        ILOG(Warning) << "Unexpected format of the object timestamp '" << validFrom->second << "'" << ENDM;
+      }
+    }
+  };
   // todo get run number when it is available. consider putting it inside monitor object's metadata (this might be not
   //  enough if we trend across runs).
   mMetaData.runNumber = -1;
@@ -92,17 +113,21 @@ void TrendingTask::trendValues()
       TObject* obj = mo ? mo->getObject() : nullptr;
       if (obj) {
         mReductors[dataSource.name]->update(obj);
+        updateTimestamp(mo->getMetadataMap());
       }
     } else if (dataSource.type == "repository-quality") {
       auto qo = mDatabase->retrieveQO(dataSource.path + "/" + dataSource.name);
       if (qo) {
         mReductors[dataSource.name]->update(qo.get());
+        updateTimestamp(qo->getMetadataMap());
       }
     } else {
       ILOGE << "Unknown type of data source '" << dataSource.type << "'.";
     }
   }
 
+  // the timestamps in the repository are in milliseconds
+  mTime = latestTimestamp >= 0 ? static_cast<UInt_t>(latestTimestamp / 1000) : TDatime().Convert();
   mTrend->Fill();
 }
 
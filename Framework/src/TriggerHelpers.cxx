@@ -48,8 +48,10 @@ std::optional<double> string2Seconds(std::string str)
   }
 }
 
-TriggerFcn triggerFactory(std::string trigger)
+TriggerFcn triggerFactory(std::string trigger, const PostProcessingConfig& config)
 {
+  // the object path is case sensitive, we keep the original one
+  const std::string originalTrigger = trigger;
   // todo: should we accept many versions of trigger names?
   boost::algorithm::to_lower(trigger);
 
@@ -66,9 +68,12 @@ TriggerFcn triggerFactory(std::string trigger)
   } else if (trigger == "eof" || trigger == "endoffill") {
     return triggers::EndOfFill();
   } else if (trigger.find("newobject") != std::string::npos) {
-    // todo: extract object path
-    //  it might be in a form of "newobject:/qc/ASDF/ZXCV"
-    return triggers::NewObject("");
+    // it is expected in a form of "newobject:/qc/ASDF/ZXCV"
+    size_t separator = originalTrigger.find(':');
+    if (separator == std::string::npos || separator + 1 == originalTrigger.size()) {
+      throw std::invalid_argument("no object path in trigger '" + originalTrigger + "', expected 'newobject:<path>'");
+    }
+    return triggers::NewObject(config.qcdbUrl, originalTrigger.substr(separator + 1));
   } else if (auto seconds = string2Seconds(trigger); seconds.has_value()) {
     if (seconds.value() < 0) {
       throw std::invalid_argument("negative number of seconds in trigger '" + trigger + "'");
@@ -91,11 +96,11 @@ Trigger tryTrigger(std::vector<TriggerFcn>& triggerFcns)
   return Trigger::No;
 }
 
-std::vector<TriggerFcn> createTriggers(const std::vector<std::string>& triggerNames)
+std::vector<TriggerFcn> createTriggers(const std::vector<std::string>& triggerNames, const PostProcessingConfig& config)
 {
   std::vector<TriggerFcn> triggerFcns;
   for (const auto& triggerName : triggerNames) {
-    triggerFcns.push_back(triggerFactory(triggerName));
+    triggerFcns.push_back(triggerFactory(triggerName, config));
   }
   return triggerFcns;
 }
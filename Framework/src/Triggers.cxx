@@ -15,6 +15,7 @@
 
 #include "QualityControl/Triggers.h"
 #include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/NewObjectWatcher.h"
 
 #include <Common/Timer.h>
 
@@ -117,9 +118,10 @@ TriggerFcn Periodic(double seconds)
   };
 }
 
-TriggerFcn NewObject(std::string /*name*/)
+TriggerFcn NewObject(std::string databaseUrl, std::string objectPath)
 {
-  return NotImplemented("NewObject");
+  // All NewObject triggers in the process share the watcher, thus also the repository listings.
+  return NewObjectWatcher::getInstance().createTrigger(std::move(databaseUrl), std::move(objectPath));
 }
 
 } // namespace triggers
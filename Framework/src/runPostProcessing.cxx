@@ -14,26 +14,28 @@
 ///
 /// \brief This is a standalone executable to run postprocessing
 
-#include "QualityControl/PostProcessingRunner.h"
+#include "QualityControl/PostProcessingScheduler.h"
 #include "QualityControl/QcInfoLogger.h"
 
-#include <Common/Timer.h>
 #include <boost/program_options.hpp>
+#include <limits>
 
 using namespace o2::quality_control::core;
 using namespace o2::quality_control::postprocessing;
-using namespace AliceO2::Common;
 namespace bpo = boost::program_options;
 
 int main(int argc, const char* argv[])
 {
   try {
     bpo::options_description desc{ "Options" };
-    desc.add_options()                                                                                       //
-      ("help,h", "Help screen")                                                                              //
-      ("config", bpo::value<std::string>(), "Absolute path to a configuration file, preceded with backend.") //
-      ("name", bpo::value<std::string>(), "Name of a post processing task to run")                           //
-      ("period", bpo::value<double>()->default_value(10.0), "Cycle period of checking triggers in seconds");
+    desc.add_options()                                                                                                                      //
+      ("help,h", "Help screen")                                                                                                             //
+      ("config", bpo::value<std::string>(), "Absolute path to a configuration file, preceded with backend.")                                //
+      ("name", bpo::value<std::vector<std::string>>()->multitoken()->composing(), "Name(s) of post processing tasks to run")                //
+      ("period", bpo::value<double>()->default_value(10.0), "Cycle period of checking triggers in seconds")                                 //
+      ("backfill-from", bpo::value<long>(), "Runs the tasks over the objects stored since this time (ms since epoch) instead of triggers")  //
+      ("backfill-to", bpo::value<long>()->default_value(std::numeric_limits<long>::max()), "End of the backfill interval (ms since epoch)") //
+      ("backfill-prefetch", bpo::value<size_t>()->default_value(8), "Number of object versions retrieved in advance when backfilling");
 
     bpo::variables_map vm;
     store(parse_command_line(argc, argv, desc), vm);
@@ -47,20 +49,25 @@ int main(int argc, const char* argv[])
       return 1;
     }
 
-    int periodUs = static_cast<int>(1000000 * vm["period"].as<double>());
-    PostProcessingRunner runner(vm["name"].as<std::string>(), vm["config"].as<std::string>());
+    if (vm.count("backfill-from")) {
+      for (const auto& name : vm["name"].as<std::vector<std::string>>()) {
+        PostProcessingRunner runner(name, vm["config"].as<std::string>());
+        runner.init();
+        runner.backfill(vm["backfill-from"].as<long>(), vm["backfill-to"].as<long>(), vm["backfill-prefetch"].as<size_t>());
+      }
+      return 0;
+    }
+
+    PostProcessingScheduler runner(vm["name"].as<std::vector<std::string>>(), vm["config"].as<std::string>(),
+                                   vm["period"].as<double>());
 
     runner.init();
     runner.start();
 
-    Timer timer;
-    timer.reset(periodUs);
-
     while (runner.run()) {
-      while (timer.getRemainingTime() < 0) {
-        timer.increment();
+      if (double sleepForUs = 1000000.0 * runner.getRemainingTimeToTick(); sleepForUs > 0) {
+        usleep(sleepForUs);
       }
-      usleep(1000000.0 * timer.getRemainingTime());
     }
     runner.stop();
     return 0;
@@ -14,26 +14,24 @@
 ///
 /// \brief This is an OCC executable to run postprocessing
 
-#include "QualityControl/PostProcessingRunner.h"
+#include "QualityControl/PostProcessingScheduler.h"
 #include "QualityControl/QcInfoLogger.h"
 
 #include <OccInstance.h>
 #include <RuntimeControlledObject.h>
 #include <boost/program_options.hpp>
-#include <Common/Timer.h>
 
 using namespace o2::quality_control::core;
 using namespace o2::quality_control::postprocessing;
-using namespace AliceO2::Common;
 namespace bpo = boost::program_options;
 
 class PostProcessingOCCStateMachine : public RuntimeControlledObject
 {
  public:
-  PostProcessingOCCStateMachine(std::string name, std::string configPath, double period = 1.0)
-    : RuntimeControlledObject("Post-processing task runner"), mName(name), mConfigPath(configPath), mPeriod(period)
+  PostProcessingOCCStateMachine(std::vector<std::string> names, std::string configPath, double period = 1.0)
+    : RuntimeControlledObject("Post-processing task runner"), mNames(names), mConfigPath(configPath), mPeriod(period)
   {
-    mRunner = std::make_unique<PostProcessingRunner>(name, configPath);
+    mRunner = std::make_unique<PostProcessingScheduler>(names, configPath, period);
   }
 
   // In all of the methods below we handle exceptions, so we can go into error state - OCC won't do that for us.
@@ -79,7 +77,7 @@ class PostProcessingOCCStateMachine : public RuntimeControlledObject
 
   int executeRecover() final
   {
-    mRunner = std::make_unique<PostProcessingRunner>(mName, mConfigPath);
+    mRunner = std::make_unique<PostProcessingScheduler>(mNames, mConfigPath, mPeriod);
     return mRunner == nullptr;
   }
 
@@ -95,8 +93,6 @@ class PostProcessingOCCStateMachine : public RuntimeControlledObject
       ILOG(Error) << "Unknown exception";
       success = false;
     }
-
-    mRateLimiter.reset(static_cast<int>(mPeriod * 1000000));
     return !success;
   }
 
@@ -126,7 +122,6 @@ class PostProcessingOCCStateMachine : public RuntimeControlledObject
 
   int executeResume() final
   {
-    mRateLimiter.reset(static_cast<int>(mPeriod * 1000000));
     return mRunner == nullptr;
   }
 
@@ -155,10 +150,8 @@ class PostProcessingOCCStateMachine : public RuntimeControlledObject
       success = false;
     }
 
-    while (mRateLimiter.getRemainingTime() < 0) {
-      mRateLimiter.increment();
-    }
-    if (double sleepForUs = 1000000.0 * mRateLimiter.getRemainingTime(); sleepForUs > 0) {
+    // the scheduler checks the tasks once per tick, there is no point in asking it more often
+    if (double sleepForUs = 1000000.0 * mRunner->getRemainingTimeToTick(); sleepForUs > 0) {
       usleep(sleepForUs);
     }
 
@@ -174,21 +167,20 @@ class PostProcessingOCCStateMachine : public RuntimeControlledObject
   }
 
  private:
-  std::unique_ptr<PostProcessingRunner> mRunner = nullptr;
-  std::string mName = "";
+  std::unique_ptr<PostProcessingScheduler> mRunner = nullptr;
+  std::vector<std::string> mNames;
   std::string mConfigPath = "";
   double mPeriod = 1.0;
-  Timer mRateLimiter;
 };
 
 int main(int argc, const char* argv[])
 {
   try {
     bpo::options_description desc{ "Options" };
-    desc.add_options()                                                                                       //
-      ("help,h", "Help screen")                                                                              //
-      ("config", bpo::value<std::string>(), "Absolute path to a configuration file, preceded with backend.") //
-      ("name", bpo::value<std::string>(), "Name of a post processing task to run")                           //
+    desc.add_options()                                                                                                       //
+      ("help,h", "Help screen")                                                                                              //
+      ("config", bpo::value<std::string>(), "Absolute path to a configuration file, preceded with backend.")                 //
+      ("name", bpo::value<std::vector<std::string>>()->multitoken()->composing(), "Name(s) of post processing tasks to run") //
       ("period", bpo::value<double>()->default_value(1.0), "Cycle period of checking triggers in seconds");
 
     bpo::variables_map vm;
@@ -203,7 +195,7 @@ int main(int argc, const char* argv[])
       return 1;
     }
 
-    PostProcessingOCCStateMachine stateMachine(vm["name"].as<std::string>(), vm["config"].as<std::string>(), vm["period"].as<double>());
+    PostProcessingOCCStateMachine stateMachine(vm["name"].as<std::vector<std::string>>(), vm["config"].as<std::string>(), vm["period"].as<double>());
     OccInstance occ(&stateMachine);
     occ.wait();
     return 0;
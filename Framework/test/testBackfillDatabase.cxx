@@ -0,0 +1,99 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testBackfillDatabase.cxx
+///
+
+#include "QualityControl/BackfillDatabase.h"
+
+#define BOOST_TEST_MODULE BackfillDatabase test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <TNamed.h>
+#include <atomic>
+
+using namespace o2::quality_control::core;
+using namespace o2::quality_control::repository;
+using namespace o2::quality_control::postprocessing;
+
+// A database which returns objects titled with the timestamp they were asked for.
+class FakeDatabase : public DatabaseInterface
+{
+ public:
+  void connect(std::string, std::string, std::string, std::string) override {}
+  void connect(const std::unordered_map<std::string, std::string>&) override {}
+  void storeMO(std::shared_ptr<MonitorObject>) override { stored++; }
+  void storeQO(std::shared_ptr<QualityObject>) override { stored++; }
+  std::shared_ptr<MonitorObject> retrieveMO(std::string taskName, std::string objectName, long timestamp) override
+  {
+    retrieved++;
+    return std::make_shared<MonitorObject>(new TNamed(objectName.c_str(), std::to_string(timestamp).c_str()), taskName);
+  }
+  std::shared_ptr<QualityObject> retrieveQO(std::string, long) override { return nullptr; }
+  TObject* retrieveTObject(std::string, const std::map<std::string, std::string>&, long, std::map<std::string, std::string>*) override { return nullptr; }
+  std::string retrieveMOJson(std::string, std::string, long) override { return ""; }
+  std::string retrieveQOJson(std::string, long) override { return ""; }
+  std::string retrieveJson(std::string, long timestamp, const std::map<std::string, std::string>&) override { return std::to_string(timestamp); }
+  void disconnect() override {}
+  void prepareTaskDataContainer(std::string) override {}
+  std::vector<std::string> getPublishedObjectNames(std::string) override { return {}; }
+  std::vector<long> getTimestampsForObject(std::string, long, long) override { return {}; }
+  void truncate(std::string, std::string) override {}
+
+  std::atomic<int> retrieved = 0;
+  std::atomic<int> stored = 0;
+};
+
+BOOST_AUTO_TEST_CASE(test_backfill_timeline)
+{
+  auto fake = std::make_shared<FakeDatabase>();
+  std::vector<long> timeline{ 10, 20, 30, 40, 50, 60, 70 };
+
+  for (size_t prefetchDepth : { 0u, 1u, 3u, 100u }) {
+    fake->retrieved = 0;
+    BackfillDatabase database(fake, timeline, prefetchDepth);
+    DatabaseInterface& db = database;
+    BOOST_CHECK_EQUAL(database.getCurrentTimestamp(), -1);
+
+    for (long timestamp : timeline) {
+      BOOST_REQUIRE(database.next());
+      BOOST_CHECK_EQUAL(database.getCurrentTimestamp(), timestamp);
+
+      auto mo1 = db.retrieveMO("qc/TST/QcTask", "example");
+      auto mo2 = db.retrieveMO("qc/TST/QcTask", "other");
+      BOOST_REQUIRE(mo1 != nullptr);
+      BOOST_REQUIRE(mo2 != nullptr);
+      BOOST_CHECK_EQUAL(mo1->getObject()->GetName(), "example");
+      BOOST_CHECK_EQUAL(mo1->getObject()->GetTitle(), std::to_string(timestamp));
+      BOOST_CHECK_EQUAL(mo2->getObject()->GetName(), "other");
+      BOOST_CHECK_EQUAL(mo2->getObject()->GetTitle(), std::to_string(timestamp));
+
+      // explicit timestamps are respected
+      auto mo3 = db.retrieveMO("qc/TST/QcTask", "example", 5);
+      BOOST_CHECK_EQUAL(mo3->getObject()->GetTitle(), "5");
+      BOOST_CHECK_EQUAL(db.retrieveJson("qc/TST/QcTask/example", -1, {}), std::to_string(timestamp));
+    }
+    BOOST_CHECK(!database.next());
+    // each object is retrieved once per timestamp, plus the ones with explicit timestamps
+    BOOST_CHECK_EQUAL(fake->retrieved.load(), static_cast<int>(3 * timeline.size()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_backfill_store)
+{
+  auto fake = std::make_shared<FakeDatabase>();
+  BackfillDatabase database(fake, { 1, 2 });
+  BOOST_REQUIRE(database.next());
+  database.storeMO(std::make_shared<MonitorObject>());
+  BOOST_CHECK_EQUAL(fake->stored.load(), 1);
+}
@@ -74,6 +74,75 @@ BOOST_AUTO_TEST_CASE(qc_factory_local_test)
   }
 }
 
+BOOST_AUTO_TEST_CASE(qc_factory_local_parallel_test)
+{
+  std::string configFilePath = std::string("json://") + getTestDataDirectory() + "testParallelTasks.json";
+  auto workflow = InfrastructureGenerator::generateLocalInfrastructure(configFilePath, "o2flp1");
+
+  // roundRobinTask time-pipelined in 3 replicas, a merger and a proxy + 2 replicas of subSpecTask, a merger and a proxy
+  BOOST_REQUIRE_EQUAL(workflow.size(), 7);
+
+  // DPL sends each timeslice to one of the round-robin replicas
+  auto roundRobinTaskRunner = std::find_if(
+    workflow.begin(), workflow.end(),
+    [](const DataProcessorSpec& d) {
+      return d.name == "QC-TASK-RUNNER-roundRobinTask" &&
+             d.maxInputTimeslices == 3 &&
+             d.inputs.size() == 2 &&
+             d.outputs.size() == 1 && DataSpecUtils::getOptionalSubSpec(d.outputs[0]).value_or(-1) == 2;
+    });
+  BOOST_CHECK(roundRobinTaskRunner != workflow.end());
+
+  auto roundRobinMerger = std::find_if(
+    workflow.begin(), workflow.end(),
+    [](const DataProcessorSpec& d) {
+      return d.name.find("MERGER") != std::string::npos && d.name.find("roundRobinTask") != std::string::npos &&
+             d.inputs.size() == 2 &&
+             d.outputs.size() == 1 && DataSpecUtils::getOptionalSubSpec(d.outputs[0]).value_or(-1) == 0;
+    });
+  BOOST_CHECK(roundRobinMerger != workflow.end());
+
+  auto roundRobinProxy = std::find_if(
+    workflow.begin(), workflow.end(),
+    [](const DataProcessorSpec& d) {
+      return d.name == "roundRobinTask-proxy-0" &&
+             d.inputs.size() == 1 && DataSpecUtils::getOptionalSubSpec(d.inputs[0]).value_or(-1) == 0;
+    });
+  BOOST_CHECK(roundRobinProxy != workflow.end());
+
+  // subSpec replicas share the four data inputs
+  for (size_t replica = 0; replica < 2; replica++) {
+    auto taskRunner = std::find_if(
+      workflow.begin(), workflow.end(),
+      [replica](const DataProcessorSpec& d) {
+        return d.name == "QC-TASK-RUNNER-subSpecTask-" + std::to_string(replica) &&
+               d.inputs.size() == 3 &&
+               DataSpecUtils::getOptionalSubSpec(d.inputs[0]).value_or(-1) == replica &&
+               DataSpecUtils::getOptionalSubSpec(d.inputs[1]).value_or(-1) == replica + 2 &&
+               d.outputs.size() == 1 && DataSpecUtils::getOptionalSubSpec(d.outputs[0]).value_or(-1) == 3 + replica;
+      });
+    BOOST_CHECK(taskRunner != workflow.end());
+  }
+
+  // the merged output goes to the remote side as if it was produced by one TaskRunner on the first machine
+  auto subSpecMerger = std::find_if(
+    workflow.begin(), workflow.end(),
+    [](const DataProcessorSpec& d) {
+      return d.name.find("MERGER") != std::string::npos && d.name.find("subSpecTask") != std::string::npos &&
+             d.inputs.size() == 3 &&
+             d.outputs.size() == 1 && DataSpecUtils::getOptionalSubSpec(d.outputs[0]).value_or(-1) == 1;
+    });
+  BOOST_CHECK(subSpecMerger != workflow.end());
+
+  auto subSpecProxy = std::find_if(
+    workflow.begin(), workflow.end(),
+    [](const DataProcessorSpec& d) {
+      return d.name == "subSpecTask-proxy-1" &&
+             d.inputs.size() == 1 && DataSpecUtils::getOptionalSubSpec(d.inputs[0]).value_or(-1) == 1;
+    });
+  BOOST_CHECK(subSpecProxy != workflow.end());
+}
+
 BOOST_AUTO_TEST_CASE(qc_factory_remote_test)
 {
   std::string configFilePath = std::string("json://") + getTestDataDirectory() + "testSharedConfig.json";
@@ -0,0 +1,99 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testNewObjectWatcher.cxx
+///
+
+#include "QualityControl/NewObjectWatcher.h"
+
+#define BOOST_TEST_MODULE NewObjectWatcher test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+using namespace o2::quality_control::postprocessing;
+
+struct FakeRepository {
+  std::unordered_map<std::string, std::string> versions;
+  std::vector<std::string> requestedPatterns;
+
+  NewObjectWatcher::ListingFcn listing()
+  {
+    return [this](const std::string&, const std::string& pattern) {
+      requestedPatterns.push_back(pattern);
+      return versions;
+    };
+  }
+};
+
+BOOST_AUTO_TEST_CASE(test_new_versions)
+{
+  FakeRepository repository;
+  repository.versions["qc/TST/QcTask/example"] = "v1";
+  NewObjectWatcher watcher(repository.listing(), 0.0);
+
+  auto trigger = watcher.createTrigger("ccdb", "/qc/TST/QcTask/example");
+  // the first poll only establishes which version is the latest
+  BOOST_CHECK_EQUAL(trigger(), Trigger::No);
+  BOOST_CHECK_EQUAL(trigger(), Trigger::No);
+
+  repository.versions["qc/TST/QcTask/example"] = "v2";
+  BOOST_CHECK_EQUAL(trigger(), Trigger::NewObject);
+  BOOST_CHECK_EQUAL(trigger(), Trigger::No);
+
+  // an object which did not exist when the trigger was created
+  auto triggerMissing = watcher.createTrigger("ccdb", "qc/TST/QcTask/missing");
+  BOOST_CHECK_EQUAL(triggerMissing(), Trigger::No);
+  repository.versions["qc/TST/QcTask/missing"] = "v1";
+  BOOST_CHECK_EQUAL(triggerMissing(), Trigger::NewObject);
+  BOOST_CHECK_EQUAL(triggerMissing(), Trigger::No);
+  BOOST_CHECK_EQUAL(trigger(), Trigger::No);
+
+  BOOST_CHECK_THROW(watcher.createTrigger("ccdb", "/"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_shared_listing)
+{
+  FakeRepository repository;
+  repository.versions["qc/TST/QcTask/example"] = "v1";
+  repository.versions["qc/TST/QcTask/other"] = "v1";
+  NewObjectWatcher watcher(repository.listing(), 1000.0);
+
+  std::vector<TriggerFcn> triggers;
+  for (int i = 0; i < 50; i++) {
+    triggers.push_back(watcher.createTrigger("ccdb", i % 2 ? "qc/TST/QcTask/example" : "qc/TST/QcTask/other"));
+  }
+  for (auto& trigger : triggers) {
+    BOOST_CHECK_EQUAL(trigger(), Trigger::No);
+  }
+  BOOST_CHECK_EQUAL(watcher.getNumberOfListings(), 1);
+  BOOST_REQUIRE_EQUAL(repository.requestedPatterns.size(), 1);
+  BOOST_CHECK_EQUAL(repository.requestedPatterns[0], "qc/TST/QcTask/.*");
+
+  // the period did not pass, so a new version is not seen yet
+  repository.versions["qc/TST/QcTask/example"] = "v2";
+  for (auto& trigger : triggers) {
+    BOOST_CHECK_EQUAL(trigger(), Trigger::No);
+  }
+  BOOST_CHECK_EQUAL(watcher.getNumberOfListings(), 1);
+
+  // once the period passed, one listing serves all the triggers
+  watcher.setPollingPeriod(0);
+  BOOST_CHECK_EQUAL(triggers[1](), Trigger::NewObject);
+  watcher.setPollingPeriod(1000.0);
+  for (size_t i = 2; i < triggers.size(); i++) {
+    BOOST_CHECK_EQUAL(triggers[i](), i % 2 ? Trigger::NewObject : Trigger::No);
+  }
+  BOOST_CHECK_EQUAL(triggers[0](), Trigger::No);
+  BOOST_CHECK_EQUAL(triggers[1](), Trigger::No);
+  BOOST_CHECK_EQUAL(watcher.getNumberOfListings(), 2);
+}
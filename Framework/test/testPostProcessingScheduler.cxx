@@ -0,0 +1,90 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testPostProcessingScheduler.cxx
+///
+
+#include "getTestDataDirectory.h"
+#include "QualityControl/PostProcessingScheduler.h"
+#include "QualityControl/TimerWheel.h"
+
+#define BOOST_TEST_MODULE PostProcessingScheduler test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+using namespace o2::quality_control::postprocessing;
+
+BOOST_AUTO_TEST_CASE(test_timer_wheel)
+{
+  TimerWheel wheel(4);
+  std::vector<size_t> due;
+
+  wheel.schedule(0, 1);
+  wheel.schedule(1, 3);
+  wheel.schedule(2, 10); // more than one rotation
+  BOOST_CHECK_EQUAL(wheel.size(), 3);
+
+  wheel.advance(1, due);
+  BOOST_REQUIRE_EQUAL(due.size(), 1);
+  BOOST_CHECK_EQUAL(due[0], 0);
+  due.clear();
+
+  wheel.advance(1, due);
+  BOOST_CHECK(due.empty());
+  wheel.advance(1, due);
+  BOOST_REQUIRE_EQUAL(due.size(), 1);
+  BOOST_CHECK_EQUAL(due[0], 1);
+  due.clear();
+
+  wheel.advance(6, due);
+  BOOST_CHECK(due.empty());
+  wheel.advance(1, due);
+  BOOST_REQUIRE_EQUAL(due.size(), 1);
+  BOOST_CHECK_EQUAL(due[0], 2);
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+  BOOST_CHECK_EQUAL(wheel.getTicks(), 10);
+
+  // zero ticks means the next one
+  wheel.schedule(3, 0);
+  due.clear();
+  wheel.advance(1, due);
+  BOOST_REQUIRE_EQUAL(due.size(), 1);
+  BOOST_CHECK_EQUAL(due[0], 3);
+
+  wheel.schedule(4, 2);
+  wheel.clear();
+  BOOST_CHECK_EQUAL(wheel.size(), 0);
+  BOOST_CHECK_EQUAL(wheel.getTicks(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_scheduler)
+{
+  std::string configFilePath = std::string("json://") + getTestDataDirectory() + "testSharedConfig.json";
+
+  PostProcessingScheduler scheduler({ "SkeletonPostProcessing" }, configFilePath, 0.01);
+
+  // todo: this initializes database. should we have an option not to do it, so we don't fail test randomly?
+  BOOST_CHECK_NO_THROW(scheduler.init());
+  BOOST_CHECK_NO_THROW(scheduler.start());
+
+  // the task is configured to initialize, update and finalize "once", so it should finish quickly
+  bool running = true;
+  for (int i = 0; i < 1000 && running; i++) {
+    BOOST_CHECK_NO_THROW(running = scheduler.run());
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK(!running);
+  BOOST_CHECK_NO_THROW(scheduler.stop());
+  BOOST_CHECK_NO_THROW(scheduler.reset());
+}
@@ -20,6 +20,7 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 #include <FairLogger.h>
+#include <thread>
 
 using namespace std;
 using namespace AliceO2::InfoLogger;
@@ -64,4 +65,62 @@ BOOST_AUTO_TEST_CASE(qc_info_logger_2)
   LOG(INFO) << "fair message in infologger";
 }
 
+int countEvaluation(int& evaluations)
+{
+  return ++evaluations;
+}
+
+BOOST_AUTO_TEST_CASE(qc_info_logger_filtered)
+{
+  int evaluations = 0;
+  BOOST_CHECK(QcInfoLogger::setFilterLevel("info"));
+  BOOST_CHECK_EQUAL(QcInfoLogger::getFilterLevel(), InfoLogger::Info);
+  ILOG_FILTERED(Debug) << "debug message " << countEvaluation(evaluations) << ENDM;
+  BOOST_CHECK_EQUAL(evaluations, 0);
+  ILOG_FILTERED(Warning) << "warning message " << countEvaluation(evaluations) << ENDM;
+  BOOST_CHECK_EQUAL(evaluations, 1);
+
+  BOOST_CHECK(QcInfoLogger::setFilterLevel("Debug"));
+  ILOG_FILTERED(Debug) << "debug message " << countEvaluation(evaluations) << ENDM;
+  BOOST_CHECK_EQUAL(evaluations, 2);
+
+  BOOST_CHECK(!QcInfoLogger::setFilterLevel("verbose"));
+  BOOST_CHECK_EQUAL(QcInfoLogger::getFilterLevel(), InfoLogger::Debug);
+  QcInfoLogger::setFilterLevel(InfoLogger::Info);
+}
+
+BOOST_AUTO_TEST_CASE(qc_info_logger_rate_limited)
+{
+  int evaluations = 0;
+  for (int i = 0; i < 100; i++) {
+    ILOG_RATE_LIMITED(Error, 60) << "error message " << countEvaluation(evaluations) << ENDM;
+  }
+  BOOST_CHECK_EQUAL(evaluations, 1);
+
+  for (int i = 0; i < 3; i++) {
+    ILOG_RATE_LIMITED(Info, 0.001) << "info message " << countEvaluation(evaluations) << ENDM;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  }
+  BOOST_CHECK_EQUAL(evaluations, 4);
+
+  ILOG_RATE_LIMITED(Debug, 0) << "debug message " << countEvaluation(evaluations) << ENDM;
+  BOOST_CHECK_EQUAL(evaluations, 4);
+}
+
+BOOST_AUTO_TEST_CASE(qc_info_logger_thread_mute)
+{
+  int evaluations = 0;
+  std::thread thread([&evaluations]() {
+    QcInfoLogger::ThreadMute mute;
+    ILOG(Error) << "error message " << countEvaluation(evaluations) << ENDM;
+    ILOGW << "warning message " << countEvaluation(evaluations) << ENDM;
+  });
+  thread.join();
+  BOOST_CHECK_EQUAL(evaluations, 0);
+
+  BOOST_CHECK(!QcInfoLogger::isThreadMuted());
+  ILOG(Info) << "info message " << countEvaluation(evaluations) << ENDM;
+  BOOST_CHECK_EQUAL(evaluations, 1);
+}
+
 } // namespace o2::quality_control::core
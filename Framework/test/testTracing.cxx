@@ -0,0 +1,115 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file    testTracing.cxx
+///
+
+#include "QualityControl/Tracing.h"
+
+#define BOOST_TEST_MODULE Tracing test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <thread>
+
+using namespace o2::quality_control::core;
+
+void tracedFunction()
+{
+  QC_TRACE_SCOPE("outer");
+  {
+    QC_TRACE_SCOPE("inner");
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_tracing_events)
+{
+  auto id = Tracing::registerEvent("event");
+  BOOST_CHECK_EQUAL(Tracing::registerEvent("event"), id);
+  BOOST_CHECK_NE(Tracing::registerEvent("other"), id);
+  BOOST_CHECK_EQUAL(Tracing::getEventName(id), "event");
+}
+
+BOOST_AUTO_TEST_CASE(test_tracing_scopes)
+{
+  Tracing::clear();
+  Tracing::enable(false);
+  tracedFunction();
+  BOOST_CHECK(Tracing::getRecords().empty());
+
+  Tracing::enable();
+  tracedFunction();
+  std::thread thread(tracedFunction);
+  thread.join();
+  Tracing::enable(false);
+
+  auto records = Tracing::getRecords();
+  BOOST_REQUIRE_EQUAL(records.size(), 2);
+  BOOST_CHECK_NE(records[0].first, records[1].first);
+  for (const auto& [threadId, threadRecords] : records) {
+    BOOST_REQUIRE_EQUAL(threadRecords.size(), 4);
+    BOOST_CHECK_EQUAL(Tracing::getEventName(threadRecords[0].event), "outer");
+    BOOST_CHECK_EQUAL(Tracing::getEventName(threadRecords[1].event), "inner");
+    BOOST_CHECK(threadRecords[0].phase == Tracing::Phase::Begin);
+    BOOST_CHECK(threadRecords[1].phase == Tracing::Phase::Begin);
+    BOOST_CHECK(threadRecords[2].phase == Tracing::Phase::End);
+    BOOST_CHECK(threadRecords[3].phase == Tracing::Phase::End);
+    BOOST_CHECK_EQUAL(threadRecords[3].event, threadRecords[0].event);
+    for (size_t i = 1; i < threadRecords.size(); i++) {
+      BOOST_CHECK_LE(threadRecords[i - 1].timestamp, threadRecords[i].timestamp);
+    }
+  }
+
+  std::stringstream trace;
+  Tracing::dumpChromeTrace(trace);
+  BOOST_CHECK(trace.str().find("{\"traceEvents\":[") == 0);
+  BOOST_CHECK(trace.str().find("\"name\":\"outer\",\"cat\":\"qc\",\"ph\":\"B\"") != std::string::npos);
+  BOOST_CHECK(trace.str().find("\"name\":\"inner\",\"cat\":\"qc\",\"ph\":\"E\"") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_tracing_ring_buffer)
+{
+  // a new thread gets a buffer of the new size
+  Tracing::setBufferSize(5);
+  Tracing::enable();
+  std::thread thread([] {
+    for (int i = 0; i < 10; i++) {
+      tracedFunction();
+    }
+  });
+  thread.join();
+  Tracing::enable(false);
+
+  auto records = Tracing::getRecords();
+  BOOST_REQUIRE(!records.empty());
+  auto& threadRecords = records.back().second;
+  BOOST_REQUIRE_EQUAL(threadRecords.size(), 5);
+  // only the last records are kept, the oldest of them is the end of the outer scope of the previous call
+  BOOST_CHECK_EQUAL(Tracing::getEventName(threadRecords[0].event), "outer");
+  BOOST_CHECK(threadRecords[0].phase == Tracing::Phase::End);
+  BOOST_CHECK(threadRecords[4].phase == Tracing::Phase::End);
+
+  // the ends without a beginning are not dumped
+  std::stringstream trace;
+  Tracing::dumpChromeTrace(trace);
+  auto tid = ",\"tid\":" + std::to_string(records.back().first) + "}";
+  size_t count = 0;
+  for (size_t pos = trace.str().find(tid); pos != std::string::npos; pos = trace.str().find(tid, pos + 1)) {
+    count++;
+  }
+  BOOST_CHECK_EQUAL(count, 4);
+
+  Tracing::clear();
+  BOOST_CHECK(Tracing::getRecords().empty());
+  Tracing::setBufferSize(1 << 16);
+}
@@ -62,6 +62,12 @@ BOOST_AUTO_TEST_CASE(test_factory)
   BOOST_CHECK_THROW(trigger_helpers::triggerFactory("sec"), std::invalid_argument);
   BOOST_CHECK_THROW(trigger_helpers::triggerFactory("asec"), std::invalid_argument);
 
+  // new object triggers need a path
+  BOOST_CHECK_NO_THROW(trigger_helpers::triggerFactory("newobject:qc/TST/QcTask/example"));
+  BOOST_CHECK_NO_THROW(trigger_helpers::triggerFactory("NewObject:/qc/TST/QcTask/Example"));
+  BOOST_CHECK_THROW(trigger_helpers::triggerFactory("newobject"), std::invalid_argument);
+  BOOST_CHECK_THROW(trigger_helpers::triggerFactory("newobject:"), std::invalid_argument);
+
   // fixme: this is treated as "123 seconds", do we want to be so defensive?
   BOOST_CHECK_NO_THROW(trigger_helpers::triggerFactory("123 secure code"));
 }
@@ -0,0 +1,145 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CellAccumulators.h
+///
+
+#ifndef QC_MODULE_EMCAL_CELLACCUMULATORS_H
+#define QC_MODULE_EMCAL_CELLACCUMULATORS_H
+
+#include <array>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+class TH1;
+class TProfile2D;
+
+namespace o2::quality_control_modules::emcal
+{
+
+/// \brief Per cell accumulators of the ADC values of the EMCAL supermodules
+///
+/// The channels are accumulated with simple arithmetic in flat arrays, instead of filling the histograms for
+/// each bunch. The histograms are filled once per cycle by fillHistograms, which gives the same contents as
+/// filling them bunch by bunch: the mean and RMS profiles are averaged over the bunches of a cell, the max and
+/// min profiles over its channels.
+class CellAccumulators
+{
+ public:
+  static constexpr int NSUPERMODULES = 20; ///< Number of supermodules
+  static constexpr int NCOLS = 48;         ///< Number of columns of a supermodule
+  static constexpr int NROWS = 24;         ///< Number of rows of a supermodule
+  static constexpr int NCELLS = NCOLS * NROWS;
+  static constexpr int NADC = 1024; ///< Number of ADC values, the ALTRO samples are 10-bit words
+
+  /// \brief Minimum and maximum ADC of a channel
+  struct ChannelExtrema {
+    short max;
+    short min;
+  };
+
+  /// \brief Histograms of the supermodules filled from the accumulators
+  struct Histograms {
+    std::array<TProfile2D*, NSUPERMODULES> mean; ///< ADC mean per cell, averaged over the bunches
+    std::array<TProfile2D*, NSUPERMODULES> rms;  ///< ADC RMS per cell, averaged over the bunches
+    std::array<TProfile2D*, NSUPERMODULES> max;  ///< ADC max per cell, averaged over the channels
+    std::array<TProfile2D*, NSUPERMODULES> min;  ///< ADC min per cell, averaged over the channels
+    std::array<TH1*, NSUPERMODULES> maxBunch;    ///< Max ADC of each bunch
+    std::array<TH1*, NSUPERMODULES> minBunch;    ///< Min ADC of each bunch
+  };
+
+  CellAccumulators();
+
+  /// \brief Accumulates the bunches of a channel. Bunches is a range of objects with getADC(), as o2::emcal::Bunch.
+  /// \return The minimum and maximum ADC of the channel, which are 0 and SHRT_MAX for a channel without bunches
+  template <typename Bunches>
+  ChannelExtrema addChannel(int supermodule, int col, int row, const Bunches& bunches);
+
+  /// \brief Adds the accumulated values to the histograms and resets the accumulators
+  void fillHistograms(const Histograms& histograms);
+  /// \brief Resets the accumulators
+  void reset();
+
+ private:
+  /// \brief Sums of the values filled in the profiles for one cell
+  struct CellSums {
+    uint32_t nBunches;
+    uint32_t nChannels;
+    double mean;
+    double mean2;
+    double rms;
+    double rms2;
+    double max;
+    double max2;
+    double min;
+    double min2;
+  };
+
+  std::vector<CellSums> mCells;           ///< Sums per cell, indexed by supermodule * NCELLS + row * NCOLS + col
+  std::vector<uint32_t> mMaxBunchCounts;  ///< Number of bunches per max ADC, indexed by supermodule * NADC + ADC
+  std::vector<uint32_t> mMinBunchCounts;  ///< Number of bunches per min ADC, indexed by supermodule * NADC + ADC
+  std::array<bool, NSUPERMODULES> mFilled; ///< Supermodules which got channels since the last reset
+};
+
+template <typename Bunches>
+CellAccumulators::ChannelExtrema CellAccumulators::addChannel(int supermodule, int col, int row, const Bunches& bunches)
+{
+  auto& cell = mCells[supermodule * NCELLS + row * NCOLS + col];
+  auto maxBunchCounts = mMaxBunchCounts.data() + supermodule * NADC;
+  auto minBunchCounts = mMinBunchCounts.data() + supermodule * NADC;
+  mFilled[supermodule] = true;
+
+  ChannelExtrema channel{ 0, SHRT_MAX };
+  for (auto& bunch : bunches) {
+    const auto& adcs = bunch.getADC();
+    if (adcs.empty()) {
+      continue;
+    }
+    int maxADC = adcs[0];
+    int minADC = adcs[0];
+    double sum = 0;
+    for (auto adc : adcs) {
+      maxADC = adc > maxADC ? adc : maxADC;
+      minADC = adc < minADC ? adc : minADC;
+      sum += adc;
+    }
+    const double n = adcs.size();
+    const double mean = sum / n;
+    // standard deviation with the two pass algorithm, as TMath::RMS
+    double sum2 = 0;
+    for (auto adc : adcs) {
+      sum2 += (adc - mean) * (adc - mean);
+    }
+    const double rms = adcs.size() > 1 ? std::sqrt(sum2 / (n - 1)) : 0.;
+
+    maxBunchCounts[maxADC]++;
+    minBunchCounts[minADC]++;
+    channel.max = maxADC > channel.max ? maxADC : channel.max;
+    channel.min = minADC < channel.min ? minADC : channel.min;
+    cell.nBunches++;
+    cell.mean += mean;
+    cell.mean2 += mean * mean;
+    cell.rms += rms;
+    cell.rms2 += rms * rms;
+  }
+  cell.nChannels++;
+  cell.max += channel.max;
+  cell.max2 += double(channel.max) * channel.max;
+  cell.min += channel.min;
+  cell.min2 += double(channel.min) * channel.min;
+  return channel;
+}
+
+} // namespace o2::quality_control_modules::emcal
+
+#endif // QC_MODULE_EMCAL_CELLACCUMULATORS_H
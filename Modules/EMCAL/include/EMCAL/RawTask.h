@@ -19,8 +19,13 @@
 
 #include "QualityControl/TaskInterface.h"
 #include "EMCALBase/Mapper.h"
+#include "EMCAL/CellAccumulators.h"
+#include <gsl/span>
 #include <memory>
 #include <array>
+#include <climits>
+#include <cstdint>
+#include <vector>
 
 class TH1F;
 class TH2F;
@@ -53,6 +58,37 @@ class RawTask final : public TaskInterface
   void reset() override;
 
  private:
+  /// \brief Result of the decoding of one page, processed in the order of the pages in the superpage
+  struct PageResult {
+    int feeId = 0;
+    uint64_t triggerBC = 0;
+    uint32_t payloadSize = 0;
+    bool decoded = true;     ///< False if the ALTRO decoder failed
+    int error = -1;          ///< Type of the ALTRO decoder error
+    short maxADC = 0;        ///< Max ADC of the channels of the page
+    short minADC = SHRT_MAX; ///< Min ADC of the channels of the page
+  };
+  /// \brief Max and min ADC per SM of the current trigger in a superpage
+  struct TriggerState {
+    TriggerState()
+    {
+      maxADCSM.fill(0);
+      minADCSM.fill(SHRT_MAX);
+    }
+    bool first = true; ///< for the first event
+    uint64_t currentTrigger = 0;
+    std::array<short, 20> maxADCSM;
+    std::array<short, 20> minADCSM;
+  };
+
+  /// \brief Decodes the current page of the raw reader, accumulating its channels
+  template <typename RawReader>
+  PageResult readPage(RawReader& rawreader, CellAccumulators& accumulators) const;
+  /// \brief Fills the histograms of a decoded page and handles the trigger boundaries
+  void processPage(const PageResult& page, TriggerState& trigger);
+  /// \brief Decodes the DDLs of the superpages concurrently, then processes their pages in order
+  void decodeInParallel(const std::vector<gsl::span<const char>>& superpages);
+
   TH1F* mHistogram = nullptr;
   TH1* mMessageCounter = nullptr;
   TH1* mNumberOfSuperpagesPerMessage;
@@ -68,6 +104,8 @@ class RawTask final : public TaskInterface
   std::array<TProfile2D*, 20> mMEANperSM;               ///< ADC mean per SM
   std::array<TProfile2D*, 20> mMAXperSM;                ///< ADC max per SM
   std::array<TProfile2D*, 20> mMINperSM;                ///< ADC min per SM
+  std::vector<CellAccumulators> mCellAccumulators;      ///< ADC values per cell, one per decoding thread, filled in the histograms per SM at the end of the cycle
+  Int_t mDecodingThreads = 1;                           ///< Number of threads decoding the DDLs, 1 to decode the pages serially
   TH2F* mErrorTypeAltro = nullptr;                      ///< Error from AltroDecoder
   TH2F* mPayloadSizePerDDL = nullptr;                   ///< Payload size per ddl
   Int_t mNumberOfSuperpages = 0;                        ///< Simple total superpage counter
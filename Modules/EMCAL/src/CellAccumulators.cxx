@@ -0,0 +1,122 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CellAccumulators.cxx
+///
+
+#include <TH1.h>
+#include <TProfile2D.h>
+#include <algorithm>
+
+#include "EMCAL/CellAccumulators.h"
+
+namespace o2::quality_control_modules::emcal
+{
+
+namespace
+{
+
+// Adds the values of a cell to a profile, as if they were filled one by one
+void addToProfile(TProfile2D* profile, int col, int row, uint32_t n, double sum, double sum2)
+{
+  // the profile stores the sum of the values in its bin array, GetBinContent returns it divided by the entries
+  auto bin = profile->FindBin(col, row);
+  profile->GetArray()[bin] += sum;
+  profile->SetBinEntries(bin, profile->GetBinEntries(bin) + n);
+  if (profile->GetSumw2N() > 0) {
+    (*profile->GetSumw2())[bin] += sum2;
+  }
+  if (profile->GetBinSumw2()->GetSize() > 0) {
+    (*profile->GetBinSumw2())[bin] += n;
+  }
+}
+
+// Adds the number of entries per ADC value to a histogram, as if they were filled one by one
+void addToHistogram(TH1* histogram, const uint32_t* counts)
+{
+  Double_t stats[TH1::kNstat] = { 0 };
+  histogram->GetStats(stats);
+  auto entries = histogram->GetEntries();
+  for (int adc = 0; adc < CellAccumulators::NADC; adc++) {
+    if (counts[adc] == 0) {
+      continue;
+    }
+    auto bin = histogram->FindBin(adc);
+    histogram->AddBinContent(bin, counts[adc]);
+    if (histogram->GetSumw2N() > 0) {
+      (*histogram->GetSumw2())[bin] += counts[adc];
+    }
+    if (bin > 0 && bin <= histogram->GetNbinsX()) {
+      stats[0] += counts[adc];
+      stats[1] += counts[adc];
+      stats[2] += double(counts[adc]) * adc;
+      stats[3] += double(counts[adc]) * adc * adc;
+    }
+    entries += counts[adc];
+  }
+  histogram->PutStats(stats);
+  histogram->SetEntries(entries);
+}
+
+} // namespace
+
+CellAccumulators::CellAccumulators()
+  : mCells(NSUPERMODULES * NCELLS), mMaxBunchCounts(NSUPERMODULES * NADC), mMinBunchCounts(NSUPERMODULES * NADC)
+{
+  reset();
+}
+
+void CellAccumulators::fillHistograms(const Histograms& histograms)
+{
+  for (int sm = 0; sm < NSUPERMODULES; sm++) {
+    if (!mFilled[sm]) {
+      continue;
+    }
+    // setting the bins directly does not count the entries, they are added at the end
+    Double_t entries[4] = { histograms.mean[sm]->GetEntries(), histograms.rms[sm]->GetEntries(),
+                            histograms.max[sm]->GetEntries(), histograms.min[sm]->GetEntries() };
+    for (int row = 0; row < NROWS; row++) {
+      for (int col = 0; col < NCOLS; col++) {
+        const auto& cell = mCells[sm * NCELLS + row * NCOLS + col];
+        if (cell.nBunches > 0) {
+          addToProfile(histograms.mean[sm], col, row, cell.nBunches, cell.mean, cell.mean2);
+          addToProfile(histograms.rms[sm], col, row, cell.nBunches, cell.rms, cell.rms2);
+          entries[0] += cell.nBunches;
+          entries[1] += cell.nBunches;
+        }
+        if (cell.nChannels > 0) {
+          addToProfile(histograms.max[sm], col, row, cell.nChannels, cell.max, cell.max2);
+          addToProfile(histograms.min[sm], col, row, cell.nChannels, cell.min, cell.min2);
+          entries[2] += cell.nChannels;
+          entries[3] += cell.nChannels;
+        }
+      }
+    }
+    histograms.mean[sm]->SetEntries(entries[0]);
+    histograms.rms[sm]->SetEntries(entries[1]);
+    histograms.max[sm]->SetEntries(entries[2]);
+    histograms.min[sm]->SetEntries(entries[3]);
+
+    addToHistogram(histograms.maxBunch[sm], mMaxBunchCounts.data() + sm * NADC);
+    addToHistogram(histograms.minBunch[sm], mMinBunchCounts.data() + sm * NADC);
+  }
+  reset();
+}
+
+void CellAccumulators::reset()
+{
+  std::fill(mCells.begin(), mCells.end(), CellSums{});
+  std::fill(mMaxBunchCounts.begin(), mMaxBunchCounts.end(), 0);
+  std::fill(mMinBunchCounts.begin(), mMinBunchCounts.end(), 0);
+  mFilled.fill(false);
+}
+
+} // namespace o2::quality_control_modules::emcal
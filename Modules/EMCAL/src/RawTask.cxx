@@ -17,8 +17,11 @@
 #include <TCanvas.h>
 #include <TH1.h>
 #include <TProfile2D.h>
-#include <TMath.h>
+#include <algorithm>
+#include <atomic>
 #include <cfloat>
+#include <exception>
+#include <thread>
 
 #include "QualityControl/QcInfoLogger.h"
 #include "EMCAL/RawTask.h"
@@ -101,6 +104,10 @@ void RawTask::initialize(o2::framework::InitContext& /*ctx*/)
   if (auto param = mCustomParameters.find("myOwnKey"); param != mCustomParameters.end()) {
     QcInfoLogger::GetInstance() << "Custom parameter - myOwnKey : " << param->second << AliceO2::InfoLogger::InfoLogger::endm;
   }
+  if (auto param = mCustomParameters.find("decodingThreads"); param != mCustomParameters.end()) {
+    mDecodingThreads = std::max(1, std::stoi(param->second));
+  }
+  mCellAccumulators = std::vector<CellAccumulators>(mDecodingThreads);
 
   mMappings = std::unique_ptr<o2::emcal::MappingHandler>(new o2::emcal::MappingHandler); //initialize the unique pointer to Mapper
 
@@ -220,170 +227,249 @@ void RawTask::monitorData(o2::framework::ProcessingContext& ctx)
   // One can find additional examples at:
   // https://github.com/AliceO2Group/AliceO2/blob/dev/Framework/Core/README.md#using-inputs---the-inputrecord-api
 
-  using CHTYP = o2::emcal::ChannelType_t;
-
-  Int_t nPagesMessage = 0, nSuperpagesMessage = 0;
-  QcInfoLogger::GetInstance() << QcInfoLogger::Debug << " Processing message " << mNumberOfMessages << AliceO2::InfoLogger::InfoLogger::endm;
+  Int_t nSuperpagesMessage = 0;
+  const Int_t nPagesBefore = mNumberOfPages;
+  ILOG_FILTERED(Debug) << " Processing message " << mNumberOfMessages << ENDM;
   mNumberOfMessages++;
   mMessageCounter->Fill(1);
 
   // Some examples:
   // 1. In a loop
+  std::vector<gsl::span<const char>> superpages;
   for (auto&& input : ctx.inputs()) {
     // get message header
     if (input.header != nullptr && input.payload != nullptr) {
       const auto* header = header::get<header::DataHeader*>(input.header);
       // get payload of a specific input, which is a char array.
       // const char* payload = input.payload;
-      QcInfoLogger::GetInstance() << QcInfoLogger::Debug << "Processing superpage " << mNumberOfSuperpages << AliceO2::InfoLogger::InfoLogger::endm;
+      ILOG_FILTERED(Debug) << "Processing superpage " << mNumberOfSuperpages << ENDM;
       mNumberOfSuperpages++;
       nSuperpagesMessage++;
       mSuperpageCounter->Fill(1);
-      QcInfoLogger::GetInstance() << QcInfoLogger::Debug << " EMCAL Reading Payload size: " << header->payloadSize << " for " << header->dataOrigin << AliceO2::InfoLogger::InfoLogger::endm;
+      ILOG_FILTERED(Debug) << " EMCAL Reading Payload size: " << header->payloadSize << " for " << header->dataOrigin << ENDM;
 
       //fill the histogram with payload sizes
       mHistogram->Fill(header->payloadSize);
       mTotalDataVolume->Fill(1., header->payloadSize);
 
-      // try decoding payload
-      o2::emcal::RawReaderMemory<o2::header::RAWDataHeaderV4> rawreader(gsl::span(input.payload, header->payloadSize));
-      uint64_t currentTrigger(0);
-      bool first = true; //for the first event
-      short int maxADCSM[20];
-      short int minADCSM[20];
+      superpages.emplace_back(input.payload, header->payloadSize);
+    } //header
+  }   //inputs
+
+  // try decoding payload
+  if (mDecodingThreads > 1) {
+    decodeInParallel(superpages);
+  } else {
+    for (auto& superpage : superpages) {
+      o2::emcal::RawReaderMemory<o2::header::RAWDataHeaderV4> rawreader(superpage);
+      TriggerState trigger;
       while (rawreader.hasNext()) {
-        QcInfoLogger::GetInstance() << QcInfoLogger::Debug << " Processing page " << mNumberOfPages << AliceO2::InfoLogger::InfoLogger::endm;
-        mNumberOfPages++;
-        nPagesMessage++;
-        mPageCounter->Fill(1);
         rawreader.next();
-        auto payLoadSize = rawreader.getPayloadSize(); //payloadsize in byte;
-
-        auto headerR = rawreader.getRawHeader();
-        mPayloadSizePerDDL->Fill(headerR.feeId, payLoadSize / 1024.);
-
-        //fill histograms with max ADC for each supermodules and reset cache
-        if (!first) {                               // check if it is the first event in the payload
-          if (headerR.triggerBC > currentTrigger) { //new event
-            for (int sm = 0; sm < 20; sm++) {
-              mRawAmplitudeEMCAL[sm]->Fill(maxADCSM[sm]);
-              maxADCSM[sm] = 0;
-              //initialize
-              minADCSM[sm] = SHRT_MAX;
-            } //sm loop
-            currentTrigger = headerR.triggerBC;
-          }      //new event
-        } else { //first
-          currentTrigger = headerR.triggerBC;
-          first = false;
-        }
-        if (headerR.feeId > 40)
-          continue;                                                      //skip STU ddl
-        o2::emcal::AltroDecoder<decltype(rawreader)> decoder(rawreader); //(atrodecoder in Detectors/Emcal/reconstruction/src)
-        //check the words of the payload exception in altrodecoder
-        try {
-          decoder.decode();
-        } catch (AltroDecoderError& e) {
-          std::stringstream errormessage;
-          using AltroErrType = o2::emcal::AltroDecoderError::ErrorType_t;
-          int errornum = -1;
-          switch (e.getErrorType()) {
-            case AltroErrType::RCU_TRAILER_ERROR:
-              errornum = 0;
-              errormessage << " RCU Trailer Error ";
-              break;
-            case AltroErrType::RCU_VERSION_ERROR:
-              errornum = 1;
-              errormessage << " RCU Version Error ";
-              break;
-            case AltroErrType::RCU_TRAILER_SIZE_ERROR:
-              errornum = 2;
-              errormessage << " RCU Trailer Size Error ";
-              break;
-            case AltroErrType::ALTRO_BUNCH_HEADER_ERROR:
-              errornum = 3;
-              errormessage << " ALTRO Bunch Header Error ";
-              break;
-            case AltroErrType::ALTRO_BUNCH_LENGTH_ERROR:
-              errornum = 4;
-              errormessage << " ALTRO Bunch Length Error ";
-              break;
-            case AltroErrType::ALTRO_PAYLOAD_ERROR:
-              errornum = 5;
-              errormessage << " ALTRO Payload Error ";
-              break;
-            case AltroErrType::ALTRO_MAPPING_ERROR:
-              errornum = 6;
-              errormessage << " ALTRO Mapping Error ";
-              break;
-            case AltroErrType::CHANNEL_ERROR:
-              errornum = 7;
-              errormessage << " Channel Error ";
-              break;
-            default:
-              break;
-          }
-          errormessage << " in Supermodule " << headerR.feeId;
-          QcInfoLogger::GetInstance() << QcInfoLogger::Error << " EMCAL raw task: " << errormessage.str() << AliceO2::InfoLogger::InfoLogger::endm;
-          //fill histograms  with error types
-          mErrorTypeAltro->Fill(headerR.feeId, errornum);
-          continue;
-        }
-        int j = headerR.feeId / 2; //SM id
-        auto& mapping = mMappings->getMappingForDDL(headerR.feeId);
-        int col;
-
-        int row;
-
-        for (auto& chan : decoder.getChannels()) {
-          col = mapping.getColumn(chan.getHardwareAddress());
-          row = mapping.getRow(chan.getHardwareAddress());
-          //exclude LED Mon, TRU
-          auto chType = mapping.getChannelType(chan.getHardwareAddress());
-          if (chType == CHTYP::LEDMON || chType == CHTYP::TRU)
-            continue;
-
-          Short_t maxADC = 0;
-          Short_t minADC = SHRT_MAX;
-          Double_t meanADC = 0;
-          Double_t rmsADC = 0;
-          for (auto& bunch : chan.getBunches()) {
-            auto adcs = bunch.getADC();
-
-            auto maxADCbunch = *max_element(adcs.begin(), adcs.end());
-            if (maxADCbunch > maxADC)
-              maxADC = maxADCbunch;
-            mRawAmplMaxEMCAL[j]->Fill(maxADCbunch); // max for each cell
-
-            auto minADCbunch = *min_element(adcs.begin(), adcs.end());
-            if (minADCbunch < minADC)
-              minADC = minADCbunch;
-            mRawAmplMinEMCAL[j]->Fill(minADCbunch); // min for each cell
-
-            meanADC = TMath::Mean(adcs.begin(), adcs.end());
-            rmsADC = TMath::RMS(adcs.begin(), adcs.end());
-            mRMSperSM[j]->Fill(col, row, rmsADC);
-            mMEANperSM[j]->Fill(col, row, meanADC);
-          }
-          if (maxADC > maxADCSM[j])
-            maxADCSM[j] = maxADC;
-          mMAXperSM[j]->Fill(col, row, maxADC);
-
-          if (minADC < minADCSM[j])
-            minADCSM[j] = minADC;
-          mMINperSM[j]->Fill(col, row, minADC);
-
-        } //channels
-      }   //new page
-    }     //header
-  }       //inputs
-  mNumberOfPagesPerMessage->Fill(nPagesMessage);
+        processPage(readPage(rawreader, mCellAccumulators[0]), trigger);
+      } //new page
+    }
+  }
+  mNumberOfPagesPerMessage->Fill(mNumberOfPages - nPagesBefore);
   mNumberOfSuperpagesPerMessage->Fill(nSuperpagesMessage);
 } //function monitor data
 
+template <typename RawReader>
+RawTask::PageResult RawTask::readPage(RawReader& rawreader, CellAccumulators& accumulators) const
+{
+  using CHTYP = o2::emcal::ChannelType_t;
+
+  auto headerR = rawreader.getRawHeader();
+  PageResult page;
+  page.feeId = headerR.feeId;
+  page.triggerBC = headerR.triggerBC;
+  page.payloadSize = rawreader.getPayloadSize(); //payloadsize in byte;
+  if (page.feeId >= 40)
+    return page;                                     //skip STU ddl
+  o2::emcal::AltroDecoder<RawReader> decoder(rawreader); //(atrodecoder in Detectors/Emcal/reconstruction/src)
+  //check the words of the payload exception in altrodecoder
+  try {
+    decoder.decode();
+  } catch (AltroDecoderError& e) {
+    using AltroErrType = o2::emcal::AltroDecoderError::ErrorType_t;
+    switch (e.getErrorType()) {
+      case AltroErrType::RCU_TRAILER_ERROR:
+        page.error = 0;
+        break;
+      case AltroErrType::RCU_VERSION_ERROR:
+        page.error = 1;
+        break;
+      case AltroErrType::RCU_TRAILER_SIZE_ERROR:
+        page.error = 2;
+        break;
+      case AltroErrType::ALTRO_BUNCH_HEADER_ERROR:
+        page.error = 3;
+        break;
+      case AltroErrType::ALTRO_BUNCH_LENGTH_ERROR:
+        page.error = 4;
+        break;
+      case AltroErrType::ALTRO_PAYLOAD_ERROR:
+        page.error = 5;
+        break;
+      case AltroErrType::ALTRO_MAPPING_ERROR:
+        page.error = 6;
+        break;
+      case AltroErrType::CHANNEL_ERROR:
+        page.error = 7;
+        break;
+      default:
+        page.error = -1;
+        break;
+    }
+    page.decoded = false;
+    return page;
+  }
+  int j = page.feeId / 2; //SM id
+  auto& mapping = mMappings->getMappingForDDL(page.feeId);
+  int col;
+
+  int row;
+
+  for (auto& chan : decoder.getChannels()) {
+    col = mapping.getColumn(chan.getHardwareAddress());
+    row = mapping.getRow(chan.getHardwareAddress());
+    //exclude LED Mon, TRU
+    auto chType = mapping.getChannelType(chan.getHardwareAddress());
+    if (chType == CHTYP::LEDMON || chType == CHTYP::TRU)
+      continue;
+
+    // the per cell histograms are filled at the end of the cycle
+    auto extrema = accumulators.addChannel(j, col, row, chan.getBunches());
+    if (extrema.max > page.maxADC)
+      page.maxADC = extrema.max;
+
+    if (extrema.min < page.minADC)
+      page.minADC = extrema.min;
+
+  } //channels
+  return page;
+}
+
+void RawTask::processPage(const PageResult& page, TriggerState& trigger)
+{
+  ILOG_FILTERED(Debug) << " Processing page " << mNumberOfPages << ENDM;
+  mNumberOfPages++;
+  mPageCounter->Fill(1);
+  mPayloadSizePerDDL->Fill(page.feeId, page.payloadSize / 1024.);
+
+  //fill histograms with max ADC for each supermodules and reset cache
+  if (!trigger.first) {                             // check if it is the first event in the payload
+    if (page.triggerBC > trigger.currentTrigger) { //new event
+      for (int sm = 0; sm < 20; sm++) {
+        mRawAmplitudeEMCAL[sm]->Fill(trigger.maxADCSM[sm]);
+        trigger.maxADCSM[sm] = 0;
+        //initialize
+        trigger.minADCSM[sm] = SHRT_MAX;
+      } //sm loop
+      trigger.currentTrigger = page.triggerBC;
+    }      //new event
+  } else { //first
+    trigger.currentTrigger = page.triggerBC;
+    trigger.first = false;
+  }
+  if (page.feeId >= 40)
+    return; //skip STU ddl
+  if (!page.decoded) {
+    static const char* errormessages[] = { " RCU Trailer Error ", " RCU Version Error ", " RCU Trailer Size Error ", " ALTRO Bunch Header Error ",
+                                           " ALTRO Bunch Length Error ", " ALTRO Payload Error ", " ALTRO Mapping Error ", " Channel Error " };
+    ILOG_RATE_LIMITED(Error, 10) << " EMCAL raw task: " << (page.error >= 0 ? errormessages[page.error] : "") << " in Supermodule " << page.feeId << ENDM;
+    //fill histograms  with error types
+    mErrorTypeAltro->Fill(page.feeId, page.error);
+    return;
+  }
+  int j = page.feeId / 2; //SM id
+  if (page.maxADC > trigger.maxADCSM[j])
+    trigger.maxADCSM[j] = page.maxADC;
+
+  if (page.minADC < trigger.minADCSM[j])
+    trigger.minADCSM[j] = page.minADC;
+}
+
+void RawTask::decodeInParallel(const std::vector<gsl::span<const char>>& superpages)
+{
+  // The pages are indexed by walking through their headers, and grouped in segments of consecutive pages of the
+  // same DDL, which are decoded by the threads as the superpages would be decoded by one raw reader.
+  struct Segment {
+    size_t superpage;
+    gsl::span<const char> data;
+    std::vector<PageResult> pages;
+  };
+  std::vector<Segment> segments;
+  for (size_t i = 0; i < superpages.size(); i++) {
+    auto& superpage = superpages[i];
+    size_t position = 0, segmentStart = 0;
+    int segmentFeeId = -1;
+    while (position + sizeof(o2::header::RAWDataHeaderV4) <= superpage.size()) {
+      auto rdh = reinterpret_cast<const o2::header::RAWDataHeaderV4*>(superpage.data() + position);
+      if (rdh->offsetToNext == 0) {
+        break;
+      }
+      if (segmentFeeId >= 0 && int(rdh->feeId) != segmentFeeId) {
+        segments.push_back({ i, superpage.subspan(segmentStart, position - segmentStart), {} });
+        segmentStart = position;
+      }
+      segmentFeeId = rdh->feeId;
+      position += rdh->offsetToNext;
+    }
+    // the last segment also takes what could not be indexed, such that it is handled by the raw reader
+    if (segmentStart < superpage.size()) {
+      segments.push_back({ i, superpage.subspan(segmentStart), {} });
+    }
+  }
+
+  // the segments are decoded by the threads as they become free, each thread with its own accumulators
+  int nThreads = std::max<int>(1, std::min<size_t>(mDecodingThreads, segments.size()));
+  std::atomic<size_t> nextSegment{ 0 };
+  std::vector<std::exception_ptr> exceptions(nThreads);
+  auto worker = [&](int t) {
+    try {
+      for (size_t s = nextSegment++; s < segments.size(); s = nextSegment++) {
+        o2::emcal::RawReaderMemory<o2::header::RAWDataHeaderV4> rawreader(segments[s].data);
+        while (rawreader.hasNext()) {
+          rawreader.next();
+          segments[s].pages.push_back(readPage(rawreader, mCellAccumulators[t]));
+        }
+      }
+    } catch (...) {
+      exceptions[t] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nThreads; t++) {
+    threads.emplace_back(worker, t);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (auto& exception : exceptions) {
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  // the pages are processed in their order in the superpages, such that the trigger boundaries are the same as when
+  // decoding them serially
+  TriggerState trigger;
+  for (size_t s = 0; s < segments.size(); s++) {
+    if (s > 0 && segments[s].superpage != segments[s - 1].superpage) {
+      trigger = TriggerState();
+    }
+    for (auto& page : segments[s].pages) {
+      processPage(page, trigger);
+    }
+  }
+}
+
 void RawTask::endOfCycle()
 {
   QcInfoLogger::GetInstance() << "endOfCycle" << AliceO2::InfoLogger::InfoLogger::endm;
+  for (auto& accumulators : mCellAccumulators) {
+    accumulators.fillHistograms({ mMEANperSM, mRMSperSM, mMAXperSM, mMINperSM, mRawAmplMaxEMCAL, mRawAmplMinEMCAL });
+  }
 }
 
 void RawTask::endOfActivity(Activity& /*activity*/)
@@ -398,6 +484,9 @@ void RawTask::reset()
   // clean all the monitor objects here
 
   QcInfoLogger::GetInstance() << "Resetting the histogram" << AliceO2::InfoLogger::InfoLogger::endm;
+  for (auto& accumulators : mCellAccumulators) {
+    accumulators.reset();
+  }
   mHistogram->Reset();
   for (Int_t i = 0; i < 20; i++) {
     mRawAmplitudeEMCAL[i]->Reset();
@@ -0,0 +1,180 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkCellAccumulators.cxx
+///
+
+#include "EMCAL/CellAccumulators.h"
+
+#include <TH1F.h>
+#include <TMath.h>
+#include <TProfile2D.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace o2::quality_control_modules::emcal;
+
+namespace
+{
+
+// Decoded bunch of ALTRO samples, with the interface of o2::emcal::Bunch used by the accumulators
+struct Bunch {
+  std::vector<uint16_t> adcs;
+  const std::vector<uint16_t>& getADC() const { return adcs; }
+};
+
+struct Channel {
+  int col;
+  int row;
+  std::vector<Bunch> bunches;
+};
+
+// A page of one DDL: the channels of its supermodule which are read out in one 8 kB page
+struct Page {
+  int supermodule;
+  std::vector<Channel> channels;
+};
+
+Page generatePage(std::mt19937& generator, int supermodule, int nChannels)
+{
+  std::poisson_distribution<int> pedestal(40);
+  std::uniform_int_distribution<int> signal(0, 60);
+  Page page{ supermodule, {} };
+  for (int i = 0; i < nChannels; i++) {
+    Channel channel{ int(generator() % CellAccumulators::NCOLS), int(generator() % CellAccumulators::NROWS), {} };
+    int nBunches = 1 + generator() % 2;
+    for (int b = 0; b < nBunches; b++) {
+      Bunch bunch;
+      int peak = signal(generator);
+      for (int s = 0; s < 15; s++) {
+        bunch.adcs.push_back(std::min(pedestal(generator) + peak * (7 - std::abs(s - 7)) / 7, CellAccumulators::NADC - 1));
+      }
+      channel.bunches.push_back(bunch);
+    }
+    page.channels.push_back(channel);
+  }
+  return page;
+}
+
+struct Histograms {
+  std::vector<std::unique_ptr<TProfile2D>> profiles;
+  std::vector<std::unique_ptr<TH1F>> histograms;
+  CellAccumulators::Histograms pointers;
+
+  explicit Histograms(const std::string& prefix)
+  {
+    for (int sm = 0; sm < CellAccumulators::NSUPERMODULES; sm++) {
+      auto profile = [&](const char* name, double colMax, double rowMax) {
+        profiles.emplace_back(new TProfile2D(Form("%s%s%d", prefix.c_str(), name, sm), name, 48, 0, colMax, 24, 0, rowMax));
+        return profiles.back().get();
+      };
+      auto histogram = [&](const char* name) {
+        histograms.emplace_back(new TH1F(Form("%s%s%d", prefix.c_str(), name, sm), name, 100, 0., 100.));
+        return histograms.back().get();
+      };
+      pointers.mean[sm] = profile("MeanADCperSM", 48, 24);
+      pointers.rms[sm] = profile("RMSADCperSM", 48, 24);
+      pointers.max[sm] = profile("MaxADCperSM", 47, 23);
+      pointers.min[sm] = profile("MinADCperSM", 47, 23);
+      pointers.maxBunch[sm] = histogram("RawAmplMaxEMCAL_sm");
+      pointers.minBunch[sm] = histogram("RawAmplMinEMCAL_sm");
+    }
+  }
+};
+
+// The histograms filled for each bunch and channel, as RawTask used to do
+void fillPerBunch(const Page& page, const CellAccumulators::Histograms& h)
+{
+  int j = page.supermodule;
+  for (auto& chan : page.channels) {
+    Short_t maxADC = 0;
+    Short_t minADC = SHRT_MAX;
+    for (auto& bunch : chan.bunches) {
+      auto adcs = bunch.getADC();
+      auto maxADCbunch = *std::max_element(adcs.begin(), adcs.end());
+      maxADC = std::max<Short_t>(maxADC, maxADCbunch);
+      h.maxBunch[j]->Fill(maxADCbunch);
+      auto minADCbunch = *std::min_element(adcs.begin(), adcs.end());
+      minADC = std::min<Short_t>(minADC, minADCbunch);
+      h.minBunch[j]->Fill(minADCbunch);
+      h.rms[j]->Fill(chan.col, chan.row, TMath::RMS(adcs.begin(), adcs.end()));
+      h.mean[j]->Fill(chan.col, chan.row, TMath::Mean(adcs.begin(), adcs.end()));
+    }
+    h.max[j]->Fill(chan.col, chan.row, maxADC);
+    h.min[j]->Fill(chan.col, chan.row, minADC);
+  }
+}
+
+} // namespace
+
+// Processing time of synthetic pages of decoded ALTRO channels, filled per bunch in the histograms or accumulated
+// per cell and filled in the histograms at the end of each cycle.
+int main(int argc, char** argv)
+{
+  int nPages = (argc > 1) ? std::stoi(argv[1]) : 4000;
+  int nChannels = (argc > 2) ? std::stoi(argv[2]) : 100;
+  int nCycles = (argc > 3) ? std::stoi(argv[3]) : 10;
+
+  std::mt19937 generator(1234);
+  std::vector<Page> pages;
+  for (int i = 0; i < nPages; i++) {
+    pages.push_back(generatePage(generator, i % CellAccumulators::NSUPERMODULES, nChannels));
+  }
+
+  Histograms perBunch("perBunch");
+  auto start = std::chrono::steady_clock::now();
+  for (int cycle = 0; cycle < nCycles; cycle++) {
+    for (auto& page : pages) {
+      fillPerBunch(page, perBunch.pointers);
+    }
+  }
+  std::chrono::duration<double> timePerBunch = std::chrono::steady_clock::now() - start;
+
+  Histograms accumulated("accumulated");
+  auto accumulators = std::make_unique<CellAccumulators>();
+  start = std::chrono::steady_clock::now();
+  for (int cycle = 0; cycle < nCycles; cycle++) {
+    for (auto& page : pages) {
+      for (auto& chan : page.channels) {
+        accumulators->addChannel(page.supermodule, chan.col, chan.row, chan.bunches);
+      }
+    }
+    accumulators->fillHistograms(accumulated.pointers);
+  }
+  std::chrono::duration<double> timeAccumulated = std::chrono::steady_clock::now() - start;
+
+  // the histograms must be the same, up to the rounding of the sums
+  double maxDifference = 0;
+  for (size_t i = 0; i < perBunch.profiles.size(); i++) {
+    for (int bin = 0; bin < perBunch.profiles[i]->GetNcells(); bin++) {
+      maxDifference = std::max(maxDifference, std::abs(perBunch.profiles[i]->GetBinContent(bin) - accumulated.profiles[i]->GetBinContent(bin)));
+      maxDifference = std::max(maxDifference, std::abs(perBunch.profiles[i]->GetBinError(bin) - accumulated.profiles[i]->GetBinError(bin)));
+    }
+  }
+  for (size_t i = 0; i < perBunch.histograms.size(); i++) {
+    for (int bin = 0; bin < perBunch.histograms[i]->GetNcells(); bin++) {
+      maxDifference = std::max(maxDifference, std::abs(perBunch.histograms[i]->GetBinContent(bin) - accumulated.histograms[i]->GetBinContent(bin)));
+    }
+    maxDifference = std::max(maxDifference, std::abs(perBunch.histograms[i]->GetMean() - accumulated.histograms[i]->GetMean()));
+  }
+
+  printf("%d pages of %d channels, %d cycles\n", nPages, nChannels, nCycles);
+  printf("%-32s %12.1f\n", "filled per bunch (pages/s)", nPages * nCycles / timePerBunch.count());
+  printf("%-32s %12.1f\n", "accumulated per cell (pages/s)", nPages * nCycles / timeAccumulated.count());
+  printf("%-32s %12.3g\n", "max difference", maxDifference);
+  return 0;
+}
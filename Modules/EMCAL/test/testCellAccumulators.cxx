@@ -0,0 +1,186 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCellAccumulators.cxx
+///
+
+#include "EMCAL/CellAccumulators.h"
+
+#include <TH1F.h>
+#include <TMath.h>
+#include <TProfile2D.h>
+
+#define BOOST_TEST_MODULE CellAccumulators test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace emcal
+{
+
+// Decoded bunch of ALTRO samples, with the interface of o2::emcal::Bunch used by the accumulators
+struct Bunch {
+  std::vector<uint16_t> adcs;
+  const std::vector<uint16_t>& getADC() const { return adcs; }
+};
+
+struct Channel {
+  int supermodule;
+  int col;
+  int row;
+  std::vector<Bunch> bunches;
+};
+
+std::vector<Channel> generateChannels(std::mt19937& generator, int nChannels)
+{
+  std::poisson_distribution<int> pedestal(40);
+  std::uniform_int_distribution<int> signal(0, 60);
+  std::vector<Channel> channels;
+  for (int i = 0; i < nChannels; i++) {
+    // a few supermodules and cells only, such that the bins get several entries
+    Channel channel{ int(generator() % 3), int(generator() % 4), int(generator() % 3), {} };
+    int nBunches = generator() % 3; // including channels without bunches
+    for (int b = 0; b < nBunches; b++) {
+      Bunch bunch;
+      int peak = signal(generator);
+      int nSamples = 1 + generator() % 15;
+      for (int s = 0; s < nSamples; s++) {
+        bunch.adcs.push_back(std::min(pedestal(generator) + peak * (7 - std::abs(s - 7)) / 7, CellAccumulators::NADC - 1));
+      }
+      channel.bunches.push_back(bunch);
+    }
+    channels.push_back(channel);
+  }
+  return channels;
+}
+
+struct Histograms {
+  std::vector<std::unique_ptr<TProfile2D>> profiles;
+  std::vector<std::unique_ptr<TH1F>> histograms;
+  CellAccumulators::Histograms pointers;
+
+  explicit Histograms(const std::string& prefix)
+  {
+    for (int sm = 0; sm < CellAccumulators::NSUPERMODULES; sm++) {
+      auto profile = [&](const char* name, double colMax, double rowMax) {
+        profiles.emplace_back(new TProfile2D(Form("%s%s%d", prefix.c_str(), name, sm), name, 48, 0, colMax, 24, 0, rowMax));
+        return profiles.back().get();
+      };
+      auto histogram = [&](const char* name) {
+        histograms.emplace_back(new TH1F(Form("%s%s%d", prefix.c_str(), name, sm), name, 100, 0., 100.));
+        return histograms.back().get();
+      };
+      pointers.mean[sm] = profile("MeanADCperSM", 48, 24);
+      pointers.rms[sm] = profile("RMSADCperSM", 48, 24);
+      pointers.max[sm] = profile("MaxADCperSM", 47, 23);
+      pointers.min[sm] = profile("MinADCperSM", 47, 23);
+      pointers.maxBunch[sm] = histogram("RawAmplMaxEMCAL_sm");
+      pointers.minBunch[sm] = histogram("RawAmplMinEMCAL_sm");
+    }
+  }
+};
+
+// The histograms filled for each bunch and channel, as RawTask used to do
+void fillPerBunch(const std::vector<Channel>& channels, const CellAccumulators::Histograms& h)
+{
+  for (auto& chan : channels) {
+    int j = chan.supermodule;
+    Short_t maxADC = 0;
+    Short_t minADC = SHRT_MAX;
+    for (auto& bunch : chan.bunches) {
+      auto adcs = bunch.getADC();
+      auto maxADCbunch = *std::max_element(adcs.begin(), adcs.end());
+      maxADC = std::max<Short_t>(maxADC, maxADCbunch);
+      h.maxBunch[j]->Fill(maxADCbunch);
+      auto minADCbunch = *std::min_element(adcs.begin(), adcs.end());
+      minADC = std::min<Short_t>(minADC, minADCbunch);
+      h.minBunch[j]->Fill(minADCbunch);
+      h.rms[j]->Fill(chan.col, chan.row, TMath::RMS(adcs.begin(), adcs.end()));
+      h.mean[j]->Fill(chan.col, chan.row, TMath::Mean(adcs.begin(), adcs.end()));
+    }
+    h.max[j]->Fill(chan.col, chan.row, maxADC);
+    h.min[j]->Fill(chan.col, chan.row, minADC);
+  }
+}
+
+void checkSameHistograms(Histograms& perBunch, Histograms& accumulated)
+{
+  const double tolerance = 1e-9; // in percent, the sums are only rounded differently
+  for (size_t i = 0; i < perBunch.profiles.size(); i++) {
+    auto& expected = perBunch.profiles[i];
+    auto& profile = accumulated.profiles[i];
+    BOOST_TEST_CONTEXT(expected->GetName())
+    {
+      BOOST_CHECK_EQUAL(profile->GetEntries(), expected->GetEntries());
+      for (int bin = 0; bin < expected->GetNcells(); bin++) {
+        BOOST_CHECK_EQUAL(profile->GetBinEntries(bin), expected->GetBinEntries(bin));
+        BOOST_CHECK_CLOSE(profile->GetBinContent(bin), expected->GetBinContent(bin), tolerance);
+        BOOST_CHECK_CLOSE(profile->GetBinError(bin), expected->GetBinError(bin), tolerance);
+      }
+    }
+  }
+  for (size_t i = 0; i < perBunch.histograms.size(); i++) {
+    auto& expected = perBunch.histograms[i];
+    auto& histogram = accumulated.histograms[i];
+    BOOST_TEST_CONTEXT(expected->GetName())
+    {
+      BOOST_CHECK_EQUAL(histogram->GetEntries(), expected->GetEntries());
+      for (int bin = 0; bin < expected->GetNcells(); bin++) {
+        BOOST_CHECK_EQUAL(histogram->GetBinContent(bin), expected->GetBinContent(bin));
+        BOOST_CHECK_CLOSE(histogram->GetBinError(bin), expected->GetBinError(bin), tolerance);
+      }
+      BOOST_CHECK_CLOSE(histogram->GetMean(), expected->GetMean(), tolerance);
+      BOOST_CHECK_CLOSE(histogram->GetStdDev(), expected->GetStdDev(), tolerance);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(same_as_per_bunch_fills)
+{
+  std::mt19937 generator(1234);
+  Histograms perBunch("perBunch");
+  Histograms accumulated("accumulated");
+  auto accumulators = std::make_unique<CellAccumulators>();
+
+  // several cycles, such that the accumulators are added to histograms which already have entries
+  for (int cycle = 0; cycle < 3; cycle++) {
+    auto channels = generateChannels(generator, 500);
+    fillPerBunch(channels, perBunch.pointers);
+    for (auto& chan : channels) {
+      auto extrema = accumulators->addChannel(chan.supermodule, chan.col, chan.row, chan.bunches);
+      if (chan.bunches.empty()) {
+        BOOST_CHECK_EQUAL(extrema.max, 0);
+        BOOST_CHECK_EQUAL(extrema.min, SHRT_MAX);
+      }
+    }
+    accumulators->fillHistograms(accumulated.pointers);
+    checkSameHistograms(perBunch, accumulated);
+  }
+
+  // nothing is added once the accumulators are reset
+  accumulators->fillHistograms(accumulated.pointers);
+  checkSameHistograms(perBunch, accumulated);
+}
+
+} // namespace emcal
+} // namespace quality_control_modules
+} // namespace o2
@@ -0,0 +1,155 @@
+///
+/// \file   HitmapStore.h
+/// \brief  Compact storage of the pixel hitmaps of the ITS chips
+///
+
+#ifndef QC_MODULE_ITS_HITMAPSTORE_H
+#define QC_MODULE_ITS_HITMAPSTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class TH2;
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace its
+{
+
+/// \brief Number of hits of each pixel of each chip
+///
+/// The occupancy of most chips is very low, so the counters of the pixels which were hit are kept in a small
+/// open-addressing hash table per chip. When the number of fired pixels of a chip exceeds a threshold, its
+/// counters are moved to a dense array covering the whole matrix. The hitmaps are only converted to histograms
+/// on demand, with fillHistogram(). The chips which were hit since the last clearChangedChips() are listed, such that
+/// the quantities derived from the hitmaps can be updated incrementally.
+class HitmapStore
+{
+ public:
+  /// \param nChips          Number of chips
+  /// \param nCols           Number of pixel columns of a chip
+  /// \param nRows           Number of pixel rows of a chip
+  /// \param denseThreshold  Number of fired pixels above which the counters of a chip are stored densely,
+  ///                        by default 1/16 of the pixels
+  HitmapStore(int nChips = 0, int nCols = 1024, int nRows = 512, size_t denseThreshold = 0);
+
+  /// \brief Sets the number of chips, the hitmaps are reset
+  void resize(int nChips);
+  /// \brief Removes all the hits and releases the memory
+  void reset();
+
+  /// \brief Adds a hit to a pixel, the chip, column and row must be valid
+  void fill(int chip, int col, int row)
+  {
+    ChipHitmap& map = mChips[chip];
+    if (!map.changed) {
+      map.changed = true;
+      mChangedChips.push_back(chip);
+    }
+    map.nHits++;
+    uint32_t pixel = row * mNCols + col;
+    if (!map.dense.empty()) {
+      map.nFired += (map.dense[pixel]++ == 0);
+      return;
+    }
+    if (map.keys.empty() || 2 * (map.nFired + 1) > map.keys.size()) {
+      grow(map);
+      if (!map.dense.empty()) {
+        map.nFired += (map.dense[pixel]++ == 0);
+        return;
+      }
+    }
+    // the keys are the pixel indices plus one, 0 marks an empty slot
+    uint32_t key = pixel + 1;
+    size_t mask = map.keys.size() - 1;
+    for (size_t slot = hash(key) & mask;; slot = (slot + 1) & mask) {
+      if (map.keys[slot] == key) {
+        map.counts[slot]++;
+        return;
+      }
+      if (map.keys[slot] == 0) {
+        map.keys[slot] = key;
+        map.counts[slot] = 1;
+        map.nFired++;
+        return;
+      }
+    }
+  }
+
+  int getNumberOfChips() const { return static_cast<int>(mChips.size()); }
+  /// \brief Number of hits of the chip
+  uint64_t getChipHits(int chip) const { return mChips[chip].nHits; }
+  /// \brief Number of hits of one pixel
+  uint32_t getPixelHits(int chip, int col, int row) const;
+  /// \brief Number of pixels of the chip which were hit at least once
+  uint32_t getNumberOfFiredPixels(int chip) const { return mChips[chip].nFired; }
+  /// \brief Whether the counters of the chip are stored densely
+  bool isDense(int chip) const { return !mChips[chip].dense.empty(); }
+  /// \brief Bytes allocated for the counters of all the chips
+  size_t getMemoryUsage() const;
+
+  /// \brief Chips which were hit since the last call to clearChangedChips() or reset(), in the order of their first hit
+  const std::vector<int>& getChangedChips() const { return mChangedChips; }
+  void clearChangedChips();
+
+  /// \brief Calls f(col, row, hits) for each pixel of the chip which was hit, in no particular order
+  template <typename F>
+  void forEachPixel(int chip, F&& f) const
+  {
+    const ChipHitmap& map = mChips[chip];
+    if (!map.dense.empty()) {
+      for (uint32_t pixel = 0; pixel < map.dense.size(); pixel++) {
+        if (map.dense[pixel] > 0) {
+          f(pixel % mNCols, pixel / mNCols, map.dense[pixel]);
+        }
+      }
+      return;
+    }
+    for (size_t slot = 0; slot < map.keys.size(); slot++) {
+      if (map.keys[slot] != 0) {
+        uint32_t pixel = map.keys[slot] - 1;
+        f(pixel % mNCols, pixel / mNCols, map.counts[slot]);
+      }
+    }
+  }
+
+  /// \brief Sets the contents of a histogram binned like the pixel matrix (col + 1, row + 1) to the hits of the chip
+  void fillHistogram(int chip, TH2* h) const;
+
+ private:
+  struct ChipHitmap {
+    std::vector<uint32_t> keys; // pixel index + 1, 0 for the empty slots
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> dense; // counters of all the pixels, once the chip is stored densely
+    uint32_t nFired = 0;
+    uint64_t nHits = 0;
+    bool changed = false; // listed in mChangedChips
+  };
+
+  // finalizer of MurmurHash3, such that the pixels of the same column do not share the low bits
+  static uint32_t hash(uint32_t key)
+  {
+    key ^= key >> 16;
+    key *= 0x85ebca6b;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35;
+    key ^= key >> 16;
+    return key;
+  }
+  void grow(ChipHitmap& map);
+
+  int mNCols;
+  int mNRows;
+  size_t mDenseThreshold;
+  std::vector<ChipHitmap> mChips;
+  std::vector<int> mChangedChips;
+};
+
+} // namespace its
+} // namespace quality_control_modules
+} // namespace o2
+
+#endif // QC_MODULE_ITS_HITMAPSTORE_H
@@ -10,8 +10,10 @@
 #define QC_MODULE_ITS_ITSRAWTASK_H
 
 #include "QualityControl/TaskInterface.h"
+#include "ITS/HitmapStore.h"
 
 #include <TH2F.h>
+#include <map>
 #include <TPaveText.h>
 #include <TEllipse.h>
 #include <ITSMFTReconstruction/RawPixelReader.h>
@@ -58,6 +60,9 @@ class ITSRawTask : public TaskInterface // todo add back the "final" when doxyge
   {
     mChips.resize(n);
     mChipsOld.resize(n);
+    mChipHitmaps.resize(n);
+    mChipHitsInOccupancy.assign(n, 0);
+    mChipHitsDistribution.assign(n, {});
   }
   void ConfirmXAxis(TH1* h);
   void ReverseYAxis(TH1* h);
@@ -80,12 +85,28 @@ class ITSRawTask : public TaskInterface // todo add back the "final" when doxyge
   void updateFile(int aRunID, int aEpID, int aFileID);
   void resetHitmaps();
   void resetOccupancyPlots();
+  void resetOccupancyCounters();
+  void updateOccupancyCounters();
   void updateOccupancyPlots(int nEvents);
   void addObject(TObject* aObject, bool published = true);
   void enableLayers();
+  void buildChipGeometry();
+  void createChipHitmaps(const std::string& chipIDs);
+  void updateChipHitmaps();
   void formatStatistics(TH2* h);
   void format2DZaxis(TH2* h);
 
+  /// \brief Position of a chip in the detector and in the histograms, which only depends on the chip ID
+  struct ChipGeometry {
+    int layer;
+    int stave;
+    int hic;
+    int chip;      // chip in the HIC, as returned by the geometry
+    int hitmap;    // index of the chip hitmap of the HIC
+    int etaPhiBin; // global bin of the eta-phi hitmap of the layer, -1 if the layer is disabled
+    int occupancyBin; // global bin of the chip-stave occupancy of the layer, -1 if the layer is disabled
+  };
+
   ChipPixelData* mChipData = nullptr;
   std::vector<ChipPixelData> mChips;
   std::vector<ChipPixelData> mChipsOld;
@@ -103,7 +124,7 @@ class ITSRawTask : public TaskInterface // todo add back the "final" when doxyge
 
   int mSizeReduce = 4;
 
-  const int occUpdateFrequency = 1000000;
+  int occUpdateFrequency = 1000000; // in events
 
   int mDivisionStep = 32;
   static constexpr int NPixels = NRows * NCols;
@@ -128,11 +149,20 @@ class ITSRawTask : public TaskInterface // todo add back the "final" when doxyge
   TH2I* hEtaPhiHitmap[NLayer];
   TH2D* hChipStaveOccupancy[NLayer];
   TH2I* hHicHitmap[7][48][14];
-  TH2I* hChipHitmap[7][48][14][14];
+  HitmapStore mChipHitmaps; // fine binning, one hitmap per chip ID
+  std::vector<std::pair<int, TH2I*>> mPublishedChipHitmaps; // chip ID and histogram of the selected chips
   TH2I* hIBHitmap[3];
   const std::vector<o2::itsmft::Digit>* mDigits = nullptr;
 
   o2::its::GeometryTGeo* gm = o2::its::GeometryTGeo::Instance();
+  std::vector<ChipGeometry> mChipGeometry; // indexed by chip ID
+
+  // The occupancy plots are derived from these counters, which are only updated for the chips hit since the
+  // previous update, the plots are then normalised to the current number of events
+  std::vector<uint64_t> mChipHitsInOccupancy;                                    // hits of each chip in the counters
+  std::vector<std::vector<std::pair<uint32_t, uint32_t>>> mChipHitsDistribution; // number of pixels of each chip per number of hits
+  std::map<uint32_t, uint64_t> mPixelHitsDistribution[NLayer];                   // number of pixels of each layer per number of hits
+  std::vector<uint64_t> mChipStaveHits[NLayer];                                  // hits per bin of hChipStaveOccupancy
 
   static constexpr int NError = 11;
   std::array<unsigned int, NError> mErrors;
@@ -165,8 +195,6 @@ class ITSRawTask : public TaskInterface // todo add back the "final" when doxyge
   int mTotalFileDone;
   //	int FileRest;
 
-  int mCounted;
-  int mTotalCounted = 10000;
   int mYellowed;
 };
 
@@ -1,6 +1,5 @@
 int FileFinish;
 int FileFinishPre;
-double TotalHisTime;
 int FileRest;
 int ReallyDONE;
 int colTask;
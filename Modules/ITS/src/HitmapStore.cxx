@@ -0,0 +1,119 @@
+///
+/// \file   HitmapStore.cxx
+/// \brief  Compact storage of the pixel hitmaps of the ITS chips
+///
+
+#include "ITS/HitmapStore.h"
+
+#include <TH2.h>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace its
+{
+
+HitmapStore::HitmapStore(int nChips, int nCols, int nRows, size_t denseThreshold)
+  : mNCols(nCols), mNRows(nRows), mDenseThreshold(denseThreshold > 0 ? denseThreshold : (size_t)nCols * nRows / 16)
+{
+  resize(nChips);
+}
+
+void HitmapStore::resize(int nChips)
+{
+  mChips.clear();
+  mChips.resize(nChips);
+  mChangedChips.clear();
+}
+
+void HitmapStore::reset()
+{
+  for (auto& map : mChips) {
+    map = ChipHitmap();
+  }
+  mChangedChips.clear();
+}
+
+void HitmapStore::clearChangedChips()
+{
+  for (int chip : mChangedChips) {
+    mChips[chip].changed = false;
+  }
+  mChangedChips.clear();
+}
+
+void HitmapStore::grow(ChipHitmap& map)
+{
+  // a hot chip: the hash table would be larger than the dense array
+  if (map.nFired + 1 > mDenseThreshold) {
+    map.dense.assign((size_t)mNCols * mNRows, 0);
+    for (size_t slot = 0; slot < map.keys.size(); slot++) {
+      if (map.keys[slot] != 0) {
+        map.dense[map.keys[slot] - 1] = map.counts[slot];
+      }
+    }
+    std::vector<uint32_t>().swap(map.keys);
+    std::vector<uint32_t>().swap(map.counts);
+    return;
+  }
+
+  std::vector<uint32_t> keys(map.keys.empty() ? 16 : 2 * map.keys.size(), 0);
+  std::vector<uint32_t> counts(keys.size(), 0);
+  size_t mask = keys.size() - 1;
+  for (size_t slot = 0; slot < map.keys.size(); slot++) {
+    if (map.keys[slot] == 0) {
+      continue;
+    }
+    size_t newSlot = hash(map.keys[slot]) & mask;
+    while (keys[newSlot] != 0) {
+      newSlot = (newSlot + 1) & mask;
+    }
+    keys[newSlot] = map.keys[slot];
+    counts[newSlot] = map.counts[slot];
+  }
+  map.keys.swap(keys);
+  map.counts.swap(counts);
+}
+
+uint32_t HitmapStore::getPixelHits(int chip, int col, int row) const
+{
+  const ChipHitmap& map = mChips[chip];
+  uint32_t pixel = row * mNCols + col;
+  if (!map.dense.empty()) {
+    return map.dense[pixel];
+  }
+  if (map.keys.empty()) {
+    return 0;
+  }
+  uint32_t key = pixel + 1;
+  size_t mask = map.keys.size() - 1;
+  for (size_t slot = hash(key) & mask; map.keys[slot] != 0; slot = (slot + 1) & mask) {
+    if (map.keys[slot] == key) {
+      return map.counts[slot];
+    }
+  }
+  return 0;
+}
+
+size_t HitmapStore::getMemoryUsage() const
+{
+  size_t size = mChips.capacity() * sizeof(ChipHitmap);
+  for (const auto& map : mChips) {
+    size += (map.keys.capacity() + map.counts.capacity() + map.dense.capacity()) * sizeof(uint32_t);
+  }
+  return size;
+}
+
+void HitmapStore::fillHistogram(int chip, TH2* h) const
+{
+  h->Reset();
+  forEachPixel(chip, [h](int col, int row, uint32_t hits) {
+    h->SetBinContent(col + 1, row + 1, hits);
+  });
+  h->SetEntries(getChipHits(chip));
+}
+
+} // namespace its
+} // namespace quality_control_modules
+} // namespace o2
@@ -9,12 +9,15 @@
 ///
 
 #include "QualityControl/QcInfoLogger.h"
+#include "QualityControl/Tracing.h"
 #include "ITS/ITSRawTask.h"
 #include "ITS/ITSTaskVariables.h"
 
 #include <TGaxis.h>
 #include <TStyle.h>
 #include <TPad.h>
+#include <algorithm>
+#include <sstream>
 using o2::itsmft::Digit;
 
 using namespace std;
@@ -70,15 +73,15 @@ ITSRawTask::~ITSRawTask()
     for (int j = 0; j < 48; j++) {
       for (int k = 0; k < 14; k++) {
         delete hHicHitmap[i][j][k];
-        for (int l = 0; l < 14; l++) {
-          delete hChipHitmap[i][j][k][l];
-        }
       }
     }
   }
   for (int i = 0; i < 3; i++) {
     delete hIBHitmap[i];
   }
+  for (auto& chipHitmap : mPublishedChipHitmaps) {
+    delete chipHitmap.second;
+  }
   delete mDigits;
   delete gm;
   for (int i = 0; i < NError; i++) {
@@ -102,6 +105,16 @@ void ITSRawTask::initialize(o2::framework::InitContext& /*ctx*/)
   int numOfChips = geom->getNumberOfChips();
   QcInfoLogger::GetInstance() << "numOfChips = " << numOfChips << AliceO2::InfoLogger::InfoLogger::endm;
   setNChips(numOfChips);
+  buildChipGeometry();
+
+  // the full resolution hitmaps are only published for the selected chips
+  if (auto param = mCustomParameters.find("chipHitmaps"); param != mCustomParameters.end()) {
+    createChipHitmaps(param->second);
+  }
+  // the occupancy plots only need to visit the chips hit since the previous update, thus they can be updated often
+  if (auto param = mCustomParameters.find("occupancyUpdateFrequency"); param != mCustomParameters.end()) {
+    occUpdateFrequency = std::max(1, std::stoi(param->second));
+  }
 
   for (int i = 0; i < NError; i++) {
     pt[i] = new TPaveText(0.20, 0.80 - i * 0.05, 0.85, 0.85 - i * 0.05, "NDC");
@@ -150,8 +163,6 @@ void ITSRawTask::initialize(o2::framework::InitContext& /*ctx*/)
 
   bulb->SetFillColor(kRed);
   mTotalFileDone = 0;
-  TotalHisTime = 0;
-  mCounted = 0;
   mYellowed = 0;
 }
 
@@ -167,19 +178,7 @@ void ITSRawTask::startOfCycle()
 
 void ITSRawTask::monitorData(o2::framework::ProcessingContext& ctx)
 {
-  double eta, phi;
-  int lay, sta, ssta, mod, chip;
   UShort_t col = 0, row = 0, ChipID = 0;
-  std::chrono::time_point<std::chrono::high_resolution_clock> start;
-  std::chrono::time_point<std::chrono::high_resolution_clock> startLoop;
-  std::chrono::time_point<std::chrono::high_resolution_clock> end;
-  int difference;
-
-  start = std::chrono::high_resolution_clock::now();
-
-  ofstream timefout("HisTimeGlobal.dat", ios::app);
-
-  ofstream timefout2("HisTimeLoop.dat", ios::app);
 
   QcInfoLogger::GetInstance() << "BEEN HERE BRO" << AliceO2::InfoLogger::InfoLogger::endm;
 
@@ -220,138 +219,107 @@ void ITSRawTask::monitorData(o2::framework::ProcessingContext& ctx)
     }
   }
 
-  difference = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-  //	QcInfoLogger::GetInstance() << "Before Loop = " << difference/1000.0 << "s" <<  AliceO2::InfoLogger::InfoLogger::endm;
-  timefout << "Before Loop  = " << difference / 1000.0 << "s" << std::endl;
   int i = 0;
-  for (auto&& pixeldata : digits) {
-    startLoop = std::chrono::high_resolution_clock::now();
-
-    ChipID = pixeldata.getChipIndex();
-    col = pixeldata.getColumn();
-    row = pixeldata.getRow();
-    //    mNEvent = pixeldata.getROFrame();
-    mNEvent = events.get()[i].NEvent;
-    i++;
-    //cout << "Event Compare: " << NEvent << ", " << NEventPre << endl;
-
-    if (mNEvent % occUpdateFrequency == 0 && mNEvent > 0 && mNEvent != mNEventPre) {
-      updateOccupancyPlots(mNEventPre);
-      // cout << "Carried out, " << NEventPre << endl;
-    }
-
-    // cout << "NFrame = " << NEvent  << endl;
-    if (mCounted < mTotalCounted) {
-      end = std::chrono::high_resolution_clock::now();
-      difference = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startLoop).count();
-      //	QcInfoLogger::GetInstance() << "Before Geo = " << difference << "ns" <<  AliceO2::InfoLogger::InfoLogger::endm;
-      timefout2 << "Getting Value Time  = " << difference << "ns" << std::endl;
-    }
-
-    if (mNEvent % 1000000 == 0 && mNEvent > 0) {
-      QcInfoLogger::GetInstance() << "ChipID = " << ChipID << "  col = " << col << "  row = " << row << "  mNEvent = " << mNEvent << AliceO2::InfoLogger::InfoLogger::endm;
-    }
-    // wouldnt this update this update the text for every digit in events 1000, 2000 ... ?
-    if (mNEvent % 1000 == 0 || mNEventPre != mNEvent) {
-      ptNEvent->Clear();
-      ptNEvent->AddText(Form("Event Being Processed: %d", mNEvent));
-    }
-
-    if (mCounted < mTotalCounted) {
-      end = std::chrono::high_resolution_clock::now();
-      difference = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startLoop).count();
-      //	QcInfoLogger::GetInstance() << "Before Geo = " << difference << "ns" <<  AliceO2::InfoLogger::InfoLogger::endm;
-      timefout2 << "Before Geo  = " << difference << "ns" << std::endl;
-    }
-
-    gm->getChipId(ChipID, lay, sta, ssta, mod, chip);
-    // cout << "getID : " << ChipID << ", " << lay << ", " << sta << ", " << ssta << ", " << mod << ", " << chip << endl;
-    gm->fillMatrixCache(o2::utils::bit2Mask(o2::TransformType::L2G));
-    const Point3D<float> loc(0., 0., 0.);
-    auto glo = gm->getMatrixL2G(ChipID)(loc);
+  {
+    QC_TRACE_SCOPE("ITSRawTask::digits");
+    for (auto&& pixeldata : digits) {
+      ChipID = pixeldata.getChipIndex();
+      col = pixeldata.getColumn();
+      row = pixeldata.getRow();
+      //    mNEvent = pixeldata.getROFrame();
+      mNEvent = events.get()[i].NEvent;
+      i++;
+      //cout << "Event Compare: " << NEvent << ", " << NEventPre << endl;
+
+      if (mNEvent % occUpdateFrequency == 0 && mNEvent > 0 && mNEvent != mNEventPre) {
+        updateOccupancyPlots(mNEventPre);
+        // cout << "Carried out, " << NEventPre << endl;
+      }
 
-    if (!mlayerEnable[lay]) {
-      continue;
-    }
+      // cout << "NFrame = " << NEvent  << endl;
+      if (mNEvent % 1000000 == 0 && mNEvent > 0) {
+        QcInfoLogger::GetInstance() << "ChipID = " << ChipID << "  col = " << col << "  row = " << row << "  mNEvent = " << mNEvent << AliceO2::InfoLogger::InfoLogger::endm;
+      }
+      // wouldnt this update this update the text for every digit in events 1000, 2000 ... ?
+      if (mNEvent % 1000 == 0 || mNEventPre != mNEvent) {
+        ptNEvent->Clear();
+        ptNEvent->AddText(Form("Event Being Processed: %d", mNEvent));
+      }
 
-    if (mCounted < mTotalCounted) {
-      end = std::chrono::high_resolution_clock::now();
-      difference = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startLoop).count();
-      //	QcInfoLogger::GetInstance() << "After Geo = " << difference << "ns" <<  AliceO2::InfoLogger::InfoLogger::endm;
-      timefout2 << "After Geo =  " << difference << "ns" << std::endl;
-    }
+      if (ChipID >= mChipGeometry.size()) {
+        continue;
+      }
+      const ChipGeometry& geometry = mChipGeometry[ChipID];
+      int lay = geometry.layer;
+      if (!mlayerEnable[lay]) {
+        continue;
+      }
 
-    int hicCol, hicRow;
-    // Todo: check if chipID is really chip ID
-    getHicCoordinates(lay, chip, col, row, hicRow, hicCol);
-    //  if (lay == 0 && sta == 0 && ssta == 0 && mod == 0 && chip == 0) cout << ChipID << ", " << col << ", " << row << endl;
-    hHicHitmap[lay][sta][mod]->Fill(hicCol, hicRow);
-    if (lay > NLayerIB && chip > 6) {
-      // OB HICs: take into account that chip IDs are 0 .. 6, 8 .. 14
-      hChipHitmap[lay][sta][mod][chip - 1]->Fill(col, row);
-    } else {
-      hChipHitmap[lay][sta][mod][chip]->Fill(col, row);
+      int hicCol, hicRow;
+      // Todo: check if chipID is really chip ID
+      getHicCoordinates(lay, geometry.chip, col, row, hicRow, hicCol);
+      hHicHitmap[lay][geometry.stave][geometry.hic]->Fill(hicCol, hicRow);
+      mChipHitmaps.fill(ChipID, col, row);
       // hIBHitmap[lay]->Fill(hicCol, row+(sta*NRowHis));
-    }
-
-    if (mCounted < mTotalCounted) {
-      end = std::chrono::high_resolution_clock::now();
-      difference = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startLoop).count();
-      //	QcInfoLogger::GetInstance() << "After Geo = " << difference << "ns" <<  AliceO2::InfoLogger::InfoLogger::endm;
-      timefout2 << "Fill HitMaps =  " << difference << "ns" << std::endl;
-    }
-
-    if (mCounted < mTotalCounted) {
-      end = std::chrono::high_resolution_clock::now();
-      difference = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startLoop).count();
-      //	QcInfoLogger::GetInstance() << "After Geo = " << difference << "ns" <<  AliceO2::InfoLogger::InfoLogger::endm;
-      timefout2 << "Before glo etaphi =  " << difference << "ns" << std::endl;
-    }
-
-    eta = glo.eta();
-    phi = glo.phi();
-    hEtaPhiHitmap[lay]->Fill(eta, phi);
 
-    if (mCounted < mTotalCounted) {
-      end = std::chrono::high_resolution_clock::now();
-      difference = std::chrono::duration_cast<std::chrono::nanoseconds>(end - startLoop).count();
-      //	QcInfoLogger::GetInstance() << "After Geo = " << difference << "ns" <<  AliceO2::InfoLogger::InfoLogger::endm;
-      timefout2 << "After glo etaphi =  " << difference << "ns" << std::endl;
-      mCounted = mCounted + 1;
-    }
+      // the bin is incremented directly, the statistics are then computed from the bin contents
+      hEtaPhiHitmap[lay]->AddBinContent(geometry.etaPhiBin);
+      hEtaPhiHitmap[lay]->SetEntries(hEtaPhiHitmap[lay]->GetEntries() + 1);
 
-    mNEventPre = mNEvent;
+      mNEventPre = mNEvent;
 
-  } // end digits loop
+    } // end digits loop
+  }
   i = 0;
   if (mNEventPre > 0) {
     updateOccupancyPlots(mNEventPre);
   }
   //cout << "EndUpdateOcc " << NEventPre <<endl;
-  end = std::chrono::high_resolution_clock::now();
-  difference = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-  QcInfoLogger::GetInstance() << "Time After Loop = " << difference / 1000.0 << "s"
-                              << AliceO2::InfoLogger::InfoLogger::endm;
-  timefout << "Time After Loop = " << difference / 1000.0 << "s" << std::endl;
 
   QcInfoLogger::GetInstance() << "NEventDone = " << mNEvent << AliceO2::InfoLogger::InfoLogger::endm;
   QcInfoLogger::GetInstance() << "Test  " << AliceO2::InfoLogger::InfoLogger::endm;
 
   digits.clear();
 
-  end = std::chrono::high_resolution_clock::now();
-  difference = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
-  TotalHisTime = TotalHisTime + difference;
-  QcInfoLogger::GetInstance() << "Time in Histogram = " << difference / 1000.0 << "s"
-                              << AliceO2::InfoLogger::InfoLogger::endm;
-  timefout << "Time in Histogram = " << difference / 1000.0 << "s" << std::endl;
-
   if (mNEvent == 0 && ChipID == 0 && row == 0 && col == 0 && mYellowed == 0) {
     bulb->SetFillColor(kYellow);
     mYellowed = 1;
   }
 }
 
+// The chip position in the detector and its eta-phi bin are computed once per chip, such that the digits
+// are plotted without any geometry transformation
+void ITSRawTask::buildChipGeometry()
+{
+  int lay, sta, ssta, mod, chip;
+  const Point3D<float> loc(0., 0., 0.);
+
+  gm->fillMatrixCache(o2::utils::bit2Mask(o2::TransformType::L2G));
+  mChipGeometry.resize(gm->getNumberOfChips());
+  for (int iChip = 0; iChip < gm->getNumberOfChips(); iChip++) {
+    gm->getChipId(iChip, lay, sta, ssta, mod, chip);
+    ChipGeometry& geometry = mChipGeometry[iChip];
+    geometry.layer = lay;
+    geometry.stave = sta;
+    geometry.hic = mod;
+    geometry.chip = chip;
+    // OB HICs: take into account that chip IDs are 0 .. 6, 8 .. 14
+    geometry.hitmap = (lay > NLayerIB && chip > 6) ? chip - 1 : chip;
+    geometry.etaPhiBin = -1;
+    geometry.occupancyBin = -1;
+    if (mlayerEnable[lay]) {
+      auto glo = gm->getMatrixL2G(iChip)(loc);
+      geometry.etaPhiBin = hEtaPhiHitmap[lay]->FindFixBin(glo.eta(), glo.phi());
+      geometry.occupancyBin = hChipStaveOccupancy[lay]->FindFixBin(lay < NLayerIB ? geometry.hitmap : geometry.hic, sta);
+    }
+  }
+  for (int iLayer = 0; iLayer < NLayer; iLayer++) {
+    if (mlayerEnable[iLayer]) {
+      mChipStaveHits[iLayer].assign(hChipStaveOccupancy[iLayer]->GetNcells(), 0);
+    }
+  }
+}
+
 void ITSRawTask::addObject(TObject* aObject, bool published)
 {
   if (!aObject) {
@@ -428,7 +396,7 @@ void ITSRawTask::createLayerHistos(int aLayer)
   }
 */
   // HITMAPS per HIC, binning in groups of SizeReduce * SizeReduce pixels
-  // chipHitmap: fine binning, one hitmap per chip, but not to be saved to CCDB (only for determination of noisy pixels)
+  // chip hitmaps: fine binning, kept in mChipHitmaps and only published for the selected chips (see createChipHitmaps)
   for (int iStave = 0; iStave < NStaves[aLayer]; iStave++) {
     createStaveHistos(aLayer, iStave);
   }
@@ -491,20 +459,18 @@ void ITSRawTask::createStaveHistos(int aLayer, int aStave)
 void ITSRawTask::createHicHistos(int aLayer, int aStave, int aHic)
 {
   TString Name, Title;
-  int nBinsX, nBinsY, maxX, maxY, nChips;
+  int nBinsX, nBinsY, maxX, maxY;
 
   if (aLayer < NLayerIB) {
     Name = Form("Occupancy/Layer%d/Stave%d/Layer%dStave%dHITMAP", aLayer, aStave, aLayer, aStave);
     Title = Form("Hits on Layer %d, Stave %d", aLayer, aStave);
     maxX = 9 * NColHis;
     maxY = NRowHis;
-    nChips = 9;
   } else {
     Name = Form("Occupancy/Layer%d/Stave%d/HIC%d/Layer%dStave%dHIC%dHITMAP", aLayer, aStave, aHic, aLayer, aStave, aHic);
     Title = Form("Hits on Layer %d, Stave %d, Hic %d", aLayer, aStave, aHic);
     maxX = 7 * NColHis;
     maxY = 2 * NRowHis;
-    nChips = 14;
   }
   nBinsX = maxX / mSizeReduce;
   nBinsY = maxY / mSizeReduce;
@@ -516,11 +482,37 @@ void ITSRawTask::createHicHistos(int aLayer, int aStave, int aHic)
   hHicHitmap[aLayer][aStave][aHic]->GetXaxis()->SetNdivisions(-32);
   hHicHitmap[aLayer][aStave][aHic]->Draw("COLZ"); // should this really be drawn here?
   addObject(hHicHitmap[aLayer][aStave][aHic]);
+}
+
+// chipHitmap: fine binning, for the chips given as a comma-separated list of chip IDs
+void ITSRawTask::createChipHitmaps(const std::string& chipIDs)
+{
+  std::stringstream ss(chipIDs);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    if (token.find_first_not_of(" ") == std::string::npos) {
+      continue;
+    }
+    int chipID = std::stoi(token);
+    if (chipID < 0 || chipID >= (int)mChipGeometry.size() || !mlayerEnable[mChipGeometry[chipID].layer]) {
+      QcInfoLogger::GetInstance() << "No hitmap for the chip " << chipID << AliceO2::InfoLogger::InfoLogger::endm;
+      continue;
+    }
+    const ChipGeometry& geometry = mChipGeometry[chipID];
+    TH2I* h = new TH2I(Form("Occupancy/Layer%d/Stave%d/HIC%d/chipHitmapL%dS%dH%dC%d", geometry.layer, geometry.stave, geometry.hic, geometry.layer, geometry.stave, geometry.hic, geometry.chip),
+                       Form("Hits on Layer %d, Stave %d, Hic %d, Chip %d", geometry.layer, geometry.stave, geometry.hic, geometry.chip), NCols, -.5, NCols - .5, NRows, -.5, NRows - .5);
+    formatAxes(h, "Column", "Row", 1., 1.1);
+    h->GetZaxis()->SetTitle("Number of Hits");
+    addObject(h);
+    mPublishedChipHitmaps.emplace_back(chipID, h);
+  }
+}
 
-  for (int iChip = 0; iChip < nChips; iChip++) {
-    hChipHitmap[aLayer][aStave][aHic][iChip] = new TH2I(Form("chipHitmapL%dS%dH%dC%d", aLayer, aStave, aHic, iChip),
-                                                        Form("chipHitmapL%dS%dH%dC%d", aLayer, aStave, aHic, iChip), 1024, -.5, 1023.5, 512, -.5, 511.5);
-    addObject(hChipHitmap[aLayer][aStave][aHic][iChip], false);
+// the published chip hitmaps are only materialized from the hit counters at the end of the cycle
+void ITSRawTask::updateChipHitmaps()
+{
+  for (auto& [chipID, h] : mPublishedChipHitmaps) {
+    mChipHitmaps.fillHistogram(chipID, h);
   }
 }
 
@@ -672,6 +664,8 @@ void ITSRawTask::updateFile(int aRunID, int aEpID, int aFileID)
 void ITSRawTask::endOfCycle()
 {
   QcInfoLogger::GetInstance() << "endOfCycle" << AliceO2::InfoLogger::InfoLogger::endm;
+
+  updateChipHitmaps();
 }
 
 void ITSRawTask::endOfActivity(Activity& /*activity*/)
@@ -717,12 +711,14 @@ void ITSRawTask::resetHitmaps()
     for (int iStave = 0; iStave < NStaves[iLayer]; iStave++) {
       for (int iHic = 0; iHic < nHicPerStave[iLayer]; iHic++) {
         hHicHitmap[iLayer][iStave][iHic]->Reset();
-        for (int iChip = 0; iChip < nChipsPerHic[iLayer]; iChip++) {
-          hChipHitmap[iLayer][iStave][iHic][iChip]->Reset();
-        }
       }
     }
   }
+  mChipHitmaps.reset();
+  resetOccupancyCounters();
+  for (auto& chipHitmap : mPublishedChipHitmaps) {
+    chipHitmap.second->Reset();
+  }
 }
 
 // reset method for all histos that are to be reset regularly
@@ -738,40 +734,100 @@ void ITSRawTask::resetOccupancyPlots()
   }
 }
 
+void ITSRawTask::resetOccupancyCounters()
+{
+  std::fill(mChipHitsInOccupancy.begin(), mChipHitsInOccupancy.end(), 0);
+  for (auto& distribution : mChipHitsDistribution) {
+    distribution.clear();
+  }
+  for (int iLayer = 0; iLayer < NLayer; iLayer++) {
+    mPixelHitsDistribution[iLayer].clear();
+    std::fill(mChipStaveHits[iLayer].begin(), mChipStaveHits[iLayer].end(), 0);
+  }
+}
+
+// the counters of the chips which were not hit since the previous update are still valid
+void ITSRawTask::updateOccupancyCounters()
+{
+  std::vector<uint32_t> pixelHits;
+  for (int iChip : mChipHitmaps.getChangedChips()) {
+    const ChipGeometry& geometry = mChipGeometry[iChip];
+    int iLayer = geometry.layer;
+    if (!mlayerEnable[iLayer]) {
+      continue;
+    }
+    uint64_t chipHits = mChipHitmaps.getChipHits(iChip);
+    mChipStaveHits[iLayer][geometry.occupancyBin] += chipHits - mChipHitsInOccupancy[iChip];
+    mChipHitsInOccupancy[iChip] = chipHits;
+
+    // the previous contribution of the chip is replaced
+    auto& layerDistribution = mPixelHitsDistribution[iLayer];
+    auto& chipDistribution = mChipHitsDistribution[iChip];
+    for (auto& [hits, pixels] : chipDistribution) {
+      auto entry = layerDistribution.find(hits);
+      entry->second -= pixels;
+      if (entry->second == 0) {
+        layerDistribution.erase(entry);
+      }
+    }
+    pixelHits.clear();
+    mChipHitmaps.forEachPixel(iChip, [&](int /*col*/, int /*row*/, uint32_t hits) {
+      pixelHits.push_back(hits);
+    });
+    std::sort(pixelHits.begin(), pixelHits.end());
+    chipDistribution.clear();
+    for (uint32_t hits : pixelHits) {
+      if (chipDistribution.empty() || chipDistribution.back().first != hits) {
+        chipDistribution.emplace_back(hits, 0);
+      }
+      chipDistribution.back().second++;
+    }
+    for (auto& [hits, pixels] : chipDistribution) {
+      layerDistribution[hits] += pixels;
+    }
+  }
+  mChipHitmaps.clearChangedChips();
+}
+
 void ITSRawTask::updateOccupancyPlots(int nEvents)
 {
-  double pixelOccupancy, chipOccupancy;
+  QC_TRACE_SCOPE("ITSRawTask::updateOccupancyPlots");
 
+  updateOccupancyCounters();
   resetOccupancyPlots();
 
+  // the cost does not depend on the number of hit chips, only on the number of bins and of distinct pixel counts
   for (int iLayer = 0; iLayer < NLayer; iLayer++) {
     if (!mlayerEnable[iLayer]) {
       continue;
     }
-    //hEtaPhiHitmap[iLayer]->Reset();
-    for (int iStave = 0; iStave < NStaves[iLayer]; iStave++) {
-      for (int iHic = 0; iHic < nHicPerStave[iLayer]; iHic++) {
-        for (int iChip = 0; iChip < nChipsPerHic[iLayer]; iChip++) {
-          chipOccupancy = hChipHitmap[iLayer][iStave][iHic][iChip]->Integral();
-          chipOccupancy = chipOccupancy / ((double)nEvents * (double)NPixels);
-          // cout << "chipOcc = " << hChipHitmap[iLayer][iStave][iHic][iChip]->Integral() << ", " << iLayer << ", " << iStave << ", " << iHic << ", " << iChip << endl;
-          if (iLayer < NLayerIB) {
-            hChipStaveOccupancy[iLayer]->Fill(iChip, iStave, chipOccupancy);
-          } else {
-            hChipStaveOccupancy[iLayer]->Fill(iHic, iStave, chipOccupancy / nChipsPerHic[iLayer]);
-          }
-          for (int iCol = 0; iCol < NCols; iCol++) {
-            for (int iRow = 0; iRow < NRows; iRow++) {
-              pixelOccupancy = hChipHitmap[iLayer][iStave][iHic][iChip]->GetBinContent(iCol + 1, iRow + 1);
-              if (pixelOccupancy > 0) {
-                pixelOccupancy /= (double)nEvents;
-                hOccupancyPlot[iLayer]->Fill(log10(pixelOccupancy));
-              }
-            }
-          }
-        }
+    double chipPixels = (double)NPixels * (iLayer < NLayerIB ? 1 : nChipsPerHic[iLayer]);
+    for (size_t bin = 0; bin < mChipStaveHits[iLayer].size(); bin++) {
+      if (mChipStaveHits[iLayer][bin] > 0) {
+        hChipStaveOccupancy[iLayer]->SetBinContent(bin, mChipStaveHits[iLayer][bin] / ((double)nEvents * chipPixels));
+      }
+    }
+    hChipStaveOccupancy[iLayer]->SetEntries(ChipBoundary[iLayer + 1] - ChipBoundary[iLayer]);
+
+    // the pixels with the same number of hits are added as many unweighted entries, such that the plot keeps
+    // the Poisson errors and the statistics of the per-pixel fills, without the Sumw2 of a weighted fill
+    uint64_t firedPixels = 0;
+    double stats[4] = { 0, 0, 0, 0 }; // sum of weights, of squared weights, of weighted x and x^2
+    TAxis* axis = hOccupancyPlot[iLayer]->GetXaxis();
+    for (auto& [hits, pixels] : mPixelHitsDistribution[iLayer]) {
+      double occupancy = log10(hits / (double)nEvents);
+      int bin = axis->FindBin(occupancy);
+      hOccupancyPlot[iLayer]->AddBinContent(bin, pixels);
+      if (bin >= 1 && bin <= axis->GetNbins()) {
+        stats[0] += pixels;
+        stats[1] += pixels;
+        stats[2] += pixels * occupancy;
+        stats[3] += pixels * occupancy * occupancy;
       }
+      firedPixels += pixels;
     }
+    hOccupancyPlot[iLayer]->PutStats(stats);
+    hOccupancyPlot[iLayer]->SetEntries(firedPixels);
   }
 }
 
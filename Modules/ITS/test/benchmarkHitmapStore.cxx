@@ -0,0 +1,70 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkHitmapStore.cxx
+///
+
+#include "ITS/HitmapStore.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace o2::quality_control_modules::its;
+
+// Memory and time used by the chip hitmaps of the whole ITS, compared to one dense array of counters per chip
+// as used by the TH2I of the full resolution hitmaps. A few chips are noisy, the other ones have a low occupancy.
+int main(int argc, char** argv)
+{
+  const int nChips = 24120, nCols = 1024, nRows = 512;
+  size_t nHits = (argc > 1) ? std::stoul(argv[1]) : 20000000;
+  int nNoisyChips = (argc > 2) ? std::stoi(argv[2]) : 10;
+
+  std::mt19937 generator(1234);
+  std::vector<uint32_t> chips(nHits), pixels(nHits);
+  for (size_t i = 0; i < nHits; i++) {
+    // half of the hits are in the noisy chips
+    chips[i] = (i % 2 == 0 && nNoisyChips > 0) ? generator() % nNoisyChips : generator() % nChips;
+    pixels[i] = generator() % (nCols * nRows);
+  }
+
+  HitmapStore store(nChips, nCols, nRows);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < nHits; i++) {
+    store.fill(chips[i], pixels[i] % nCols, pixels[i] / nCols);
+  }
+  std::chrono::duration<double, std::nano> fillTime = std::chrono::steady_clock::now() - start;
+
+  // the occupancy distribution visits all the pixels which were hit
+  double sum = 0;
+  start = std::chrono::steady_clock::now();
+  for (int chip = 0; chip < nChips; chip++) {
+    store.forEachPixel(chip, [&](int, int, uint32_t hits) { sum += std::log10(hits); });
+  }
+  std::chrono::duration<double, std::milli> scanTime = std::chrono::steady_clock::now() - start;
+
+  int nDense = 0;
+  for (int chip = 0; chip < nChips; chip++) {
+    nDense += store.isDense(chip);
+  }
+  double denseMemory = (double)nChips * (nCols + 2) * (nRows + 2) * sizeof(int);
+
+  printf("%zu hits in %d chips, %d noisy chips\n", nHits, nChips, nNoisyChips);
+  printf("%-32s %12.1f\n", "fill (ns/hit)", fillTime.count() / nHits);
+  printf("%-32s %12.1f (%g)\n", "occupancy scan (ms)", scanTime.count(), sum);
+  printf("%-32s %12d\n", "dense chips", nDense);
+  printf("%-32s %12.1f\n", "memory (MB)", store.getMemoryUsage() / 1e6);
+  printf("%-32s %12.1f\n", "memory of dense hitmaps (MB)", denseMemory / 1e6);
+  return 0;
+}
@@ -0,0 +1,105 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testHitmapStore.cxx
+///
+
+#include "ITS/HitmapStore.h"
+
+#define BOOST_TEST_MODULE HitmapStore test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <map>
+#include <random>
+#include <tuple>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace its
+{
+
+BOOST_AUTO_TEST_CASE(hitmap_store_counts)
+{
+  const int nChips = 10, nCols = 1024, nRows = 512;
+  HitmapStore store(nChips, nCols, nRows, 2000);
+  std::map<std::tuple<int, int, int>, uint32_t> reference;
+  std::vector<uint64_t> chipHits(nChips, 0);
+
+  std::mt19937 generator(1234);
+  for (int i = 0; i < 200000; i++) {
+    // chip 0 is hot, the other ones have a few pixels hit many times, in the same columns
+    int chip = (i % 2 == 0) ? 0 : 1 + generator() % (nChips - 1);
+    int col = (chip == 0) ? generator() % nCols : 8 * (generator() % 4);
+    int row = (chip == 0) ? generator() % nRows : generator() % 64;
+    store.fill(chip, col, row);
+    reference[{ chip, col, row }]++;
+    chipHits[chip]++;
+  }
+
+  BOOST_CHECK(store.isDense(0));
+  for (int chip = 1; chip < nChips; chip++) {
+    BOOST_CHECK(!store.isDense(chip));
+  }
+
+  for (int chip = 0; chip < nChips; chip++) {
+    BOOST_CHECK_EQUAL(store.getChipHits(chip), chipHits[chip]);
+    uint32_t nFired = 0;
+    uint64_t nHits = 0;
+    store.forEachPixel(chip, [&](int col, int row, uint32_t hits) {
+      nFired++;
+      nHits += hits;
+      BOOST_CHECK_EQUAL(hits, (reference[{ chip, col, row }]));
+    });
+    BOOST_CHECK_EQUAL(nHits, chipHits[chip]);
+    BOOST_CHECK_EQUAL(nFired, store.getNumberOfFiredPixels(chip));
+  }
+  for (auto& [pixel, hits] : reference) {
+    BOOST_CHECK_EQUAL(store.getPixelHits(std::get<0>(pixel), std::get<1>(pixel), std::get<2>(pixel)), hits);
+  }
+  BOOST_CHECK_EQUAL(store.getPixelHits(1, 1, 0), 0);
+
+  store.reset();
+  for (int chip = 0; chip < nChips; chip++) {
+    BOOST_CHECK_EQUAL(store.getChipHits(chip), 0);
+    BOOST_CHECK(!store.isDense(chip));
+  }
+  BOOST_CHECK_EQUAL(store.getPixelHits(0, 0, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(hitmap_store_changed_chips)
+{
+  HitmapStore store(10);
+  BOOST_CHECK(store.getChangedChips().empty());
+
+  store.fill(3, 0, 0);
+  store.fill(7, 1, 1);
+  store.fill(3, 2, 2);
+  BOOST_CHECK(store.getChangedChips() == std::vector<int>({ 3, 7 }));
+
+  store.clearChangedChips();
+  BOOST_CHECK(store.getChangedChips().empty());
+  store.fill(7, 1, 1);
+  BOOST_CHECK(store.getChangedChips() == std::vector<int>({ 7 }));
+  BOOST_CHECK_EQUAL(store.getChipHits(7), 2);
+
+  store.reset();
+  BOOST_CHECK(store.getChangedChips().empty());
+  store.fill(7, 1, 1);
+  BOOST_CHECK(store.getChangedChips() == std::vector<int>({ 7 }));
+}
+
+} // namespace its
+} // namespace quality_control_modules
+} // namespace o2
@@ -0,0 +1,72 @@
+///
+/// \file   DERegistry.h
+///
+
+#ifndef QC_MODULE_MUONCHAMBERS_DEREGISTRY_H
+#define QC_MODULE_MUONCHAMBERS_DEREGISTRY_H
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "MCH/Mapping.h"
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+/// \brief Objects associated to the MCH detection elements, stored in a dense array
+///
+/// The detection element IDs are translated into a compact index through a lookup table, and the objects
+/// are stored contiguously in the order in which the detection elements were added. Finding the object
+/// of a detection element is thus a couple of array accesses, and looping over all of them is cache-friendly.
+template <class T>
+class DERegistry
+{
+ public:
+  DERegistry() { mIndex.fill(-1); }
+
+  /// \brief Object of the detection element, which is added with a default value if needed
+  T& operator[](int de)
+  {
+    int index = getIndex(de);
+    if (index < 0) {
+      index = mDEs.size();
+      mIndex.at(de) = index;
+      mDEs.push_back(de);
+      mObjects.emplace_back();
+    }
+    return mObjects[index];
+  }
+
+  /// \brief Object of the detection element, nullptr if the detection element was not added
+  T* find(int de) { return (getIndex(de) < 0) ? nullptr : &mObjects[getIndex(de)]; }
+  const T* find(int de) const { return (getIndex(de) < 0) ? nullptr : &mObjects[getIndex(de)]; }
+
+  /// \brief Compact index of the detection element, -1 if it was not added
+  int getIndex(int de) const { return (de >= 0 && de < MCH_DE_MAX) ? mIndex[de] : -1; }
+
+  size_t size() const { return mDEs.size(); }
+  int getDE(size_t index) const { return mDEs[index]; }
+  T& at(size_t index) { return mObjects[index]; }
+  const T& at(size_t index) const { return mObjects[index]; }
+
+  /// \brief Detection elements and objects, in the same order
+  const std::vector<int>& getDEs() const { return mDEs; }
+  std::vector<T>& getObjects() { return mObjects; }
+  const std::vector<T>& getObjects() const { return mObjects; }
+
+ private:
+  std::array<int16_t, MCH_DE_MAX> mIndex;
+  std::vector<int> mDEs;
+  std::vector<T> mObjects;
+};
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
+
+#endif // QC_MODULE_MUONCHAMBERS_DEREGISTRY_H
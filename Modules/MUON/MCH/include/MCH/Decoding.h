@@ -11,6 +11,9 @@
 #include "MCH/Mapping.h"
 #include "MCHBase/Digit.h"
 
+#include <cstdio>
+#include <vector>
+
 using namespace o2::quality_control::core;
 
 namespace o2
@@ -35,7 +38,7 @@ struct SampaHit {
   uint8_t cru_id, fee_id, data_path, link_id, ds_addr, chan_addr;
   int64_t bxc;
   uint32_t size, time;
-  std::vector<uint16_t> samples;
+  uint32_t sampleOffset, nSamples; // position of the samples in the samples of all the hits
   uint64_t csum;
   int32_t delta;
   MapPad pad;
@@ -60,12 +63,33 @@ struct DualSampa {
   double pedestal[2][32], noise[2][32];
   int32_t min[2][32], max[2][32], delta[2][32];
   SampaHit hit;
+  std::vector<uint16_t> samples; // samples of the hit being read
 };
 
 struct DualSampaGroup {
   long int bxc;
 };
 
+/// \brief Logging settings and error counters of the decoding
+///
+/// Each decoding thread has its own context, so that the decoding does not rely on any global state.
+struct DecodingContext {
+  int printLevel = 0;  // verbosity of the decoding messages
+  int pattern = 0;     // expected data pattern, not checked if 0
+  FILE* log = stdout;  // destination of the decoding messages
+  int nbErrors = 0;
+  int nbWarnings = 0;
+};
+
+/// \brief Parity of the 50 bits of a SAMPA header
+int CheckDataParity(uint64_t data);
+/// \brief Hamming check of a SAMPA header, split in 30 + 20 bits
+void HammingDecode(unsigned int buffer[2], bool& error, bool& uncorrectable, bool fix_data);
+/// \brief Equivalent of CheckDataParity(), counting the bits of the header at once
+int FastCheckDataParity(uint64_t data);
+/// \brief Equivalent of HammingDecode(), with the parities computed on masked words and the correction taken from a table
+void FastHammingDecode(uint64_t& header, bool& error, bool& uncorrectable, bool fix_data);
+
 /// \brief decoding of MCH data
 /// \author Andrea Ferrero
 class Decoder
@@ -79,11 +103,26 @@ class Decoder
   // Definition of the methods for the template method pattern
   void initialize();
   void processData(const char* buf, size_t size);
+  /// \brief Bit-serial decoding of the GBT words, used as a reference for decodeRawWords()
   void decodeRaw(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id);
+  /// \brief Word-level decoding of the GBT words, several bits of each dual SAMPA board are processed at once
+  void decodeRawWords(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id);
+  /// \brief Selects the bit-serial decoder instead of the word-level one in processData()
+  void setBitSerialDecoding(bool bitSerial) { mBitSerialDecoding = bitSerial; }
+  /// \brief Number of threads decoding the pages of different links in processData(), 1 to decode them serially
+  ///
+  /// With more than one thread the hits are ordered by link instead of by page.
+  void setNumberOfThreads(int nThreads) { mNThreads = nThreads; }
+  void setPrintLevel(int printLevel) { mContext.printLevel = printLevel; }
+  int getNbErrors() const { return mContext.nbErrors; }
+  int getNbWarnings() const { return mContext.nbWarnings; }
   void decodeUL(uint32_t* payload_buf, size_t nWords, int cru_id, int dpw_id);
   void clearHits();
   void clearDigits();
   std::vector<SampaHit>& getHits() { return mHits; }
+  /// \brief Samples of all the hits, each hit refers to a contiguous range of them
+  std::vector<uint16_t>& getSamples() { return mSamples; }
+  const uint16_t* getHitSamples(const SampaHit& hit) const { return mSamples.data() + hit.sampleOffset; }
   std::vector<o2::mch::Digit>& getDigits() { return mDigits; }
   void reset();
 
@@ -97,15 +136,27 @@ class Decoder
   MapFEC& getMapFEC() { return mMapFEC; }
 
  private:
+  void decodeRaw(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples);
+  void decodeRawWords(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples);
+  void decodeUL(uint32_t* payload_buf, size_t nWords, int cru_id, int dpw_id, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples);
+  void resetLink(int cru_id, int link_id, DecodingContext& ctx);
+  void processHits(std::vector<SampaHit>& hits, size_t firstHit, std::vector<o2::mch::Digit>& digits);
+
   int hb_orbit;
   DualSampa ds[MCH_MAX_CRU_ID][24][40];
   DualSampaGroup dsg[MCH_MAX_CRU_ID][24][8];
   int ds_enable[MCH_MAX_CRU_IN_FLP][24][40];
   std::vector<SampaHit> mHits;
+  std::vector<uint16_t> mSamples;
+  size_t mNHitsLastBuffer = 0;
+  size_t mNSamplesLastBuffer = 0;
   std::vector<o2::mch::Digit> mDigits;
   int nFrames;
   MapCRU mMapCRU;
   MapFEC mMapFEC;
+  bool mBitSerialDecoding = false;
+  int mNThreads = 1;
+  DecodingContext mContext;
 };
 
 } // namespace muonchambers
@@ -8,9 +8,13 @@
 #ifndef QC_MODULE_MUONCHAMBERS_GLOBALHISTOGRAM_H
 #define QC_MODULE_MUONCHAMBERS_GLOBALHISTOGRAM_H
 
-#include <map>
+#include <cstdint>
+#include <utility>
+#include <vector>
 #include <TH2.h>
 
+#include "MCH/DERegistry.h"
+
 namespace o2
 {
 namespace quality_control_modules
@@ -20,22 +24,64 @@ namespace muonchambers
 
 class GlobalHistogram: public TH2F
 {
-  int getLR(int de);
-  void getDeCenter(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
-  void getDeCenterST3(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
-  void getDeCenterST4(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
-  void getDeCenterST5(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
-  
+  /// \brief Position of one detection element in the global histogram
+  struct DEGeometry {
+    float xB0, yB0, xNB0, yNB0;
+    bool swapX;
+    std::vector<std::pair<double, double>> envelope; // vertices of the contour of the bending plane
+  };
+
+  /// \brief Bins of one plane of a detection element which are summed or averaged into each global bin
+  struct BinMapping {
+    // binning of the source histogram
+    int nBinsX = 0, nBinsY = 0;
+    double xMin = 0, xMax = 0, yMin = 0, yMax = 0;
+    std::vector<int> bins;          // global bins
+    std::vector<uint32_t> offsets;  // position of the source bins of each global bin, plus the total number
+    std::vector<int> sourceBins;
+
+    bool matches(TH2F* source) const;
+  };
+
+  /// \brief Mappings of one detection element, and state of its source histograms at the last update
+  struct DEState {
+    BinMapping mapping[2];
+    TH2F* source[2] = { nullptr, nullptr };
+    double entries[2] = { -1, -1 };
+    bool doAverage = false;
+  };
+
+  static int getLR(int de);
+  static void getDeCenter(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
+  static void getDeCenterST3(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
+  static void getDeCenterST4(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
+  static void getDeCenterST5(int de, float& xB0, float& yB0, float& xNB0, float& yNB0);
+
+  /// \brief Positions of the detection elements, computed from the segmentation once for all the histograms
+  static const DERegistry<DEGeometry>& getGeometry();
+
+  void buildMapping(BinMapping& mapping, TH2F* source, float x0, float y0, bool swapX);
+
+  DERegistry<DEState> mDEStates;
+  bool mIncremental = false;
+
 public:
   GlobalHistogram(std::string name, std::string title);
   
   void init();
 
+  /// \brief Only update the detection elements whose histograms changed since the last call to add() or set()
+  ///
+  /// A source histogram is considered unchanged if it is the same object with the same number of entries, which
+  /// holds for all the changes done with Fill(), SetBinContent() and Reset(). The mode must not be used if the
+  /// contents of the global histogram are modified between the updates, like when dividing it by another one.
+  void setIncremental(bool incremental) { mIncremental = incremental; }
+
   // add the histograms of the individual detection elements
-  void add(std::map<int, TH2F*>& histB, std::map<int, TH2F*>& histNB);
+  void add(DERegistry<TH2F*>& histB, DERegistry<TH2F*>& histNB);
 
   // replace the contents with the histograms of the individual detection elements
-  void set(std::map<int, TH2F*>& histB, std::map<int, TH2F*>& histNB, bool doAverage=true);
+  void set(DERegistry<TH2F*>& histB, DERegistry<TH2F*>& histNB, bool doAverage=true);
 };
 
 } // namespace muonchambers
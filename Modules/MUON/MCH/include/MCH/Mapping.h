@@ -65,6 +65,7 @@ class MapPad
 
 class MapCRU
 {
+  friend class MappingCache;
 
   MapSolar mSolarMap[MCH_MAX_CRU_IN_FLP][24];
 
@@ -76,6 +77,7 @@ class MapCRU
 
 class MapFEC
 {
+  friend class MappingCache;
 
   MapDualSampa mDsMap[LINKID_MAX + 1][40];
 
@@ -87,6 +89,50 @@ class MapFEC
   bool getPadByDE(uint32_t de, uint32_t dsis, uint32_t dsch, MapPad& pad);
 };
 
+/// \brief Binary image of the CRU and FEC mappings
+///
+/// The image is generated from the text mapping files the first time they are read, and memory-mapped
+/// by the following initializations instead of parsing the text files again. It is versioned and checksummed,
+/// and it records the size and modification time of the text files, so that it is regenerated when they change.
+/// If the text files are not present, the image is used as it is.
+class MappingCache
+{
+ public:
+  static constexpr uint32_t sVersion = 1;
+
+  /// Fills the mappings from the image if it is valid, otherwise from the text files, regenerating the image
+  static bool load(std::string cruMapFile, std::string fecMapFile, std::string cacheFile, MapCRU& mapCRU, MapFEC& mapFEC);
+  /// Fills the mappings from the image, returns false if it is missing, corrupted or out of date
+  static bool read(std::string cruMapFile, std::string fecMapFile, std::string cacheFile, MapCRU& mapCRU, MapFEC& mapFEC);
+  /// Writes the image of the mappings read from the text files
+  static bool write(std::string cruMapFile, std::string fecMapFile, std::string cacheFile, const MapCRU& mapCRU, const MapFEC& mapFEC);
+
+ private:
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t nLinks;   // entries of the CRU mapping
+    uint32_t nBoards;  // entries of the FEC mapping
+    uint32_t checksum; // of the entries
+    int64_t sourceSize[2];
+    int64_t sourceTime[2];
+  };
+  struct LinkEntry {
+    uint8_t cru;
+    uint8_t link;
+    uint16_t link_id;
+  };
+  struct BoardEntry {
+    uint16_t link_id;
+    uint16_t ds_addr;
+    uint16_t de;
+    uint16_t dsid;
+  };
+
+  static void fillSourceInfo(std::string cruMapFile, std::string fecMapFile, Header& header);
+  static uint32_t checksum(const char* data, size_t size);
+};
+
 } // namespace muonchambers
 } // namespace quality_control_modules
 } // namespace o2
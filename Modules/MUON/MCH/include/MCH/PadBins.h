@@ -0,0 +1,49 @@
+///
+/// \file   PadBins.h
+///
+
+#ifndef QC_MODULE_MUONCHAMBERS_PADBINS_H
+#define QC_MODULE_MUONCHAMBERS_PADBINS_H
+
+#include <cstdint>
+#include <vector>
+
+class TH2;
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+/// \brief Histogram bins covered by each pad of one detection element
+///
+/// The table is computed once from the binning of a reference XY histogram, such that the pads can be plotted
+/// without querying the segmentation and searching the bins for each hit. It is valid for all the histograms
+/// of the detection element which have the same binning as the reference one.
+class PadBins
+{
+ public:
+  /// \brief Computes the bins of all the pads of the detection element, returns false if it is not in the mapping
+  bool init(int de, TH2* reference);
+
+  int getNumberOfPads() const { return static_cast<int>(mCathodes.size()); }
+  /// \brief Cathode of the pad, 0 for bending and 1 for non-bending, -1 if the pad does not exist
+  int getCathode(int padid) const { return (padid >= 0 && padid < getNumberOfPads()) ? mCathodes[padid] : -1; }
+
+  /// \brief Global bin numbers (see TH1::GetBin) covered by the pad, the pad must exist
+  const int* begin(int padid) const { return mBins.data() + mOffsets[padid]; }
+  const int* end(int padid) const { return mBins.data() + mOffsets[padid + 1]; }
+
+ private:
+  std::vector<uint32_t> mOffsets; // position of the bins of each pad, plus the total number of bins
+  std::vector<int> mBins;
+  std::vector<int8_t> mCathodes;
+};
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
+
+#endif // QC_MODULE_MUONCHAMBERS_PADBINS_H
@@ -0,0 +1,48 @@
+///
+/// \file   PadGeometry.h
+///
+
+#ifndef QC_MODULE_MUONCHAMBERS_PADGEOMETRY_H
+#define QC_MODULE_MUONCHAMBERS_PADGEOMETRY_H
+
+#include <cstdint>
+#include <vector>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+/// \brief Position, size and cathode of the pads of one detection element
+///
+/// The values are copied once from the segmentation into a flat table indexed by the pad ID, which can be
+/// read concurrently by several threads.
+class PadGeometry
+{
+ public:
+  struct Pad {
+    float x;     // position of the center (cm)
+    float y;     // position of the center (cm)
+    float sizeX; // cm
+    float sizeY; // cm
+    int cathode; // 0 for bending and 1 for non-bending
+  };
+
+  /// \brief Copies the geometry of all the pads of the detection element, returns false if it is not in the mapping
+  bool init(int de);
+
+  int getNumberOfPads() const { return static_cast<int>(mPads.size()); }
+  /// \brief Geometry of the pad, nullptr if the pad does not exist
+  const Pad* find(int padid) const { return (padid >= 0 && padid < getNumberOfPads()) ? &mPads[padid] : nullptr; }
+
+ private:
+  std::vector<Pad> mPads;
+};
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
+
+#endif // QC_MODULE_MUONCHAMBERS_PADGEOMETRY_H
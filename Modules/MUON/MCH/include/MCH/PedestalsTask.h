@@ -6,11 +6,17 @@
 #ifndef QC_MODULE_MUONCHAMBERS_PEDESTALSTASK_H
 #define QC_MODULE_MUONCHAMBERS_PEDESTALSTASK_H
 
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
 #include "QualityControl/TaskInterface.h"
 #include "MCH/Mapping.h"
 #include "MCH/Decoding.h"
 #include "MCHBase/Digit.h"
 #include "MCH/GlobalHistogram.h"
+#include "MCH/PadBins.h"
+#include "MCH/DERegistry.h"
 
 class TH1F;
 class TH2F;
@@ -20,6 +26,32 @@ using namespace o2::quality_control::core;
 namespace o2::quality_control_modules::muonchambers
 {
 
+/// \brief Running pedestal and noise of a set of channels, in structure-of-arrays layout
+///
+/// The mean of the samples and the sum of their squared deviations from the mean are updated with
+/// Welford's algorithm, merging all the samples of a hit at once. The 32-bit overloads accept the
+/// digit amplitudes, which do not fit in the 10-bit SAMPA samples.
+struct PedestalAccumulators {
+  std::vector<uint64_t> nSamples;
+  std::vector<double> mean;
+  std::vector<double> m2;
+
+  size_t size() const { return nSamples.size(); }
+  /// \brief Adds a channel without samples, returns its index
+  size_t addChannel();
+  void update(size_t index, const uint16_t* samples, uint32_t n);
+  void update(size_t index, const uint32_t* samples, uint32_t n);
+  void update(size_t index, uint16_t sample) { update(index, &sample, 1); }
+  void update(size_t index, uint32_t sample) { update(index, &sample, 1); }
+
+  double getPedestal(size_t index) const { return mean[index]; }
+  double getNoise(size_t index) const { return (nSamples[index] > 0) ? std::sqrt(m2[index] / nSamples[index]) : 0; }
+
+ private:
+  /// \brief Merges n samples, given by their sum and sum of squares, with the previous samples of the channel
+  void merge(size_t index, uint32_t n, uint64_t sum, uint64_t sum2);
+};
+
 /// \brief Quality Control Task for the analysis of MCH pedestal data
 /// \author Andrea Ferrero
 /// \author Sebastien Perrin
@@ -43,16 +75,31 @@ class PedestalsTask final : public TaskInterface
   void reset() override;
 
  private:
+  /// \brief Electronics channel which received data, with the histogram bins where it is plotted
+  struct ElecChannel {
+    int xbin, ybin; // bins of the electronics view
+    int de, dsid, chan_addr;
+    int padid, cathode;
+  };
+  /// \brief Pad which received digits
+  struct DigitPad {
+    int de, padid, cathode;
+  };
+
   Decoder mDecoder;
-  uint64_t nhits[MCH_MAX_CRU_IN_FLP][24][40][64];
-  double pedestal[MCH_MAX_CRU_IN_FLP][24][40][64];
-  double noise[MCH_MAX_CRU_IN_FLP][24][40][64];
 
-  //Matrices [de][padid], stated an upper value for de# and padid#
+  // the accumulators only contain the channels which received data, the index of a channel is
+  // looked up from its electronics address or from its DE and pad ID, -1 if it has no data yet
+  std::vector<int32_t> mElecChannelIndex;
+  std::vector<ElecChannel> mElecChannels;
+  PedestalAccumulators mElecPedestals;
 
-  uint64_t nhitsDigits[1100][1500];
-  double pedestalDigits[1100][1500];
-  double noiseDigits[1100][1500];
+  //upper values for de# and padid#
+  static constexpr int sMaxDigitDE = 1100;
+  static constexpr int sMaxDigitPadID = 1500;
+  std::vector<int32_t> mDigitPadIndex;
+  std::vector<DigitPad> mDigitPads;
+  PedestalAccumulators mDigitPedestals;
 
   MapCRU mMapCRU[MCH_MAX_CRU_IN_FLP];
   TH2F* mHistogramPedestals;
@@ -60,19 +107,21 @@ class PedestalsTask final : public TaskInterface
 
   std::vector<int> DEs;
   //MapFEC mMapFEC;
-  std::map<int, TH2F*> mHistogramPedestalsDE;
-  std::map<int, TH2F*> mHistogramNoiseDE;
-  std::map<int, TH1F*> mHistogramDeltaDE[2];
-  std::map<int, TH2F*> mHistogramPedestalsXY[2];
-  std::map<int, TH2F*> mHistogramNoiseXY[2];
+  DERegistry<TH2F*> mHistogramPedestalsDE;
+  DERegistry<TH2F*> mHistogramNoiseDE;
+  DERegistry<TH1F*> mHistogramDeltaDE[2];
+  DERegistry<TH2F*> mHistogramPedestalsXY[2];
+  DERegistry<TH2F*> mHistogramNoiseXY[2];
+  DERegistry<PadBins> mPadBins; // bins of the XY histograms covered by each pad
 
-  std::map<int, TH1F*> mHistogramNoiseDistributionDE[5][2];
+  DERegistry<TH1F*> mHistogramNoiseDistributionDE[5][2];
 
   GlobalHistogram* mHistogramPedestalsMCH;
   GlobalHistogram* mHistogramNoiseMCH;
 
   int mPrintLevel;
 
+  void fill_histograms();
   void fill_noise_distributions();
   void save_histograms();
 };
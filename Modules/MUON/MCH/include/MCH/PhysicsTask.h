@@ -14,6 +14,9 @@
 #include "MCH/Mapping.h"
 #include "MCH/Decoding.h"
 #include "MCH/GlobalHistogram.h"
+#include "MCH/PadBins.h"
+#include "MCH/PadGeometry.h"
+#include "MCH/DERegistry.h"
 #include "MCHBase/Digit.h"
 #include "MCHBase/PreCluster.h"
 
@@ -56,11 +59,29 @@ class PhysicsTask /*final*/ : public TaskInterface // todo add back the "final"
   void storeDigits(void* bufferPtr);
 
   void plotDigit(const o2::mch::Digit& digit);
-  bool plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::span<const o2::mch::Digit> digits);
   void checkPreclusters(gsl::span<const o2::mch::PreCluster> preClusters, gsl::span<const o2::mch::Digit> digits);
   void printPreclusters(gsl::span<const o2::mch::PreCluster> preClusters, gsl::span<const o2::mch::Digit> digits);
 
  private:
+  /// \brief Histogram fills of the preclusters analysed by one thread, which are merged at the end of the cycle
+  struct PreclusterFills {
+    struct Charge {
+      int de;
+      float charge;
+    };
+    struct XY {
+      int de;
+      int histogram; // index in mHistogramPreclustersXY
+      double x;
+      double y;
+    };
+    std::vector<Charge> charges;
+    std::vector<XY> positions;
+  };
+
+  bool plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::span<const o2::mch::Digit> digits, PreclusterFills& fills) const;
+  void fillPreclusterHistograms();
+
   int count;
   Decoder mDecoder;
   uint64_t nhits[24][40][64];
@@ -73,15 +94,19 @@ class PhysicsTask /*final*/ : public TaskInterface // todo add back the "final"
   TH1F* mHistogramADCamplitude[72];
   TH2F* mHistogramADCamplitudeVsSize;
   std::vector<int> DEs;
-  std::map<int, TH1F*> mHistogramADCamplitudeDE;
-  std::map<int, TH2F*> mHistogramNhitsDE;
-  std::map<int, TH2F*> mHistogramNhitsHighAmplDE;
-
-  std::map<int, TH1F*> mHistogramClchgDE;
-  std::map<int, TH1F*> mHistogramClsizeDE;
-
-  std::map<int, TH2F*> mHistogramPreclustersXY[4];
-  std::map<int, TH2F*> mHistogramPseudoeffXY[3];
+  DERegistry<TH1F*> mHistogramADCamplitudeDE;
+  DERegistry<TH2F*> mHistogramNhitsDE;
+  DERegistry<TH2F*> mHistogramNhitsHighAmplDE;
+  DERegistry<PadBins> mPadBins; // bins of the Nhits histograms covered by each pad
+
+  DERegistry<TH1F*> mHistogramClchgDE;
+  DERegistry<TH1F*> mHistogramClsizeDE;
+
+  DERegistry<TH2F*> mHistogramPreclustersXY[4];
+  DERegistry<TH2F*> mHistogramPseudoeffXY[3];
+  DERegistry<PadGeometry> mPadGeometry;
+  int mPreclusterThreads = 1;
+  std::vector<PreclusterFills> mPreclusterFills; // one per thread
   TRandom3 rnd;
 
   GlobalHistogram* mHistogramPseudoeff[3];
@@ -14,16 +14,14 @@
 #include "MCHBase/Digit.h"
 #define __STDC_FORMAT_MACROS
 #include <cinttypes>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <thread>
 
 using namespace std;
 
-static int gPrintLevel;
-static int gPattern;
-static int gNbErrors;
-static int gNbWarnings;
-
-static FILE* flog = NULL;
-
 struct CRUheader {
   uint8_t header_version;
   uint8_t header_size;
@@ -83,10 +81,10 @@ bool BXCNT_compare(long int c1, long int c2)
   return false;
 }
 
-void DualSampaInit(DualSampa* ds)
+void DualSampaInit(DualSampa* ds, DecodingContext& ctx)
 {
-  if (gPrintLevel >= 4)
-    fprintf(flog, "DualSampaInit() called\n");
+  if (ctx.printLevel >= 4)
+    fprintf(ctx.log, "DualSampaInit() called\n");
   ds->status = notSynchronized;
   ds->data = 0;
   ds->bit = 0;
@@ -106,10 +104,10 @@ void DualSampaInit(DualSampa* ds)
   }
 }
 
-void DualSampaReset(DualSampa* ds)
+void DualSampaReset(DualSampa* ds, DecodingContext& ctx)
 {
-  if (gPrintLevel >= 4)
-    fprintf(flog, "DualSampaReset() called\n");
+  if (ctx.printLevel >= 4)
+    fprintf(ctx.log, "DualSampaReset() called\n");
   ds->status = notSynchronized;
   ds->data = 0;
   ds->bit = 0;
@@ -290,6 +288,69 @@ void HammingDecode(unsigned int buffer[2], bool& error, bool& uncorrectable, boo
   }
 }
 
+// Bits of the SAMPA header entering each of the 6 Hamming parities (the parity bit itself included),
+// and bit of the header to be corrected for each value of the syndrome
+struct HammingTables {
+  uint64_t parityMasks[6];
+  uint64_t syndromeBits[64];
+};
+
+constexpr HammingTables MakeHammingTables()
+{
+  HammingTables tables{};
+  // the parity bits are at the positions 1, 2, 4, ... 32 of the Hamming code word,
+  // the 43 data bits fill the other positions from 3 to 49
+  int dataPosition = 3;
+  for (int b = 0; b < 50; b++) {
+    if (b == 6) // header parity, not part of the code word
+      continue;
+    int position = 0;
+    if (b < 6) {
+      position = 1 << b;
+    } else {
+      while ((dataPosition & (dataPosition - 1)) == 0)
+        dataPosition++;
+      position = dataPosition++;
+    }
+    for (int k = 0; k < 6; k++) {
+      if ((position >> k) & 0x1)
+        tables.parityMasks[k] |= ((uint64_t)1) << b;
+    }
+    tables.syndromeBits[position] = ((uint64_t)1) << b;
+  }
+  return tables;
+}
+
+static constexpr HammingTables sHammingTables = MakeHammingTables();
+
+// All the bits of the SAMPA header except the header parity
+static const uint64_t HEADER_PARITY_PROTECTED_BITS = 0x3FFFFFFFFFFBF;
+
+int FastCheckDataParity(uint64_t data)
+{
+  return __builtin_popcountll(data & 0x3FFFFFFFFFFFF) & 0x1;
+}
+
+void FastHammingDecode(uint64_t& header, bool& error, bool& uncorrectable, bool fix_data)
+{
+  unsigned int syndrome = 0;
+  for (int k = 0; k < 6; k++)
+    syndrome |= (__builtin_popcountll(header & sHammingTables.parityMasks[k]) & 0x1) << k;
+
+  bool overallparity = (header >> 6) & 0x1;
+  bool overallparitycalc = __builtin_popcountll(header & HEADER_PARITY_PROTECTED_BITS) & 0x1;
+  bool syndromeerror = (syndrome > 0);
+  bool wrongparity = (overallparitycalc != overallparity);
+  error = syndromeerror || wrongparity;
+  uncorrectable = syndromeerror && (!wrongparity);
+
+  if (fix_data) {
+    header ^= sHammingTables.syndromeBits[syndrome];
+    if (!syndromeerror && wrongparity) // If error was in parity fix parity
+      header ^= ((uint64_t)1) << 6;
+  }
+}
+
 void DecodeGBTWord(uint32_t* bufpt, uint32_t* data)
 {
   uint32_t word = *(bufpt + 3);
@@ -388,11 +449,281 @@ void DecodeGBTWord(uint32_t* bufpt, uint32_t* data)
   data[39] += (((word) >> 15) & 0x1);
 }
 
-decode_state_t Add1BitOfData(uint32_t gbtdata, DualSampa& dsr, DualSampaGroup* dsg)
+// Decoding of a complete SAMPA header, stored in the 50 bits of dsr.data
+decode_state_t DecodeSampaHeader(DualSampa& dsr, DualSampaGroup* dsg, DecodingContext& ctx)
+{
+  decode_state_t result = DECODE_STATE_UNKNOWN;
+  DualSampa* ds = &dsr;
+
+  if (dsr.data == 0x1555540f00113) {
+    if (ctx.printLevel >= 2)
+      fprintf(ctx.log, "SAMPA #%d: Sync word found\n", dsr.id); // Next word of 50 bits should be a Sync Word
+    result = DECODE_STATE_SYNC_FOUND;
+  } else {
+    result = DECODE_STATE_HEADER_FOUND;
+    memcpy(&(ds->header), &(ds->data), sizeof(Sampa::SampaHeaderStruct));
+    //if( ctx.printLevel >= 1 ) fprintf(ctx.log,"SAMPA #%d: ds->nbHit=%d\n", ds->id, ds->nbHit);
+    if (ds->nbHit >= 0) // if chip was synchronized
+      ds->nbHit++;
+    else
+      ds->nbHit = 1;
+    if ((ds->header.fChannelAddress >= 0) && (ds->header.fChannelAddress < 32)) {
+      //fprintf(ctx.log,"%.2d %.2d\n",ds->header.fChipAddress,(ds->header.fChipAddress%2));
+      ds->nbHitChan[ds->header.fChannelAddress + 32 * (ds->header.fChipAddress % 2)]++;
+    }
+    if (ctx.printLevel >= 1 || (false && ds->id == 0 && ds->header.fChipAddress == 0 && ds->header.fChannelAddress >= 30))
+      fprintf(ctx.log, "SAMPA [%2d]: Header 0x%014" PRIu64 " HCode %2lu HPar %lu PkgType %lu 10BitWords %lu ChipAdd %lu ChAdd %2lu BX %lu PPar %d\n",
+              ds->id, ds->data, (unsigned long)ds->header.fHammingCode, (unsigned long)ds->header.fHeaderParity, (unsigned long)ds->header.fPkgType,
+              (unsigned long)ds->header.fNbOf10BitWords, (unsigned long)ds->header.fChipAddress, (unsigned long)ds->header.fChannelAddress,
+              (unsigned long)ds->header.fBunchCrossingCounter, (int)ds->header.fPayloadParity);
+    int parity = FastCheckDataParity(ds->data);
+    if (parity)
+      fprintf(ctx.log, "===> SAMPA [%d %d %2d]: WARNING Parity %d\n", ds->hit.cru_id, ds->hit.link_id, ds->id, parity);
+
+    //fprintf(ctx.log,"SAMPA [%2d]: ChipAdd %d ChAdd %2d BX %d, expected %d\n",
+    //              ds->id, ds->header.fChipAddress,ds->header.fChannelAddress,
+    //              ds->header.fBunchCrossingCounter, ds->bxc);
+    int link = ds->id / 5;
+    if (ctx.printLevel >= 1)
+      fprintf(ctx.log, "SAMPA [%2d]: BX counter for link %d is %ld\n", ds->id, link, dsg->bxc);
+    if (dsg && dsg->bxc >= 0) {
+      if (!BXCNT_compare(dsg->bxc, static_cast<long int>(ds->header.fBunchCrossingCounter))) {
+        ctx.nbErrors++;
+        fprintf(ctx.log, "===> ERROR SAMPA [%2d]: ChipAdd %lu ChAdd %2lu BX %lu, expected %ld, diff %ld\n",
+                ds->id, (unsigned long)ds->header.fChipAddress, (unsigned long)ds->header.fChannelAddress,
+                (unsigned long)ds->header.fBunchCrossingCounter, dsg->bxc,
+                (unsigned long)ds->header.fBunchCrossingCounter - dsg->bxc);
+      }
+    } else {
+      if (dsg && ds->header.fPkgType == 4) { // physics trigger
+        dsg->bxc = ds->header.fBunchCrossingCounter;
+        if (ctx.printLevel >= 1)
+          fprintf(ctx.log, "SAMPA [%2d]: BX counter for link %d set to %ld\n", ds->id, link, dsg->bxc);
+      }
+    }
+    //if( ctx.printLevel >= 1 ) fprintf(ctx.log,"SAMPA [%2d]: BX counter for link %d is %d (2)\n", ds->id, link, dsg->bxc);
+
+    ds->packetsize = 0;
+
+    uint64_t hamming_data = ds->data;
+    bool hamming_error = false;  // Is there an hamming error?
+    bool hamming_uncorr = false; // Is the data correctable?
+    bool hamming_enable = false; // Correct the data?
+    FastHammingDecode(hamming_data, hamming_error, hamming_uncorr, hamming_enable);
+    if (hamming_error) {
+      ctx.nbErrors++;
+      fprintf(ctx.log, "SAMPA [%d %d %2d (J%d DS%d)]: Hamming ERROR -> Correctable: %s\n",
+          ds->hit.cru_id, ds->hit.link_id, ds->id, (int)(ds->id/5 + 1), (int)(ds->id%5),
+          hamming_uncorr ? "NO" : "YES");
+      ds->status = notSynchronized;
+      result = DECODE_STATE_UNKNOWN;
+    } else {                          // No Hamming error
+      if (ds->header.fPkgType == 4) { // Good data
+        ds->status = sizeToRead;
+        ds->bxc[ds->header.fChipAddress % 2] = ds->header.fBunchCrossingCounter;
+      } else {
+        if (ds->header.fPkgType == 1 || ds->header.fPkgType == 3) { // Data truncated
+          ctx.nbErrors++;
+          fprintf(ctx.log, "ERROR: Truncated data found -> skip the data\n");
+          if (ds->header.fNbOf10BitWords)
+            ds->status = dataToRead;
+          else
+            ds->status = headerToRead;
+        }
+        if (ds->header.fPkgType == 0) { // Heartbeat: Pkg 0, NbOfWords 0 ?, ChAdd 21
+          ctx.nbErrors++;
+          fprintf(ctx.log, "ERROR: Hearbeat word found\n");
+          ds->status = headerToRead;
+          ds->bxc[ds->header.fChipAddress % 2] = ds->header.fBunchCrossingCounter;
+        }
+        if (ds->header.fPkgType == 5) { //
+          ctx.nbErrors++;
+          fprintf(ctx.log, "ERROR: Data word (?) type 5 found\n");
+          ds->status = headerToRead;
+        }
+        if (ds->header.fPkgType == 6) { //
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "INFO: Trigger too early word found\n");
+          //ds->status = headerToRead;
+          ds->status = sizeToRead;
+        }
+        if (ds->header.fPkgType == 2) { //
+          ctx.nbErrors++;
+          fprintf(ctx.log, "ERROR: Supposed to be a SYNC!!!\n");
+          fprintf(ctx.log, "Trying to re-synchronise...\n");
+          ds->status = notSynchronized;
+          result = DECODE_STATE_UNKNOWN;
+        }
+      }
+    }
+  }
+
+  if (ds->status != notSynchronized) {
+    ds->bit = 0;
+    ds->data = 0;
+    ds->powerMultiplier = 1;
+  }
+
+  return result;
+}
+
+// Decoding of a complete cluster size, stored in the 10 bits of dsr.data
+decode_state_t DecodeClusterSize(DualSampa& dsr, DecodingContext& ctx)
+{
+  decode_state_t result = DECODE_STATE_UNKNOWN;
+  DualSampa* ds = &dsr;
+
+  result = DECODE_STATE_CSIZE_FOUND;
+
+  int chip0 = (ds->id % 5) * 2;
+  int chip1 = chip0 + 1;
+
+  if (ctx.printLevel >= 5)
+    fprintf(ctx.log, "SAMPA: chip addresses: %lu\n", (unsigned long)ds->header.fChipAddress);
+  if (ctx.printLevel >= 5)
+    fprintf(ctx.log, "SAMPA: channel addresses: %d, %d\n",
+            ds->chan_addr[0], ds->chan_addr[1]);
+  if (ds->header.fChipAddress < chip0 || ds->header.fChipAddress > chip1) {
+    ctx.nbWarnings++;
+    if (ctx.printLevel >= 1)
+      fprintf(ctx.log, "===> WARNING SAMPA [%2d]: chip address = %lu, expected = [%d,%d]\n", ds->id,
+              (unsigned long)ds->header.fChipAddress, chip0, chip1);
+  }
+  if (ds->chan_addr[ds->header.fChipAddress - chip0] != ds->header.fChannelAddress) {
+    ctx.nbWarnings++;
+    if (ctx.printLevel >= 1)
+      fprintf(ctx.log, "===> WARNING SAMPA [%2d]: channel address = %lu, expected = %d\n", ds->id,
+              (unsigned long)ds->header.fChannelAddress, ds->chan_addr[ds->header.fChipAddress - chip0]);
+  }
+  ds->chan_addr[ds->header.fChipAddress - chip0] += 1;
+  if (ds->chan_addr[ds->header.fChipAddress - chip0] > 31) {
+    ds->chan_addr[ds->header.fChipAddress - chip0] = 0;
+  }
+  if (ctx.printLevel >= 5)
+    fprintf(ctx.log, "SAMPA: next channel addresses: %d, %d\n",
+            ds->chan_addr[0], ds->chan_addr[1]);
+
+  if (ctx.printLevel >= 1)
+    fprintf(ctx.log, "SAMPA [%2d]: Cluster Size 0x%" PRIu64 " (%" PRIu64 ")\n", ds->id, ds->data, ds->data);
+
+  ds->csize = ds->data;
+  ds->cid = 0;
+  ds->packetsize += 1;
+  ds->status = timeToRead;
+
+  if (ds->status != notSynchronized) {
+    ds->bit = 0;
+    ds->data = 0;
+    ds->powerMultiplier = 1;
+  }
+
+  return result;
+}
+
+// Decoding of a complete cluster time, stored in the 10 bits of dsr.data
+decode_state_t DecodeClusterTime(DualSampa& dsr, DecodingContext& ctx)
+{
+  decode_state_t result = DECODE_STATE_UNKNOWN;
+  DualSampa* ds = &dsr;
+
+  result = DECODE_STATE_CTIME_FOUND;
+  if (ctx.printLevel >= 1)
+    fprintf(ctx.log, "SAMPA [%2d]: Cluster Time 0x%" PRIu64 " (%" PRIu64 ")\n", ds->id, ds->data, ds->data);
+
+  ds->ctime = ds->data;
+  ds->packetsize += 1;
+  ds->status = dataToRead;
+  //ds->status = chargeToRead;
+
+  if (ds->status != notSynchronized) {
+    ds->bit = 0;
+    ds->data = 0;
+    ds->powerMultiplier = 1;
+  }
+
+  return result;
+}
+
+// Decoding of a complete ADC sample, stored in the 10 bits of dsr.data
+decode_state_t DecodeSample(DualSampa& dsr, DecodingContext& ctx)
+{
+  decode_state_t result = DECODE_STATE_UNKNOWN;
+  DualSampa* ds = &dsr;
+
+  if (ctx.printLevel >= 1)
+    fprintf(ctx.log, "SAMPA [%2d]: Data word 0x%" PRIu64 " (%" PRIu64 ")\n", ds->id, ds->data, ds->data);
+
+  if (1 /*ds->header.fPkgType == 4*/) {
+    if (ds->header.fPkgType == 4) { // Good data
+      result = DECODE_STATE_SAMPLE_FOUND;
+      ds->sample = ds->data;
+
+      if (ctx.pattern > 0) {
+        int patt = (ctx.pattern & 0xFF) + (ctx.pattern << 8 & 0xFF00);
+        if ((ds->data & 0x2FF) != (patt & 0x2FF)) {
+          ctx.nbWarnings++;
+          fprintf(ctx.log, "===> WARNING SAMPA [%2d]: wrong data pattern 0x%" PRIu64 ", expected 0x%X\n", ds->id,
+                  ds->data & 0x2FF, (patt & 0x2FF));
+        }
+      }
+    }
+    ds->cid += 1;
+    ds->packetsize += 1;
+    bool end_of_packet = (ds->header.fNbOf10BitWords == ds->packetsize);
+    bool end_of_cluster = (ds->cid == ds->csize);
+    if (end_of_packet && !end_of_cluster) {
+      // That's the end of the packet, but the cluster is still being read... that's not normal
+      ctx.nbErrors++;
+      //fprintf(ctx.log,"===> ERROR SAMPA [%2d]: End-of-packet without End-of-cluster. packet size = %lu, cluster size = %d\n",
+      //    ds->id, ds->header.fNbOf10BitWords, ds->csize);
+      ds->status = headerToRead;
+    } else if (end_of_cluster) {
+      if (ctx.printLevel >= 1)
+        fprintf(ctx.log, "SAMPA #%d : End of cluster found\n", ds->id);
+      if (ds->header.fPkgType == 4) { // Good data
+        ds->nclus[ds->header.fChipAddress % 2][ds->header.fChannelAddress] += 1;
+        result = DECODE_STATE_END_OF_CLUSTER;
+        if (ds->id == 0 && ds->header.fChipAddress == 0 && ds->header.fChannelAddress >= 30) {
+          if (false) {
+            if (ds->header.fChannelAddress == 31)
+              fprintf(ctx.log, "    ");
+            fprintf(ctx.log, "%d %lu %lu: End of cluster found (%d)\n", ds->id, (unsigned long)ds->header.fChipAddress, (unsigned long)ds->header.fChannelAddress,
+                    ds->nclus[ds->header.fChipAddress % 2][ds->header.fChannelAddress]);
+          }
+        }
+      }
+      if (ds->header.fNbOf10BitWords > ds->packetsize)
+        ds->status = sizeToRead;
+      else {
+        ds->packetsize = 0;
+        ds->status = headerToRead;
+      }
+    }
+  } else {
+    if (ds->header.fPkgType == 1 || ds->header.fPkgType == 3) { // Data truncated
+      ctx.nbWarnings++;
+      fprintf(ctx.log, "WARNING: SAMPA PkgType = 1 or 3 (data truncated)  found\n");
+      if (ds->header.fNbOf10BitWords - 1)
+        ds->header.fNbOf10BitWords--;
+      else
+        ds->status = headerToRead;
+    }
+  }
+
+  if (ds->status != notSynchronized) {
+    ds->bit = 0;
+    ds->data = 0;
+    ds->powerMultiplier = 1;
+  }
+
+  return result;
+}
+
+decode_state_t Add1BitOfData(uint32_t gbtdata, DualSampa& dsr, DualSampaGroup* dsg, DecodingContext& ctx)
 {
   decode_state_t result = DECODE_STATE_UNKNOWN;
-  if (gPrintLevel >= 2)
-    fprintf(flog, "ds->status=%d\n", dsr.status);
+  if (ctx.printLevel >= 2)
+    fprintf(ctx.log, "ds->status=%d\n", dsr.status);
   if (!(dsr.status == notSynchronized)) { // data is synchronized => build the data word
     dsr.data += (gbtdata & 0x1) * dsr.powerMultiplier;
     dsr.powerMultiplier *= 2;
@@ -405,12 +736,12 @@ decode_state_t Add1BitOfData(uint32_t gbtdata, DualSampa& dsr, DualSampaGroup* d
     case notSynchronized: {
       // Looking for Sync word (2 packets)
       // Look for 10 consecutives 01 (sent 10 from the GBT)
-      if (gPrintLevel >= 2)
-        fprintf(flog, "  ds[%d]->bit=%d\n  ->powerMultiplier=%" PRIu64 "\n  (gbtdata&0x1)=%d\n",
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "  ds[%d]->bit=%d\n  ->powerMultiplier=%" PRIu64 "\n  (gbtdata&0x1)=%d\n",
                 ds->id, ds->bit, ds->powerMultiplier, (int)(gbtdata & 0x1));
       if (ds->bit < 50) { // Fill the word
         ds->data += (gbtdata & 0x1) * ds->powerMultiplier;
-        //if( gPrintLevel >= 2 ) fprintf(flog,"Add1BitOfData()\n  ds[%d]->data=%lX\n", ds->id, ds->data);
+        //if( ctx.printLevel >= 2 ) fprintf(ctx.log,"Add1BitOfData()\n  ds[%d]->data=%lX\n", ds->id, ds->data);
         ds->powerMultiplier *= 2;
         ds->bit++;
       } else {
@@ -419,15 +750,15 @@ decode_state_t Add1BitOfData(uint32_t gbtdata, DualSampa& dsr, DualSampaGroup* d
         ds->data /= 2;              // Take out the bit 0
         ds->data &= 0x1FFFFFFFFFFFF;
         ds->data += (gbtdata & 0x1) * ds->powerMultiplier; // Fill bit 49
-        //if( gPrintLevel >= 2 ) fprintf(flog,"Add1BitOfData()\n  ds[%d]->data=%lX\n", ds->data);
+        //if( ctx.printLevel >= 2 ) fprintf(ctx.log,"Add1BitOfData()\n  ds[%d]->data=%lX\n", ds->data);
         ds->bit++;
       }
 
-      if (gPrintLevel >= 2)
-        fprintf(flog, "  ==> ds[%d]->data: %.16" PRIu64 "\n", ds->id, ds->data);
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "  ==> ds[%d]->data: %.16" PRIu64 "\n", ds->id, ds->data);
       if (ds->data == 0x1555540f00113 && ds->bit >= 50) {
-        if (gPrintLevel >= 1)
-          fprintf(flog, "SAMPA #%d: Synchronizing... (Sync word found)\n", ds->id); // Next word of 50 bits should be a Sync Word
+        if (ctx.printLevel >= 1)
+          fprintf(ctx.log, "SAMPA #%d: Synchronizing... (Sync word found)\n", ds->id); // Next word of 50 bits should be a Sync Word
         ds->bit = 0;
         ds->data = 0;
         ds->powerMultiplier = 1;
@@ -441,264 +772,32 @@ decode_state_t Add1BitOfData(uint32_t gbtdata, DualSampa& dsr, DualSampaGroup* d
     case headerToRead: {
       // We are waiting for a Sampa header
       // It can be preceded by an undefined number os Sync words
-      if (gPrintLevel >= 2)
-        fprintf(flog, "  ds[%d]->bit=%d\n  ->powerMultiplier=%" PRIu64 "\n  (gbtdata&0x1)=%d\n",
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "  ds[%d]->bit=%d\n  ->powerMultiplier=%" PRIu64 "\n  (gbtdata&0x1)=%d\n",
                 dsr.id, dsr.bit, dsr.powerMultiplier, (int)(gbtdata & 0x1));
-      if (gPrintLevel >= 2)
-        fprintf(flog, "  ==> ds[%d]->data: %.16" PRIu64 "\n", dsr.id, dsr.data);
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "  ==> ds[%d]->data: %.16" PRIu64 "\n", dsr.id, dsr.data);
       if (dsr.bit < 50)
         break;
-      if (dsr.data == 0x1555540f00113) {
-        if (gPrintLevel >= 2)
-          fprintf(flog, "SAMPA #%d: Sync word found\n", dsr.id); // Next word of 50 bits should be a Sync Word
-        result = DECODE_STATE_SYNC_FOUND;
-      } else {
-        result = DECODE_STATE_HEADER_FOUND;
-        memcpy(&(ds->header), &(ds->data), sizeof(Sampa::SampaHeaderStruct));
-        //if( gPrintLevel >= 1 ) fprintf(flog,"SAMPA #%d: ds->nbHit=%d\n", ds->id, ds->nbHit);
-        if (ds->nbHit >= 0) // if chip was synchronized
-          ds->nbHit++;
-        else
-          ds->nbHit = 1;
-        if ((ds->header.fChannelAddress >= 0) && (ds->header.fChannelAddress < 32)) {
-          //fprintf(flog,"%.2d %.2d\n",ds->header.fChipAddress,(ds->header.fChipAddress%2));
-          ds->nbHitChan[ds->header.fChannelAddress + 32 * (ds->header.fChipAddress % 2)]++;
-        }
-        if (gPrintLevel >= 1 || (false && ds->id == 0 && ds->header.fChipAddress == 0 && ds->header.fChannelAddress >= 30))
-          fprintf(flog, "SAMPA [%2d]: Header 0x%014" PRIu64 " HCode %2lu HPar %lu PkgType %lu 10BitWords %lu ChipAdd %lu ChAdd %2lu BX %lu PPar %d\n",
-                  ds->id, ds->data, (unsigned long)ds->header.fHammingCode, (unsigned long)ds->header.fHeaderParity, (unsigned long)ds->header.fPkgType,
-                  (unsigned long)ds->header.fNbOf10BitWords, (unsigned long)ds->header.fChipAddress, (unsigned long)ds->header.fChannelAddress,
-                  (unsigned long)ds->header.fBunchCrossingCounter, (int)ds->header.fPayloadParity);
-        int parity = CheckDataParity(ds->data);
-        if (parity)
-          fprintf(flog, "===> SAMPA [%d %d %2d]: WARNING Parity %d\n", ds->hit.cru_id, ds->hit.link_id, ds->id, parity);
-
-        //fprintf(flog,"SAMPA [%2d]: ChipAdd %d ChAdd %2d BX %d, expected %d\n",
-        //              ds->id, ds->header.fChipAddress,ds->header.fChannelAddress,
-        //              ds->header.fBunchCrossingCounter, ds->bxc);
-        int link = ds->id / 5;
-        if (gPrintLevel >= 1)
-          fprintf(flog, "SAMPA [%2d]: BX counter for link %d is %ld\n", ds->id, link, dsg->bxc);
-        if (dsg && dsg->bxc >= 0) {
-          if (!BXCNT_compare(dsg->bxc, static_cast<long int>(ds->header.fBunchCrossingCounter))) {
-            gNbErrors++;
-            fprintf(flog, "===> ERROR SAMPA [%2d]: ChipAdd %lu ChAdd %2lu BX %lu, expected %ld, diff %ld\n",
-                    ds->id, (unsigned long)ds->header.fChipAddress, (unsigned long)ds->header.fChannelAddress,
-                    (unsigned long)ds->header.fBunchCrossingCounter, dsg->bxc,
-                    (unsigned long)ds->header.fBunchCrossingCounter - dsg->bxc);
-          }
-        } else {
-          if (dsg && ds->header.fPkgType == 4) { // physics trigger
-            dsg->bxc = ds->header.fBunchCrossingCounter;
-            if (gPrintLevel >= 1)
-              fprintf(flog, "SAMPA [%2d]: BX counter for link %d set to %ld\n", ds->id, link, dsg->bxc);
-          }
-        }
-        //if( gPrintLevel >= 1 ) fprintf(flog,"SAMPA [%2d]: BX counter for link %d is %d (2)\n", ds->id, link, dsg->bxc);
-
-        ds->packetsize = 0;
-
-        unsigned int buf[2];
-        buf[0] = ds->data & 0x3FFFFFFF;
-        buf[1] = ds->data >> 30;
-        bool hamming_error = false;  // Is there an hamming error?
-        bool hamming_uncorr = false; // Is the data correctable?
-        bool hamming_enable = false; // Correct the data?
-        HammingDecode(buf, hamming_error, hamming_uncorr, hamming_enable);
-        if (hamming_error) {
-          gNbErrors++;
-          fprintf(flog, "SAMPA [%d %d %2d (J%d DS%d)]: Hamming ERROR -> Correctable: %s\n",
-              ds->hit.cru_id, ds->hit.link_id, ds->id, (int)(ds->id/5 + 1), (int)(ds->id%5),
-              hamming_uncorr ? "NO" : "YES");
-          ds->status = notSynchronized;
-          result = DECODE_STATE_UNKNOWN;
-        } else {                          // No Hamming error
-          if (ds->header.fPkgType == 4) { // Good data
-            ds->status = sizeToRead;
-            ds->bxc[ds->header.fChipAddress % 2] = ds->header.fBunchCrossingCounter;
-          } else {
-            if (ds->header.fPkgType == 1 || ds->header.fPkgType == 3) { // Data truncated
-              gNbErrors++;
-              fprintf(flog, "ERROR: Truncated data found -> skip the data\n");
-              if (ds->header.fNbOf10BitWords)
-                ds->status = dataToRead;
-              else
-                ds->status = headerToRead;
-            }
-            if (ds->header.fPkgType == 0) { // Heartbeat: Pkg 0, NbOfWords 0 ?, ChAdd 21
-              gNbErrors++;
-              fprintf(flog, "ERROR: Hearbeat word found\n");
-              ds->status = headerToRead;
-              ds->bxc[ds->header.fChipAddress % 2] = ds->header.fBunchCrossingCounter;
-            }
-            if (ds->header.fPkgType == 5) { //
-              gNbErrors++;
-              fprintf(flog, "ERROR: Data word (?) type 5 found\n");
-              ds->status = headerToRead;
-            }
-            if (ds->header.fPkgType == 6) { //
-              if (gPrintLevel >= 1)
-                fprintf(flog, "INFO: Trigger too early word found\n");
-              //ds->status = headerToRead;
-              ds->status = sizeToRead;
-            }
-            if (ds->header.fPkgType == 2) { //
-              gNbErrors++;
-              fprintf(flog, "ERROR: Supposed to be a SYNC!!!\n");
-              fprintf(flog, "Trying to re-synchronise...\n");
-              ds->status = notSynchronized;
-              result = DECODE_STATE_UNKNOWN;
-            }
-          }
-        }
-      }
-
-      if (ds->status != notSynchronized) {
-        ds->bit = 0;
-        ds->data = 0;
-        ds->powerMultiplier = 1;
-      }
+      result = DecodeSampaHeader(dsr, dsg, ctx);
       break;
     }
     case sizeToRead: {
       if (ds->bit < 10)
         break;
-
-      result = DECODE_STATE_CSIZE_FOUND;
-
-      int chip0 = (ds->id % 5) * 2;
-      int chip1 = chip0 + 1;
-
-      if (gPrintLevel >= 5)
-        fprintf(flog, "SAMPA: chip addresses: %lu\n", (unsigned long)ds->header.fChipAddress);
-      if (gPrintLevel >= 5)
-        fprintf(flog, "SAMPA: channel addresses: %d, %d\n",
-                ds->chan_addr[0], ds->chan_addr[1]);
-      if (ds->header.fChipAddress < chip0 || ds->header.fChipAddress > chip1) {
-        gNbWarnings++;
-        if (gPrintLevel >= 1)
-          fprintf(flog, "===> WARNING SAMPA [%2d]: chip address = %lu, expected = [%d,%d]\n", ds->id,
-                  (unsigned long)ds->header.fChipAddress, chip0, chip1);
-      }
-      if (ds->chan_addr[ds->header.fChipAddress - chip0] != ds->header.fChannelAddress) {
-        gNbWarnings++;
-        if (gPrintLevel >= 1)
-          fprintf(flog, "===> WARNING SAMPA [%2d]: channel address = %lu, expected = %d\n", ds->id,
-                  (unsigned long)ds->header.fChannelAddress, ds->chan_addr[ds->header.fChipAddress - chip0]);
-      }
-      ds->chan_addr[ds->header.fChipAddress - chip0] += 1;
-      if (ds->chan_addr[ds->header.fChipAddress - chip0] > 31) {
-        ds->chan_addr[ds->header.fChipAddress - chip0] = 0;
-      }
-      if (gPrintLevel >= 5)
-        fprintf(flog, "SAMPA: next channel addresses: %d, %d\n",
-                ds->chan_addr[0], ds->chan_addr[1]);
-
-      if (gPrintLevel >= 1)
-        fprintf(flog, "SAMPA [%2d]: Cluster Size 0x%" PRIu64 " (%" PRIu64 ")\n", ds->id, ds->data, ds->data);
-
-      ds->csize = ds->data;
-      ds->cid = 0;
-      ds->packetsize += 1;
-      ds->status = timeToRead;
-
-      if (ds->status != notSynchronized) {
-        ds->bit = 0;
-        ds->data = 0;
-        ds->powerMultiplier = 1;
-      }
-
+      result = DecodeClusterSize(dsr, ctx);
       break;
     }
     case timeToRead: { // Read Time Count (10 bits)
       if (ds->bit < 10)
         break;
-      result = DECODE_STATE_CTIME_FOUND;
-      if (gPrintLevel >= 1)
-        fprintf(flog, "SAMPA [%2d]: Cluster Time 0x%" PRIu64 " (%" PRIu64 ")\n", ds->id, ds->data, ds->data);
-
-      ds->ctime = ds->data;
-      ds->packetsize += 1;
-      ds->status = dataToRead;
-      //ds->status = chargeToRead;
-
-      if (ds->status != notSynchronized) {
-        ds->bit = 0;
-        ds->data = 0;
-        ds->powerMultiplier = 1;
-      }
-
+      result = DecodeClusterTime(dsr, ctx);
       break;
     }
     case dataToRead: { // Read ADC data words (10 bits)
       if (ds->bit < 10)
         break;
-      if (gPrintLevel >= 1)
-        fprintf(flog, "SAMPA [%2d]: Data word 0x%" PRIu64 " (%" PRIu64 ")\n", ds->id, ds->data, ds->data);
-
-      if (1 /*ds->header.fPkgType == 4*/) {
-        if (ds->header.fPkgType == 4) { // Good data
-          result = DECODE_STATE_SAMPLE_FOUND;
-          ds->sample = ds->data;
-
-          if (gPattern > 0) {
-            int patt = (gPattern & 0xFF) + (gPattern << 8 & 0xFF00);
-            if ((ds->data & 0x2FF) != (patt & 0x2FF)) {
-              gNbWarnings++;
-              fprintf(flog, "===> WARNING SAMPA [%2d]: wrong data pattern 0x%" PRIu64 ", expected 0x%X\n", ds->id,
-                      ds->data & 0x2FF, (patt & 0x2FF));
-            }
-          }
-        }
-        ds->cid += 1;
-        ds->packetsize += 1;
-        bool end_of_packet = (ds->header.fNbOf10BitWords == ds->packetsize);
-        bool end_of_cluster = (ds->cid == ds->csize);
-        if (end_of_packet && !end_of_cluster) {
-          // That's the end of the packet, but the cluster is still being read... that's not normal
-          gNbErrors++;
-          //fprintf(flog,"===> ERROR SAMPA [%2d]: End-of-packet without End-of-cluster. packet size = %lu, cluster size = %d\n",
-          //    ds->id, ds->header.fNbOf10BitWords, ds->csize);
-          ds->status = headerToRead;
-        } else if (end_of_cluster) {
-          if (gPrintLevel >= 1)
-            fprintf(flog, "SAMPA #%d : End of cluster found\n", ds->id);
-          if (ds->header.fPkgType == 4) { // Good data
-            ds->nclus[ds->header.fChipAddress % 2][ds->header.fChannelAddress] += 1;
-            result = DECODE_STATE_END_OF_CLUSTER;
-            if (ds->id == 0 && ds->header.fChipAddress == 0 && ds->header.fChannelAddress >= 30) {
-              if (false) {
-                if (ds->header.fChannelAddress == 31)
-                  fprintf(flog, "    ");
-                fprintf(flog, "%d %lu %lu: End of cluster found (%d)\n", ds->id, (unsigned long)ds->header.fChipAddress, (unsigned long)ds->header.fChannelAddress,
-                        ds->nclus[ds->header.fChipAddress % 2][ds->header.fChannelAddress]);
-              }
-            }
-          }
-          if (ds->header.fNbOf10BitWords > ds->packetsize)
-            ds->status = sizeToRead;
-          else {
-            ds->packetsize = 0;
-            ds->status = headerToRead;
-          }
-        }
-      } else {
-        if (ds->header.fPkgType == 1 || ds->header.fPkgType == 3) { // Data truncated
-          gNbWarnings++;
-          fprintf(flog, "WARNING: SAMPA PkgType = 1 or 3 (data truncated)  found\n");
-          if (ds->header.fNbOf10BitWords - 1)
-            ds->header.fNbOf10BitWords--;
-          else
-            ds->status = headerToRead;
-        }
-      }
-
-      if (ds->status != notSynchronized) {
-        ds->bit = 0;
-        ds->data = 0;
-        ds->powerMultiplier = 1;
-      }
-
+      result = DecodeSample(dsr, ctx);
       break;
     }
     default:
@@ -708,15 +807,15 @@ decode_state_t Add1BitOfData(uint32_t gbtdata, DualSampa& dsr, DualSampaGroup* d
   return result;
 }
 
-decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*dsg*/)
+decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*dsg*/, DecodingContext& ctx)
 {
   decode_state_t result = DECODE_STATE_UNKNOWN;
   switch (dsr.status) {
     case notSynchronized:
       dsr.data += data << dsr.bit;
 
-      if (gPrintLevel >= 1)
-        fprintf(flog, "notSynchronized[%d]: bit=%02d  data=%013" PRIu64 "  %03X %03X %03X %03X %03X\n",
+      if (ctx.printLevel >= 1)
+        fprintf(ctx.log, "notSynchronized[%d]: bit=%02d  data=%013" PRIu64 "  %03X %03X %03X %03X %03X\n",
                 dsr.id, dsr.bit, dsr.data,
                 (int)((dsr.data >> 40) & 0x3FF),
                 (int)((dsr.data >> 30) & 0x3FF),
@@ -733,8 +832,8 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
           dsr.bit = 0;
           dsr.data = 0;
           dsr.packetsize = 0;
-          if (gPrintLevel >= 1)
-            fprintf(flog, "notSynchronized[%d]: SYNC word found\n", dsr.id);
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "notSynchronized[%d]: SYNC word found\n", dsr.id);
         } else {
           dsr.data = dsr.data >> 10;
           dsr.bit -= 10;
@@ -745,8 +844,8 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
     case headerToRead:
       dsr.data += data << dsr.bit;
 
-      if (gPrintLevel >= 1)
-        fprintf(flog, "headerToRead[%d]: bit=%02d  data=%013" PRIu64 "  %03X %03X %03X %03X %03X\n",
+      if (ctx.printLevel >= 1)
+        fprintf(ctx.log, "headerToRead[%d]: bit=%02d  data=%013" PRIu64 "  %03X %03X %03X %03X %03X\n",
                 dsr.id, dsr.bit, dsr.data,
                 (int)((dsr.data >> 40) & 0x3FF),
                 (int)((dsr.data >> 30) & 0x3FF),
@@ -763,8 +862,8 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
           dsr.bit = 0;
           dsr.data = 0;
           dsr.packetsize = 0;
-          if (gPrintLevel >= 1)
-            fprintf(flog, "headerToRead[%d]: SYNC word found\n", dsr.id);
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "headerToRead[%d]: SYNC word found\n", dsr.id);
         } else {
           result = DECODE_STATE_HEADER_FOUND;
           memcpy(&(dsr.header), &(dsr.data), sizeof(Sampa::SampaHeaderStruct));
@@ -773,8 +872,8 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
           dsr.data = 0;
           dsr.packetsize = 0;
           Sampa::SampaHeaderStruct* header = (Sampa::SampaHeaderStruct*)&(dsr.header);
-          if (gPrintLevel >= 1)
-            fprintf(flog, "SAMPA Header: HCode %2lu HPar %lu PkgType %lu 10BitWords %lu ChipAdd %lu ChAdd %2lu BX %lu PPar %lu\n",
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "SAMPA Header: HCode %2lu HPar %lu PkgType %lu 10BitWords %lu ChipAdd %lu ChAdd %2lu BX %lu PPar %lu\n",
                     (unsigned long)header->fHammingCode, (unsigned long)header->fHeaderParity, (unsigned long)header->fPkgType,
                     (unsigned long)header->fNbOf10BitWords, (unsigned long)header->fChipAddress, (unsigned long)header->fChannelAddress,
                     (unsigned long)header->fBunchCrossingCounter, (unsigned long)header->fPayloadParity);
@@ -786,17 +885,17 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
       dsr.csize = data;
       dsr.cid = 0;
       dsr.packetsize += 1;
-      if (gPrintLevel >= 1)
-        fprintf(flog, "sizeToRead[%d]: SAMPA cluster size: %d\n", dsr.id, dsr.csize);
+      if (ctx.printLevel >= 1)
+        fprintf(ctx.log, "sizeToRead[%d]: SAMPA cluster size: %d\n", dsr.id, dsr.csize);
       if ((dsr.csize + 2) > dsr.header.fNbOf10BitWords) {
-        //fprintf(flog,"ERROR: cluster size bigger than SAMPA payload\n");
+        //fprintf(ctx.log,"ERROR: cluster size bigger than SAMPA payload\n");
         dsr.status = notSynchronized;
         dsr.bit = 0;
         dsr.data = 0;
         dsr.packetsize = 0;
       } else {
         if (dsr.packetsize == dsr.header.fNbOf10BitWords) {
-          ///fprintf(flog,"sizeToRead[%d]: ERROR: end-of-packet found while reading cluster size\n", dsr.id);
+          ///fprintf(ctx.log,"sizeToRead[%d]: ERROR: end-of-packet found while reading cluster size\n", dsr.id);
           dsr.status = notSynchronized;
           dsr.bit = 0;
           dsr.data = 0;
@@ -812,7 +911,7 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
       dsr.ctime = data;
       dsr.packetsize += 1;
       if (dsr.packetsize == dsr.header.fNbOf10BitWords) {
-        //fprintf(flog,"timeToRead[%d]: ERROR: end-of-packet found while reading cluster time\n", dsr.id);
+        //fprintf(ctx.log,"timeToRead[%d]: ERROR: end-of-packet found while reading cluster time\n", dsr.id);
         dsr.status = notSynchronized;
         dsr.bit = 0;
         dsr.data = 0;
@@ -820,8 +919,8 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
       } else {
         dsr.status = dataToRead;
         result = DECODE_STATE_CTIME_FOUND;
-        if (gPrintLevel >= 1)
-          fprintf(flog, "timeToRead[%d]: SAMPA cluster time: %d\n", dsr.id, dsr.ctime);
+        if (ctx.printLevel >= 1)
+          fprintf(ctx.log, "timeToRead[%d]: SAMPA cluster time: %d\n", dsr.id, dsr.ctime);
       }
       break;
 
@@ -834,7 +933,7 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
       //printf("dataToRead: cid=%d  packetsize=%d  end_of_packet=%d  end_of_cluster=%d\n",
       //    dsr.cid, dsr.packetsize, (int)end_of_packet, (int)end_of_cluster);
       if (end_of_packet && !end_of_cluster) {
-        //fprintf(flog,"dataToRead[%d]: ERROR: end-of-packet found while reading cluster data\n", dsr.id);
+        //fprintf(ctx.log,"dataToRead[%d]: ERROR: end-of-packet found while reading cluster data\n", dsr.id);
         dsr.bit = 0;
         dsr.data = 0;
         dsr.packetsize = 0;
@@ -842,8 +941,8 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
       } else {
         result = DECODE_STATE_SAMPLE_FOUND;
         dsr.status = dataToRead;
-        if (gPrintLevel >= 1)
-          fprintf(flog, "dataToRead[%d]: SAMPA sample: %d\n", dsr.id, dsr.sample);
+        if (ctx.printLevel >= 1)
+          fprintf(ctx.log, "dataToRead[%d]: SAMPA sample: %d\n", dsr.id, dsr.sample);
         if (end_of_cluster) {
           result = DECODE_STATE_END_OF_CLUSTER;
           if (end_of_packet) {
@@ -863,9 +962,200 @@ decode_state_t Add10BitsOfData(uint64_t data, DualSampa& dsr, DualSampaGroup* /*
   return result;
 }
 
+// Copy of the hit which has just been read into the list of hits, its samples are appended to the samples of the hits
+void StoreHit(DualSampa& dsr, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples)
+{
+  SampaHit& hit = dsr.hit;
+  hit.sampleOffset = samples.size();
+  hit.nSamples = dsr.samples.size();
+  samples.insert(samples.end(), dsr.samples.begin(), dsr.samples.end());
+  hits.push_back(hit);
+}
+
+// Update of the hit being read by a dual SAMPA board, after a complete field of the data stream has been decoded
+void ProcessDecodeState(decode_state_t state, DualSampa& dsr, int cru_id, int link_id, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples, DecodingContext& ctx)
+{
+  switch (state) {
+    case DECODE_STATE_SYNC_FOUND:
+      if (ctx.printLevel >= 1)
+        fprintf(ctx.log, "SYNC found\n");
+      break;
+    case DECODE_STATE_HEADER_FOUND:
+      uint64_t _h;
+      memcpy(&_h, &(dsr.header), sizeof(dsr.header));
+      if (ctx.printLevel >= 1)
+        fprintf(ctx.log, "board %d %d %d -> HEADER: %05" PRIu64 ", %lu, %lu\n",
+                cru_id, link_id, dsr.id, _h,
+                (unsigned long)dsr.header.fChipAddress,
+                (unsigned long)dsr.header.fChannelAddress);
+      break;
+    case DECODE_STATE_CSIZE_FOUND: {
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "CLUSTER SIZE: %" PRIu32 "\n", dsr.csize);
+      Sampa::SampaHeaderStruct& header = dsr.header;
+      SampaHit& hit = dsr.hit;
+      hit.cru_id = cru_id;
+      hit.data_path = link_id / 12;
+      hit.fee_id = cru_id * 2 + hit.data_path;
+      hit.link_id = link_id;
+      hit.ds_addr = dsr.id;
+      int chip_id = dsr.header.fChipAddress % 2;
+      hit.chan_addr = header.fChannelAddress + 32 * chip_id;
+      hit.bxc = header.fBunchCrossingCounter;
+      hit.size = dsr.csize;
+      dsr.samples.clear();
+      hit.csum = 0;
+      hit.time = 0;
+      for(int ci = 0; ci < 2; ci++) {
+        for(int cj = 0; cj < 32; cj++) {
+          dsr.min[ci][cj] = 0xFFFFFFFF;
+          dsr.max[ci][cj] = 0;
+        }
+      }
+      break;
+    }
+    case DECODE_STATE_CTIME_FOUND:
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "CLUSTER TIME: %d\n", dsr.ctime);
+      dsr.hit.time = dsr.ctime;
+      break;
+    case DECODE_STATE_SAMPLE_FOUND:
+    case DECODE_STATE_END_OF_CLUSTER: {
+      SampaHit& hit = dsr.hit;
+      if (ctx.printLevel >= 2)
+        fprintf(ctx.log, "SAMPLE: %X\n", dsr.sample);
+      dsr.samples.push_back(dsr.sample);
+      hit.csum += dsr.sample;
+
+      int chipid = hit.chan_addr / 32;
+      int chid = hit.chan_addr % 32;
+      if( dsr.min[chipid][chid] > dsr.sample )
+        dsr.min[chipid][chid] = dsr.sample;
+      if( dsr.max[chipid][chid] < dsr.sample )
+        dsr.max[chipid][chid] = dsr.sample;
+
+      if (state == DECODE_STATE_END_OF_CLUSTER) {
+        int32_t deltaNew = dsr.max[chipid][chid] - dsr.min[chipid][chid];
+        //if( hit.deltaMax < deltaNew )
+          hit.delta = deltaNew;
+        StoreHit(dsr, hits, samples);
+        if (hit.link_id >= 24) {
+          fprintf(stdout, "hit: link_id=%d, ds_addr=%d, chan_addr=%d\n",
+                  hit.link_id, hit.ds_addr, hit.chan_addr);
+          getchar();
+        }
+        hit.size = 0;
+        dsr.samples.clear();
+        hit.csum = 0;
+        hit.time = 0;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+// Number of GBT words which are decoded together by the word-level decoder. Each GBT word carries 2 bits for each
+// of the 40 dual SAMPA boards, thus 5 words make up one 10-bit word per board.
+static const size_t GBT_WORDS_PER_BLOCK = 5;
+
+// Extraction of the bits of up to GBT_WORDS_PER_BLOCK GBT words for each of the 40 dual SAMPA boards.
+// The bits of each board are returned in the order they are received, starting from the LSB.
+// This is equivalent to calling DecodeGBTWord() for each word, but it works on 64 bits at a time.
+void TransposeGBTWords(const uint32_t* payload_buf, size_t nGBTwords, uint32_t* lanes)
+{
+  for (int i = 0; i < 40; i++) {
+    lanes[i] = 0;
+  }
+  for (size_t wi = 0; wi < nGBTwords; wi++) {
+    const uint32_t* ptr = payload_buf + wi * 4;
+    // the board i is connected to the bits 2i+1 (received first) and 2i (received second) of the GBT word,
+    // swapping the bits of each pair puts them in the order they are received
+    uint64_t low = (uint64_t)ptr[0] | ((uint64_t)ptr[1] << 32);
+    uint64_t high = ptr[2] & 0xFFFF;
+    low = ((low >> 1) & 0x5555555555555555) | ((low & 0x5555555555555555) << 1);
+    high = ((high >> 1) & 0x5555) | ((high & 0x5555) << 1);
+    for (int i = 0; i < 32; i++) {
+      lanes[i] |= ((low >> (2 * i)) & 0x3) << (2 * wi);
+    }
+    for (int i = 0; i < 8; i++) {
+      lanes[32 + i] |= ((high >> (2 * i)) & 0x3) << (2 * wi);
+    }
+  }
+}
+
+// Word-level equivalent of Add1BitOfData(): the bits are added to the data stream of the board nBits at a time,
+// and each field is decoded once it is complete. Only the search of the sync word is done bit by bit,
+// as the sync word can start anywhere in the stream.
+void AddBitsOfData(uint64_t bits, int nBits, DualSampa& dsr, DualSampaGroup* dsg, int cru_id, int link_id, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples, DecodingContext& ctx)
+{
+  while (nBits > 0) {
+    if (dsr.status == notSynchronized) {
+      uint64_t bit = bits & 0x1;
+      bits >>= 1;
+      nBits -= 1;
+      if (dsr.bit < 50) { // Fill the word
+        dsr.data += bit << dsr.bit;
+      } else { // Take out the bit 0 and fill the bit 49
+        dsr.data = ((dsr.data >> 1) & 0x1FFFFFFFFFFFF) + (bit << 49);
+      }
+      dsr.bit++;
+      if (dsr.data == 0x1555540f00113 && dsr.bit >= 50) {
+        if (ctx.printLevel >= 1)
+          fprintf(ctx.log, "SAMPA #%d: Synchronizing... (Sync word found)\n", dsr.id);
+        dsr.bit = 0;
+        dsr.data = 0;
+        dsr.status = headerToRead;
+        dsr.chan_addr[0] = 0;
+        dsr.chan_addr[1] = 0;
+        ProcessDecodeState(DECODE_STATE_SYNC_FOUND, dsr, cru_id, link_id, hits, samples, ctx);
+      }
+      continue;
+    }
+
+    // data is synchronized => build the data word
+    int size = (dsr.status == headerToRead) ? 50 : 10;
+    int n = std::min(size - dsr.bit, nBits);
+    dsr.data += (bits & ((((uint64_t)1) << n) - 1)) << dsr.bit;
+    dsr.bit += n;
+    bits >>= n;
+    nBits -= n;
+    if (dsr.bit < size)
+      break;
+
+    decode_state_t state = DECODE_STATE_UNKNOWN;
+    switch (dsr.status) {
+      case headerToRead:
+        state = DecodeSampaHeader(dsr, dsg, ctx);
+        break;
+      case sizeToRead:
+        state = DecodeClusterSize(dsr, ctx);
+        break;
+      case timeToRead:
+        state = DecodeClusterTime(dsr, ctx);
+        break;
+      case dataToRead:
+        state = DecodeSample(dsr, ctx);
+        break;
+      default:
+        break;
+    }
+    ProcessDecodeState(state, dsr, cru_id, link_id, hits, samples, ctx);
+  }
+
+  // keep the state consistent with the one of the bit-serial decoder
+  // (while looking for the sync word, the multiplier stays at the bit 49 once the first 50 bits have been shifted in)
+  dsr.powerMultiplier = ((uint64_t)1) << ((dsr.bit > 50) ? 49 : dsr.bit);
+}
+
 Decoder::Decoder() {}
 
-Decoder::~Decoder() { fclose(flog); }
+Decoder::~Decoder()
+{
+  if (mContext.log && mContext.log != stdout)
+    fclose(mContext.log);
+}
 
 void Decoder::initialize()
 {
@@ -879,7 +1169,7 @@ void Decoder::initialize()
   for (int c = 0; c < MCH_MAX_CRU_ID; c++) {
     for (int l = 0; l < 24; l++) {
       for (int i = 0; i < 40; i++) {
-        DualSampaInit(&(ds[c][l][i]));
+        DualSampaInit(&(ds[c][l][i]), mContext);
         ds[c][l][i].id = i;
         ds[c][l][i].nbHit = -1;
         for (int j = 0; j < 64; j++) {
@@ -892,8 +1182,7 @@ void Decoder::initialize()
     }
   }
 
-  mMapCRU.readMapping("cru.map");
-  mMapFEC.readDSMapping("fec.map");
+  MappingCache::load("cru.map", "fec.map", "mapping.bin", mMapCRU, mMapFEC);
 
   fprintf(stdout, "initialize ds_enable\n");
   for (int c = 0; c < MCH_MAX_CRU_IN_FLP; c++) {
@@ -928,15 +1217,20 @@ void Decoder::initialize()
   }
   */
 
-  gPrintLevel = 0;
+  mContext.printLevel = 0;
 
-  //if( gPrintLevel > 0 ) flog = fopen("/home/flp/qc.log", "w");
+  //if( mContext.printLevel > 0 ) mContext.log = fopen("/home/flp/qc.log", "w");
   //else
-  flog = stdout;
+  mContext.log = stdout;
   fprintf(stdout, "Decoder initialization finished\n");
 }
 
 void Decoder::decodeRaw(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id)
+{
+  decodeRaw(payload_buf, nGBTwords, cru_id, link_id, mContext, mHits, mSamples);
+}
+
+void Decoder::decodeRaw(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples)
 {
   //fprintf(stdout,"[decodeRaw] payload_buf=%p\n", (void*)payload_buf);
   uint32_t hhvalue, hlvalue, lhvalue, llvalue;
@@ -968,92 +1262,49 @@ void Decoder::decodeRaw(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int
       hit.link_id = link_id;
       hit.ds_addr = ds[cru_id][link_id][i].id;
       for (int k = 0; k < 2; k++) {
-        decode_state_t state = Add1BitOfData(bits[k], (ds[cru_id][link_id][i]), &(dsg[cru_id][link_id][group]));
-        switch (state) {
-          case DECODE_STATE_SYNC_FOUND:
-            if (gPrintLevel >= 1)
-              fprintf(flog, "SYNC found\n");
-            break;
-          case DECODE_STATE_HEADER_FOUND:
-            uint64_t _h;
-            memcpy(&_h, &(ds[cru_id][link_id][i].header), sizeof(ds[cru_id][link_id][i].header));
-            if (gPrintLevel >= 1)
-              fprintf(flog, "board %d %d %d -> HEADER: %05" PRIu64 ", %lu, %lu\n",
-                      cru_id, link_id, i, _h,
-                      (unsigned long)ds[cru_id][link_id][i].header.fChipAddress,
-                      (unsigned long)ds[cru_id][link_id][i].header.fChannelAddress);
-            break;
-          case DECODE_STATE_CSIZE_FOUND: {
-            if (gPrintLevel >= 2)
-              fprintf(flog, "CLUSTER SIZE: %" PRIu32 "\n", ds[cru_id][link_id][i].csize);
-            Sampa::SampaHeaderStruct& header = ds[cru_id][link_id][i].header;
-            SampaHit& hit = ds[cru_id][link_id][i].hit;
-            hit.cru_id = cru_id;
-            hit.data_path = link_id / 12;
-            hit.fee_id = cru_id * 2 + hit.data_path;
-            hit.link_id = link_id;
-            hit.ds_addr = ds[cru_id][link_id][i].id;
-            int chip_id = ds[cru_id][link_id][i].header.fChipAddress % 2;
-            hit.chan_addr = header.fChannelAddress + 32 * chip_id;
-            hit.bxc = header.fBunchCrossingCounter;
-            hit.size = ds[cru_id][link_id][i].csize;
-            hit.samples.clear();
-            hit.csum = 0;
-            hit.time = 0;
-            for(int ci = 0; ci < 2; ci++) {
-              for(int cj = 0; cj < 32; cj++) {
-                ds[cru_id][link_id][i].min[ci][cj] = 0xFFFFFFFF;
-                ds[cru_id][link_id][i].max[ci][cj] = 0;
-              }
-            }
-            break;
-          }
-          case DECODE_STATE_CTIME_FOUND:
-            if (gPrintLevel >= 2)
-              fprintf(flog, "CLUSTER TIME: %d\n", ds[cru_id][link_id][i].ctime);
-            ds[cru_id][link_id][i].hit.time = ds[cru_id][link_id][i].ctime;
-            break;
-          case DECODE_STATE_SAMPLE_FOUND:
-          case DECODE_STATE_END_OF_CLUSTER: {
-            SampaHit& hit = ds[cru_id][link_id][i].hit;
-            if (gPrintLevel >= 2)
-              fprintf(flog, "SAMPLE: %X\n", ds[cru_id][link_id][i].sample);
-            hit.samples.push_back(ds[cru_id][link_id][i].sample);
-            hit.csum += ds[cru_id][link_id][i].sample;
-
-            int chipid = hit.ds_addr % 2;
-            int chid = hit.chan_addr;
-            if( ds[cru_id][link_id][i].min[chipid][chid] > ds[cru_id][link_id][i].sample )
-              ds[cru_id][link_id][i].min[chipid][chid] = ds[cru_id][link_id][i].sample;
-            if( ds[cru_id][link_id][i].max[chipid][chid] < ds[cru_id][link_id][i].sample )
-              ds[cru_id][link_id][i].max[chipid][chid] = ds[cru_id][link_id][i].sample;
-
-            if (state == DECODE_STATE_END_OF_CLUSTER) {
-              int32_t deltaNew = ds[cru_id][link_id][i].max[chipid][chid] - ds[cru_id][link_id][i].min[chipid][chid];
-              //if( hit.deltaMax < deltaNew )
-                hit.delta = deltaNew;
-              mHits.push_back(hit);
-              if (hit.link_id >= 24) {
-                fprintf(stdout, "hit: link_id=%d, ds_addr=%d, chan_addr=%d\n",
-                        hit.link_id, hit.ds_addr, hit.chan_addr);
-                getchar();
-              }
-              hit.size = 0;
-              hit.samples.clear();
-              hit.csum = 0;
-              hit.time = 0;
-            }
-            break;
-          }
-          default:
-            break;
-        }
+        decode_state_t state = Add1BitOfData(bits[k], (ds[cru_id][link_id][i]), &(dsg[cru_id][link_id][group]), ctx);
+        ProcessDecodeState(state, ds[cru_id][link_id][i], cru_id, link_id, hits, samples, ctx);
       }
     }
   }
 }
 
+void Decoder::decodeRawWords(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id)
+{
+  decodeRawWords(payload_buf, nGBTwords, cru_id, link_id, mContext, mHits, mSamples);
+}
+
+void Decoder::decodeRawWords(uint32_t* payload_buf, size_t nGBTwords, int cru_id, int link_id, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples)
+{
+  uint32_t lanes[40];
+  for (size_t wi = 0; wi < nGBTwords; wi += GBT_WORDS_PER_BLOCK) {
+    size_t nWords = std::min(GBT_WORDS_PER_BLOCK, nGBTwords - wi);
+    TransposeGBTWords(payload_buf + wi * 4, nWords, lanes);
+
+    for (int i = 0; i < 40; i++) {
+      if (ds_enable[cru_id][link_id][i] == 0)
+        continue;
+
+      DualSampa& dsr = ds[cru_id][link_id][i];
+      uint32_t group = dsr.id / 5;
+
+      SampaHit& hit = dsr.hit;
+      hit.cru_id = cru_id;
+      hit.data_path = link_id / 12;
+      hit.fee_id = cru_id * 2 + hit.data_path;
+      hit.link_id = link_id;
+      hit.ds_addr = dsr.id;
+      AddBitsOfData(lanes[i], 2 * nWords, dsr, &(dsg[cru_id][link_id][group]), cru_id, link_id, hits, samples, ctx);
+    }
+  }
+}
+
 void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int dpw_id)
+{
+  decodeUL(payload_buf_32, nWords, cru_id, dpw_id, mContext, mHits, mSamples);
+}
+
+void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int dpw_id, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples)
 {
   uint64_t* payload_buf = (uint64_t*)payload_buf_32;
   for (size_t wi = 0; wi < nWords; wi += 1) {
@@ -1064,8 +1315,8 @@ void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int
     int link_id = (value >> 59) & 0x1F;
     int ds_id = (value >> 53) & 0x3F;
     link_id += 12 * dpw_id;
-    if (gPrintLevel >= 1)
-      fprintf(flog, "64 bits: %016" PRIu64 "\n", value);
+    if (ctx.printLevel >= 1)
+      fprintf(ctx.log, "64 bits: %016" PRIu64 "\n", value);
 
     if (value == 0xFFFFFFFFFFFFFFFF)
       continue;
@@ -1074,22 +1325,22 @@ void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int
 
     int is_incomplete = (value >> 52) & 0x1;
     int err_code = (value >> 50) & 0x3;
-    if (gPrintLevel >= 1) {
-      fprintf(flog, "cru: %d  dpw: %d  link: %d  ds: %d  incomplete: %d  err: %d\n",
+    if (ctx.printLevel >= 1) {
+      fprintf(ctx.log, "cru: %d  dpw: %d  link: %d  ds: %d  incomplete: %d  err: %d\n",
               cru_id, dpw_id, link_id, ds_id, is_incomplete, err_code);
-      fprintf(flog, "14 bits: %016" PRIu64 "\n", (value >> 50) & 0xFFF);
-      fprintf(flog, "50 bits: %016" PRIu64 "\n", value & 0x3FFFFFFFFFFFF);
-
-      fprintf(flog, "10 bits:\n");
-      fprintf(flog, "    %" PRIu64 "\n", value & 0x3FF);
-      fprintf(flog, "    %" PRIu64 "\n", (value >> 10) & 0x3FF);
-      fprintf(flog, "    %" PRIu64 "\n", (value >> 20) & 0x3FF);
-      fprintf(flog, "    %" PRIu64 "\n", (value >> 30) & 0x3FF);
-      fprintf(flog, "    %" PRIu64 "\n", (value >> 40) & 0x3FF);
-      fprintf(flog, "DS status: %d\n", ds[cru_id][link_id][ds_id].status);
+      fprintf(ctx.log, "14 bits: %016" PRIu64 "\n", (value >> 50) & 0xFFF);
+      fprintf(ctx.log, "50 bits: %016" PRIu64 "\n", value & 0x3FFFFFFFFFFFF);
+
+      fprintf(ctx.log, "10 bits:\n");
+      fprintf(ctx.log, "    %" PRIu64 "\n", value & 0x3FF);
+      fprintf(ctx.log, "    %" PRIu64 "\n", (value >> 10) & 0x3FF);
+      fprintf(ctx.log, "    %" PRIu64 "\n", (value >> 20) & 0x3FF);
+      fprintf(ctx.log, "    %" PRIu64 "\n", (value >> 30) & 0x3FF);
+      fprintf(ctx.log, "    %" PRIu64 "\n", (value >> 40) & 0x3FF);
+      fprintf(ctx.log, "DS status: %d\n", ds[cru_id][link_id][ds_id].status);
     }
     if (link_id < 0 || link_id >= 24 || ds_id < 0 || ds_id >= 40) {
-      fprintf(flog, "ERROR: wrong DS board address    cru: %d  dpw: %d  link: %d  ds: %d\n",
+      fprintf(ctx.log, "ERROR: wrong DS board address    cru: %d  dpw: %d  link: %d  ds: %d\n",
               cru_id, dpw_id, link_id, ds_id);
       continue;
     }
@@ -1097,19 +1348,19 @@ void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int
     bool skip = false;
     for (int b = 0; b < 50; b += 10) {
 
-      decode_state_t state = Add10BitsOfData((value >> b) & 0x3FF, ds[cru_id][link_id][ds_id], &dsg[cru_id][link_id][ds_id / 8]);
+      decode_state_t state = Add10BitsOfData((value >> b) & 0x3FF, ds[cru_id][link_id][ds_id], &dsg[cru_id][link_id][ds_id / 8], ctx);
       switch (state) {
         case DECODE_STATE_SYNC_FOUND:
           break;
         case DECODE_STATE_HEADER_FOUND:
           uint64_t _h;
           memcpy(&_h, &(ds[cru_id][link_id][ds_id].header), sizeof(ds[cru_id][link_id][ds_id].header));
-          if (gPrintLevel >= 1)
-            fprintf(flog, "HEADER: %05" PRIu64 "\n", _h);
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "HEADER: %05" PRIu64 "\n", _h);
           break;
         case DECODE_STATE_CSIZE_FOUND: {
-          if (gPrintLevel >= 1)
-            fprintf(flog, "CLUSTER SIZE: %d\n", ds[cru_id][link_id][ds_id].csize);
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "CLUSTER SIZE: %d\n", ds[cru_id][link_id][ds_id].csize);
           Sampa::SampaHeaderStruct& header = ds[cru_id][link_id][ds_id].header;
           SampaHit& hit = ds[cru_id][link_id][ds_id].hit;
           hit.cru_id = cru_id;
@@ -1119,35 +1370,35 @@ void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int
           hit.chan_addr = header.fChannelAddress + 32 * chip_id;
           hit.bxc = header.fBunchCrossingCounter;
           hit.size = ds[cru_id][link_id][ds_id].csize;
-          hit.samples.clear();
+          ds[cru_id][link_id][ds_id].samples.clear();
           hit.csum = 0;
           hit.time = 0;
           break;
         }
         case DECODE_STATE_CTIME_FOUND:
-          if (gPrintLevel >= 1)
-            fprintf(flog, "CLUSTER TIME: %d\n", ds[cru_id][link_id][ds_id].ctime);
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "CLUSTER TIME: %d\n", ds[cru_id][link_id][ds_id].ctime);
           ds[cru_id][link_id][ds_id].hit.time = ds[cru_id][link_id][ds_id].ctime;
           break;
         case DECODE_STATE_SAMPLE_FOUND:
         case DECODE_STATE_END_OF_CLUSTER:
         case DECODE_STATE_END_OF_PACKET: {
           SampaHit& hit = ds[cru_id][link_id][ds_id].hit;
-          if (gPrintLevel >= 1)
-            fprintf(flog, "SAMPLE: %X\n", ds[cru_id][link_id][ds_id].sample);
-          hit.samples.push_back(ds[cru_id][link_id][ds_id].sample);
+          if (ctx.printLevel >= 1)
+            fprintf(ctx.log, "SAMPLE: %X\n", ds[cru_id][link_id][ds_id].sample);
+          ds[cru_id][link_id][ds_id].samples.push_back(ds[cru_id][link_id][ds_id].sample);
           hit.csum += ds[cru_id][link_id][ds_id].sample;
 
           if (state == DECODE_STATE_END_OF_CLUSTER ||
               state == DECODE_STATE_END_OF_PACKET) {
-            mHits.push_back(hit);
+            StoreHit(ds[cru_id][link_id][ds_id], hits, samples);
             if (hit.link_id >= 24) {
               fprintf(stdout, "hit: link_id=%d, ds_addr=%d, chan_addr=%d\n",
                       hit.link_id, hit.ds_addr, hit.chan_addr);
               getchar();
             }
             hit.size = 0;
-            hit.samples.clear();
+            ds[cru_id][link_id][ds_id].samples.clear();
             hit.csum = 0;
             hit.time = 0;
           }
@@ -1165,38 +1416,89 @@ void Decoder::decodeUL(uint32_t* payload_buf_32, size_t nWords, int cru_id, int
   }
 }
 
-void Decoder::processData(const char* buf, size_t size)
+// Channel number on the MANU card, for each channel of the dual SAMPA board
+int DsToManuChannel(int dsch)
 {
-  int RDH_BLOCK_SIZE = 8192;
-
-  int manu2ds[64] = {
+  static const std::array<int, 64> ds2manu = [] {
+    const int manu2ds[64] = {
       63, 62, 61, 60, 59, 57, 56, 53, 51, 50, 47, 45, 44, 41, 38, 35,
       36, 33, 34, 37, 32, 39, 40, 42, 43, 46, 48, 49, 52, 54, 55, 58,
       7, 8, 5, 2, 6, 1, 3, 0, 4, 9, 10, 15, 17, 18, 22, 25,
       31, 30, 29, 28, 27, 26, 24, 23, 20, 21, 16, 19, 12, 14, 11, 13};
+    std::array<int, 64> table{};
+    for (int j = 0; j < 64; j++) {
+      table[manu2ds[j]] = j;
+    }
+    return table;
+  }();
+  return ds2manu[dsch];
+}
 
-  int ds2manu[64];
-  for (int i = 0; i < 64; i++) {
+void Decoder::resetLink(int cru_id, int link_id, DecodingContext& ctx)
+{
+  for (int i = 0; i < 40; i++) {
+    DualSampaReset(&(ds[cru_id][link_id][i]), ctx);
+    ds[cru_id][link_id][i].id = i;
+    ds[cru_id][link_id][i].nbHit = -1;
     for (int j = 0; j < 64; j++) {
-      if (manu2ds[j] != i)
-        continue;
-      ds2manu[i] = j;
-      break;
+      ds[cru_id][link_id][i].nbHitChan[j] = 0;
     }
   }
+  for (int i = 0; i < 8; i++) {
+    DualSampaGroupReset(&(dsg[cru_id][link_id][i]));
+  }
+}
 
-  const RDH* rdh = (const RDH*)buf;
-  uint32_t payload_offset = 0;
-  if (size < sizeof(RDH))
-    return;
+void Decoder::processHits(std::vector<SampaHit>& hits, size_t firstHit, std::vector<o2::mch::Digit>& digits)
+{
+  for (size_t ih = firstHit; ih < hits.size(); ih++) {
+    SampaHit& hit = hits[ih];
+    hit.pad.fDE = -1;
+    hit.pad.fCathode = 0;
+    hit.chan_addr = DsToManuChannel(hit.chan_addr);
+
+    int32_t link_id = mMapCRU.getLink(hit.cru_id, hit.link_id);
+    if (link_id < 0)
+      continue;
 
-  while (payload_offset < size) {
+    if (!mMapFEC.getPadByLinkID(link_id, hit.ds_addr, hit.chan_addr, hit.pad))
+      continue;
 
-    if (gPrintLevel >= 1)
-      fprintf(flog, "CRU payload_offset: %d, size: %d\n", (int)payload_offset, (int)size);
+    digits.emplace_back(o2::mch::Digit(hit.pad.fDE, hit.pad.fAddress, hit.csum, o2::mch::Digit::Time{}));
+  }
+}
+
+void Decoder::processData(const char* buf, size_t size)
+{
+  // A CRU page, with the links whose decoding has to be reset before decoding it
+  struct Page {
+    uint32_t* payload;
+    size_t payloadSize;
+    int cruId;
+    int linkId; // link inside the CRU (0-23)
+    int dpwId;
+    bool isRaw; // raw data or user logic
+    uint32_t resetLinks; // bit mask of the links
+  };
+
+  // First pass: find the pages and the orbit jumps which reset the decoding of the links.
+  // The resets of a link are postponed to its next page, as nothing else modifies its state in the meantime.
+  std::vector<Page> pages;
+  pages.reserve(size / 8192 + 1);
+  std::array<std::array<bool, 24>, MCH_MAX_CRU_ID> pendingResets;
+  for (auto& links : pendingResets) {
+    links.fill(false);
+  }
 
-    uint32_t* payload_buf = (uint32_t*)(buf + 16 * 4);
-    //fprintf(stdout,"[processData] payload_buf=%p\n", (void*)payload_buf);
+  // the next buffer is expected to contain about as many hits as this one
+  size_t nHitsBefore = mHits.size();
+  size_t nSamplesBefore = mSamples.size();
+  mHits.reserve(nHitsBefore + mNHitsLastBuffer);
+  mSamples.reserve(nSamplesBefore + mNSamplesLastBuffer);
+
+  size_t offset = 0;
+  while (offset + sizeof(RDH) <= size) {
+    const RDH* rdh = (const RDH*)(buf + offset);
 
     auto rdhVersion = o2::raw::RDHUtils::getVersion(rdh);
     auto rdhHeaderSize = o2::raw::RDHUtils::getHeaderSize(rdh);
@@ -1208,44 +1510,29 @@ void Decoder::processData(const char* buf, size_t size)
     int dpwId = o2::raw::RDHUtils::getEndPointID(rdh);
     auto rdhOrbit = o2::raw::RDHUtils::getHeartBeatOrbit(rdh);
     auto packetCounter = o2::raw::RDHUtils::getPacketCounter(rdh);
-    if (gPrintLevel >= 1)
-      fprintf(flog, "%d:  header_version: %X, header_size: %d, memory_size: %d, next_packet_offset: %d, block_length: %d, packet: %d, cru_id: %d, link_id: %d, orbit: %d\n",
+    if (mContext.printLevel >= 1)
+      fprintf(mContext.log, "%d:  header_version: %X, header_size: %d, memory_size: %d, next_packet_offset: %d, block_length: %d, packet: %d, cru_id: %d, link_id: %d, orbit: %d\n",
               nFrames, (int)rdhVersion, (int)rdhHeaderSize, (int)memorySize,
               (int)frameSize, (int)payloadSize, (int)packetCounter, (int)cruId, (int)rdhLinkId, (int)rdhOrbit);
 
     // Check RDH version and size
     if (rdhVersion < 4 || rdhVersion > 6) {
       QcInfoLogger::GetInstance() << "[Decoder::processData] Wrong CRU header version: " << (int)rdhVersion << AliceO2::InfoLogger::InfoLogger::endm;
-      return;
+      break;
     }
     if (rdhHeaderSize != 64) {
       QcInfoLogger::GetInstance() << "[Decoder::processData] Wrong CRU header size: " << (int)rdhHeaderSize << AliceO2::InfoLogger::InfoLogger::endm;
-      return;
+      break;
+    }
+    if (frameSize == 0 || memorySize < rdhHeaderSize || offset + memorySize > size) {
+      QcInfoLogger::GetInstance() << "[Decoder::processData] Wrong CRU page size: " << (int)frameSize << ", " << (int)memorySize << AliceO2::InfoLogger::InfoLogger::endm;
+      break;
+    }
+    if (cruId < 0 || cruId >= MCH_MAX_CRU_ID) {
+      QcInfoLogger::GetInstance() << "[Decoder::processData] Wrong CRU ID: " << cruId << AliceO2::InfoLogger::InfoLogger::endm;
+      offset += frameSize;
+      continue;
     }
-
-    // Compute size of payload inside 8kB block
-    RDH_BLOCK_SIZE = frameSize;
-
-    rdh += RDH_BLOCK_SIZE;
-    payload_offset += RDH_BLOCK_SIZE;
-
-    //fprintf(flog, "CRU header: %08X %08X %08X %08X \n", CRUbuf[0], CRUbuf[1], CRUbuf[2], CRUbuf[3]);
-    //fprintf(flog, "CRU header: %08X %08X %08X %08X \n", CRUbuf[4], CRUbuf[5], CRUbuf[6], CRUbuf[7]);
-    //fprintf(flog, "CRU header: %08X %08X %08X %08X \n", CRUbuf[8], CRUbuf[9], CRUbuf[10], CRUbuf[11]);
-    //fprintf(flog, "CRU header: %08X %08X %08X %08X \n", CRUbuf[12], CRUbuf[13], CRUbuf[14], CRUbuf[15]);
-    //fprintf(flog, "CRU header version: %d\n", (int)CRUh.header_version);
-    //fprintf(flog, "CRU header size: %d\n", (int)CRUh.header_size);
-    //fprintf(flog, "CRU header block length: %d\n", (int)CRUh.block_length);
-    if (gPrintLevel >= 3)
-      fprintf(flog, "CRU packet counter: %d\n", (int)packetCounter);
-    if (gPrintLevel >= 3)
-      fprintf(flog, "CRU orbit id: %d\n", (int)rdhOrbit);
-    if (gPrintLevel >= 1)
-      fprintf(flog, "CRU link ID: %d\n", (int)rdhLinkId);
-    if (gPrintLevel >= 1)
-      fprintf(flog, "CRU ID: %d\n", (int)cruId);
-    if (gPrintLevel >= 1)
-      fprintf(flog, "DPW ID: %d\n", (int)dpwId);
 
     nFrames += 1;
 
@@ -1262,63 +1549,131 @@ void Decoder::processData(const char* buf, size_t size)
     if (true && orbit_jump) {
       int lid_min = (rdhLinkId == 15) ? dpwId * 12 : 0;
       int lid_max = (rdhLinkId == 15) ? 11 + dpwId * 12 : 23;
-      if (gPrintLevel >= 1)
-        fprintf(flog, "Resetting decoding FSM: orbit=%d, previous=%d, links=%d-%d\n",
-            rdhOrbit, hb_orbit, lid_min, lid_max);
-      for (int l = lid_min; l <= lid_max; l++) {
-        for (int i = 0; i < 40; i++) {
-          DualSampaReset(&(ds[cruId][l][i]));
-          ds[cruId][l][i].id = i;
-          ds[cruId][l][i].nbHit = -1;
-          for (int j = 0; j < 64; j++) {
-            ds[cruId][l][i].nbHitChan[j] = 0;
-          }
-        }
-        for (int i = 0; i < 8; i++) {
-          DualSampaGroupReset(&(dsg[cruId][l][i]));
-        }
+      if (mContext.printLevel >= 1)
+        fprintf(mContext.log, "Resetting decoding FSM: orbit=%d, previous=%d, links=%d-%d\n",
+                rdhOrbit, hb_orbit, lid_min, lid_max);
+      for (int l = lid_min; l <= lid_max && l < 24; l++) {
+        pendingResets[cruId][l] = true;
       }
     }
     hb_orbit = rdhOrbit;
 
-    int nGBTwords = payloadSize / 16;
-    int n64bitWords = payloadSize / 8;
+    Page page{ (uint32_t*)(buf + offset + rdhHeaderSize), (size_t)payloadSize, cruId, cru_lid, dpwId, is_raw, 0 };
+    int lid_first = is_raw ? cru_lid : dpwId * 12;
+    int lid_last = is_raw ? cru_lid : 11 + dpwId * 12;
+    for (int l = lid_first; l <= lid_last && l < 24; l++) {
+      if (pendingResets[cruId][l]) {
+        page.resetLinks |= 1 << l;
+        pendingResets[cruId][l] = false;
+      }
+    }
+    pages.push_back(page);
 
-    if (gPrintLevel >= 1)
-      fprintf(flog, "Starting to decode buffer...\n");
-    if (is_raw)
-      decodeRaw(payload_buf, nGBTwords, cruId, cru_lid);
-    else
-      decodeUL(payload_buf, n64bitWords, cruId, dpwId);
-
-    if (gPrintLevel >= 1)
-      fprintf(flog, "mHits.size(): %d\n", (int)mHits.size());
-    for (size_t ih = 0; ih < mHits.size(); ih++) {
-      SampaHit& hit = mHits[ih];
-      hit.pad.fDE = -1;
-      hit.pad.fCathode = 0;
-      int manuch = ds2manu[hit.chan_addr];
-      hit.chan_addr = manuch;
-
-      int32_t link_id = mMapCRU.getLink(hit.cru_id, hit.link_id);
-      if (link_id < 0)
-        continue;
-      //printf("cru_id=%d link_id=%d  LID=%d\n", (int)hit.cru_id, (int)hit.link_id, (int)link_id);
+    offset += frameSize;
+  }
 
-      if (!mMapFEC.getPadByLinkID(link_id, hit.ds_addr, hit.chan_addr, hit.pad))
-        continue;
+  auto decodePage = [this](const Page& page, DecodingContext& ctx, std::vector<SampaHit>& hits, std::vector<uint16_t>& samples, std::vector<o2::mch::Digit>& digits) {
+    for (int l = 0; l < 24; l++) {
+      if ((page.resetLinks >> l) & 0x1)
+        resetLink(page.cruId, l, ctx);
+    }
+    size_t firstHit = hits.size();
+    if (ctx.printLevel >= 1)
+      fprintf(ctx.log, "Starting to decode buffer...\n");
+    if (page.isRaw) {
+      if (mBitSerialDecoding)
+        decodeRaw(page.payload, page.payloadSize / 16, page.cruId, page.linkId, ctx, hits, samples);
+      else
+        decodeRawWords(page.payload, page.payloadSize / 16, page.cruId, page.linkId, ctx, hits, samples);
+    } else {
+      decodeUL(page.payload, page.payloadSize / 8, page.cruId, page.dpwId, ctx, hits, samples);
+    }
+    if (ctx.printLevel >= 1)
+      fprintf(ctx.log, "mHits.size(): %d\n", (int)hits.size());
+    processHits(hits, firstHit, digits);
+  };
+
+  // The pages are grouped such that all the pages of a link are decoded in order by the same thread.
+  // The user logic pages contain the data of all the links of the end point.
+  bool hasUL = std::any_of(pages.begin(), pages.end(), [](const Page& page) { return !page.isRaw; });
+  std::map<int, std::vector<size_t>> groups;
+  if (mNThreads > 1) {
+    for (size_t ip = 0; ip < pages.size(); ip++) {
+      const Page& page = pages[ip];
+      int link = (!page.isRaw) ? page.dpwId * 12 : (hasUL ? (page.linkId / 12) * 12 : page.linkId);
+      groups[page.cruId * 24 + link].push_back(ip);
+    }
+  }
 
-      mDigits.emplace_back(o2::mch::Digit(hit.pad.fDE, hit.pad.fAddress, hit.csum, o2::mch::Digit::Time{}));
+  if (groups.size() <= 1) {
+    for (const auto& page : pages) {
+      decodePage(page, mContext, mHits, mSamples, mDigits);
+    }
+  } else {
+    struct GroupOutput {
+      std::vector<size_t> pages;
+      DecodingContext ctx;
+      std::vector<SampaHit> hits;
+      std::vector<uint16_t> samples;
+      std::vector<o2::mch::Digit> digits;
+    };
+    std::vector<GroupOutput> outputs(groups.size());
+    size_t ig = 0;
+    for (auto& group : groups) {
+      outputs[ig].pages = std::move(group.second);
+      outputs[ig].ctx = mContext;
+      outputs[ig].ctx.nbErrors = 0;
+      outputs[ig].ctx.nbWarnings = 0;
+      ig += 1;
+    }
 
+    std::atomic<size_t> nextGroup{ 0 };
+    auto worker = [&]() {
+      for (size_t g = nextGroup++; g < outputs.size(); g = nextGroup++) {
+        for (size_t ip : outputs[g].pages) {
+          decodePage(pages[ip], outputs[g].ctx, outputs[g].hits, outputs[g].samples, outputs[g].digits);
+        }
+      }
+    };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < std::min<int>(mNThreads, outputs.size()); t++) {
+      threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (auto& output : outputs) {
+      for (auto& hit : output.hits) {
+        hit.sampleOffset += mSamples.size();
+      }
+      mHits.insert(mHits.end(), output.hits.begin(), output.hits.end());
+      mSamples.insert(mSamples.end(), output.samples.begin(), output.samples.end());
+      mDigits.insert(mDigits.end(), output.digits.begin(), output.digits.end());
+      mContext.nbErrors += output.ctx.nbErrors;
+      mContext.nbWarnings += output.ctx.nbWarnings;
     }
-    if (gPrintLevel >= 1)
-      fprintf(flog, "Finished processing hits\n");
   }
+
+  // resets of the links which did not have any more pages in this buffer
+  for (int c = 0; c < MCH_MAX_CRU_ID; c++) {
+    for (int l = 0; l < 24; l++) {
+      if (pendingResets[c][l])
+        resetLink(c, l, mContext);
+    }
+  }
+
+  mNHitsLastBuffer = mHits.size() - nHitsBefore;
+  mNSamplesLastBuffer = mSamples.size() - nSamplesBefore;
+
+  if (mContext.printLevel >= 1)
+    fprintf(mContext.log, "Finished processing hits\n");
 }
 
 void Decoder::clearHits()
 {
   mHits.clear();
+  mSamples.clear();
 }
 
 void Decoder::clearDigits()
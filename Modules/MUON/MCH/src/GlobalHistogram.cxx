@@ -57,32 +57,24 @@ void GlobalHistogram::init()
   line = new TLine(NXHIST_PER_STATION * DE_WIDTH * 2, 0, NXHIST_PER_STATION * DE_WIDTH * 2, HIST_HEIGHT);
   GetListOfFunctions()->Add(line);
 
-  for(int de = 500; de < 1100; de++) {
-    const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(de);
-    if ((&segment) == nullptr) {
-      continue;
-    }
-    const o2::mch::mapping::CathodeSegmentation& csegment = segment.bending();
-    o2::mch::contour::Contour<double> envelop = o2::mch::mapping::getEnvelop(csegment);
-    std::vector<o2::mch::contour::Vertex<double>> vertices = envelop.getVertices();
-
-    float xB0, yB0, xNB0, yNB0;
-    getDeCenter(de, xB0, yB0, xNB0, yNB0);
-    bool isR = getLR(de) == 1;
+  const DERegistry<DEGeometry>& geometry = getGeometry();
+  for (size_t index = 0; index < geometry.size(); index++) {
+    const DEGeometry& g = geometry.at(index);
+    const auto& vertices = g.envelope;
 
     for (unsigned int vi = 0; vi < vertices.size(); vi++) {
-      const o2::mch::contour::Vertex<double> v1 = vertices[vi];
-      const o2::mch::contour::Vertex<double> v2 = (vi < (vertices.size() - 1)) ? vertices[vi + 1] : vertices[0];
+      const auto& v1 = vertices[vi];
+      const auto& v2 = (vi < (vertices.size() - 1)) ? vertices[vi + 1] : vertices[0];
 
-      if (isR) {
-      line = new TLine(-v1.x+xB0, v1.y+yB0, -v2.x+xB0, v2.y+yB0);
+      if (g.swapX) {
+      line = new TLine(-v1.first+g.xB0, v1.second+g.yB0, -v2.first+g.xB0, v2.second+g.yB0);
       GetListOfFunctions()->Add(line);
-      line = new TLine(-v1.x+xNB0, v1.y+yNB0, -v2.x+xNB0, v2.y+yNB0);
+      line = new TLine(-v1.first+g.xNB0, v1.second+g.yNB0, -v2.first+g.xNB0, v2.second+g.yNB0);
       GetListOfFunctions()->Add(line);
       } else {
-        line = new TLine(v1.x+xB0, v1.y+yB0, v2.x+xB0, v2.y+yB0);
+        line = new TLine(v1.first+g.xB0, v1.second+g.yB0, v2.first+g.xB0, v2.second+g.yB0);
         GetListOfFunctions()->Add(line);
-        line = new TLine(v1.x+xNB0, v1.y+yNB0, v2.x+xNB0, v2.y+yNB0);
+        line = new TLine(v1.first+g.xNB0, v1.second+g.yNB0, v2.first+g.xNB0, v2.second+g.yNB0);
         GetListOfFunctions()->Add(line);
       }
     }
@@ -90,6 +82,31 @@ void GlobalHistogram::init()
 }
 
 
+const DERegistry<GlobalHistogram::DEGeometry>& GlobalHistogram::getGeometry()
+{
+  static const DERegistry<DEGeometry> geometry = [] {
+    DERegistry<DEGeometry> result;
+    for(int de = 500; de < 1100; de++) {
+      const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(de);
+      if ((&segment) == nullptr) {
+        continue;
+      }
+      DEGeometry& g = result[de];
+      getDeCenter(de, g.xB0, g.yB0, g.xNB0, g.yNB0);
+      g.swapX = getLR(de) == 1;
+
+      const o2::mch::mapping::CathodeSegmentation& csegment = segment.bending();
+      o2::mch::contour::Contour<double> envelop = o2::mch::mapping::getEnvelop(csegment);
+      for (const auto& v : envelop.getVertices()) {
+        g.envelope.emplace_back(v.x, v.y);
+      }
+    }
+    return result;
+  }();
+  return geometry;
+}
+
+
 void GlobalHistogram::getDeCenter(int de, float& xB0, float& yB0, float& xNB0, float& yNB0)
 {
   if ((de >= 500) && (de < 700)) {
@@ -338,50 +355,130 @@ void GlobalHistogram::getDeCenterST5(int de, float& xB0, float& yB0, float& xNB0
 }
 
 
-void GlobalHistogram::add(std::map<int, TH2F*>& histB, std::map<int, TH2F*>& histNB)
+void GlobalHistogram::add(DERegistry<TH2F*>& histB, DERegistry<TH2F*>& histNB)
 {
   set(histB, histNB, false);
 }
 
 
-void GlobalHistogram::set(std::map<int, TH2F*>& histB, std::map<int, TH2F*>& histNB, bool doAverage)
+bool GlobalHistogram::BinMapping::matches(TH2F* source) const
+{
+  return (nBinsX == source->GetXaxis()->GetNbins()) && (xMin == source->GetXaxis()->GetXmin()) && (xMax == source->GetXaxis()->GetXmax()) &&
+         (nBinsY == source->GetYaxis()->GetNbins()) && (yMin == source->GetYaxis()->GetXmin()) && (yMax == source->GetYaxis()->GetXmax());
+}
+
+
+void GlobalHistogram::buildMapping(BinMapping& mapping, TH2F* source, float x0, float y0, bool swapX)
+{
+  mapping.nBinsX = source->GetXaxis()->GetNbins();
+  mapping.xMin = source->GetXaxis()->GetXmin();
+  mapping.xMax = source->GetXaxis()->GetXmax();
+  mapping.nBinsY = source->GetYaxis()->GetNbins();
+  mapping.yMin = source->GetYaxis()->GetXmin();
+  mapping.yMax = source->GetYaxis()->GetXmax();
+  mapping.bins.clear();
+  mapping.offsets.clear();
+  mapping.sourceBins.clear();
+
+  float xMin = x0 - DE_WIDTH / 2;
+  float xMax = x0 + DE_WIDTH / 2;
+  float yMin = y0 - DE_HEIGHT / 2;
+  float yMax = y0 + DE_HEIGHT / 2;
+
+  //std::cout<<"DE LIMITS "<<xMin<<" "<<xMax<<", "<<yMin<<" "<<yMax<<std::endl;
+
+  float binWidthX = GetXaxis()->GetBinWidth(1);
+  float binWidthY = GetYaxis()->GetBinWidth(1);
+
+  // loop on destination bins
+  int binXmin = GetXaxis()->FindBin(xMin + binWidthX/2);
+  int binXmax = GetXaxis()->FindBin(xMax - binWidthX/2);
+  int binYmin = GetYaxis()->FindBin(yMin + binWidthY/2);
+  int binYmax = GetYaxis()->FindBin(yMax - binWidthY/2);
+
+  //std::cout<<"BIN LIMITS "<<binXmin<<" "<<binXmax<<", "<<binYmin<<" "<<binYmax<<std::endl;
+
+  for(int by = binYmin; by <= binYmax; by++) {
+    // vertical boundaries of current bin, in DE coordinates
+    float minY = GetYaxis()->GetBinLowEdge(by) - y0;
+    float maxY = GetYaxis()->GetBinUpEdge(by)  - y0;
+
+    // find Y bin range in source histogram
+    int srcBinYmin = source->GetYaxis()->FindBin(minY);
+    if (source->GetYaxis()->GetBinCenter(srcBinYmin) < minY) {
+      srcBinYmin += 1;
+    }
+    int srcBinYmax = source->GetYaxis()->FindBin(maxY);
+    if (source->GetYaxis()->GetBinCenter(srcBinYmax) > maxY) {
+      srcBinYmax -= 1;
+    }
+
+    for(int bx = binXmin; bx <= binXmax; bx++) {
+      // horizontal boundaries of current bin, in DE coordinates
+      float minX = GetXaxis()->GetBinLowEdge(bx) - x0;
+      float maxX = GetXaxis()->GetBinUpEdge(bx)  - x0;
+
+      if (swapX) {
+        float tempMax = -minX;
+        float tempMin = -maxX;
+        minX = tempMin;
+        maxX = tempMax;
+      }
+
+      // find X bin range in source histogram
+      int srcBinXmin = source->GetXaxis()->FindBin(minX);
+      if (source->GetXaxis()->GetBinCenter(srcBinXmin) < minX) {
+        srcBinXmin += 1;
+      }
+      int srcBinXmax = source->GetXaxis()->FindBin(maxX);
+      if (source->GetXaxis()->GetBinCenter(srcBinXmax) > maxX) {
+        srcBinXmax -= 1;
+      }
+
+      mapping.bins.push_back(GetBin(bx, by));
+      mapping.offsets.push_back(mapping.sourceBins.size());
+      for(int sby = srcBinYmin; sby <= srcBinYmax; sby++) {
+        for(int sbx = srcBinXmin; sbx <= srcBinXmax; sbx++) {
+          mapping.sourceBins.push_back(source->GetBin(sbx, sby));
+        }
+      }
+    }
+  }
+  mapping.offsets.push_back(mapping.sourceBins.size());
+}
+
+
+void GlobalHistogram::set(DERegistry<TH2F*>& histB, DERegistry<TH2F*>& histNB, bool doAverage)
 {
-  for(auto& ih : histB) {
-    int de = ih.first;
+  const DERegistry<DEGeometry>& geometry = getGeometry();
+
+  for(size_t ih = 0; ih < histB.size(); ih++) {
+    int de = histB.getDE(ih);
     //if (de != 819) continue;
     if (de < 500) continue;
     if (de >= 1100) continue;
-    auto hB = ih.second;
+    auto hB = histB.at(ih);
     if (!hB) {
       continue;
     }
 
-    bool swapX = getLR(de) == 1;
+    const DEGeometry* g = geometry.find(de);
+    if (!g) {
+      continue;
+    }
 
     TH2F* hNB = nullptr;
     auto jh = histNB.find(de);
-    if (jh != histNB.end()) {
-      hNB = jh->second;
+    if (jh) {
+      hNB = *jh;
     }
 
     TH2F* hist[2] = {hB, hNB};
 
-    float xB0, yB0, xNB0, yNB0;
-    getDeCenter(de, xB0, yB0, xNB0, yNB0);
-
-    float x0[2] = {xB0, xNB0};
-    float y0[2] = {yB0, yNB0};
-
-    float xMin[2] = {xB0 - DE_WIDTH / 2, xNB0 - DE_WIDTH / 2};
-    float xMax[2] = {xB0 + DE_WIDTH / 2, xNB0 + DE_WIDTH / 2};
-    float yMin[2] = {yB0 - DE_HEIGHT / 2, yNB0 - DE_HEIGHT / 2};
-    float yMax[2] = {yB0 + DE_HEIGHT / 2, yNB0 + DE_HEIGHT / 2};
-
-    //std::cout<<"DE "<<de<<"B   LIMITS "<<xMin[0]<<" "<<xMax[0]<<", "<<yMin[0]<<" "<<yMax[0]<<std::endl;
-    //std::cout<<"DE "<<de<<"NB  LIMITS "<<xMin[1]<<" "<<xMax[1]<<", "<<yMin[1]<<" "<<yMax[1]<<std::endl;
+    float x0[2] = {g->xB0, g->xNB0};
+    float y0[2] = {g->yB0, g->yNB0};
 
-    float binWidthX = GetXaxis()->GetBinWidth(1);
-    float binWidthY = GetYaxis()->GetBinWidth(1);
+    DEState& state = mDEStates[de];
 
     // loop on bending and non-bending planes
     for (int i = 0; i < 2; i++) {
@@ -390,73 +487,40 @@ void GlobalHistogram::set(std::map<int, TH2F*>& histB, std::map<int, TH2F*>& his
         continue;
       }
 
-      // loop on destination bins
-      int binXmin = GetXaxis()->FindBin(xMin[i] + binWidthX/2);
-      int binXmax = GetXaxis()->FindBin(xMax[i] - binWidthX/2);
-      int binYmin = GetYaxis()->FindBin(yMin[i] + binWidthY/2);
-      int binYmax = GetYaxis()->FindBin(yMax[i] - binWidthY/2);
-
-      //std::cout<<(i==0 ? "B " : "NB")<<"  BIN LIMITS "<<binXmin<<" "<<binXmax<<", "<<binYmin<<" "<<binYmax<<std::endl;
-
-      for(int by = binYmin; by <= binYmax; by++) {
-        // vertical boundaries of current bin, in DE coordinates
-        float minY = GetYaxis()->GetBinLowEdge(by) - y0[i];
-        float maxY = GetYaxis()->GetBinUpEdge(by)  - y0[i];
-
-        // find Y bin range in source histogram
-        int srcBinYmin = hist[i]->GetYaxis()->FindBin(minY);
-        if (hist[i]->GetYaxis()->GetBinCenter(srcBinYmin) < minY) {
-          srcBinYmin += 1;
-        }
-        int srcBinYmax = hist[i]->GetYaxis()->FindBin(maxY);
-        if (hist[i]->GetYaxis()->GetBinCenter(srcBinYmax) > maxY) {
-          srcBinYmax -= 1;
-        }
-
-        for(int bx = binXmin; bx <= binXmax; bx++) {
-          // horizontal boundaries of current bin, in DE coordinates
-          float minX = GetXaxis()->GetBinLowEdge(bx) - x0[i];
-          float maxX = GetXaxis()->GetBinUpEdge(bx)  - x0[i];
-
-          if (swapX) {
-            float tempMax = -minX;
-            float tempMin = -maxX;
-            minX = tempMin;
-            maxX = tempMax;
-          }
+      if (mIncremental && state.source[i] == hist[i] && state.entries[i] == hist[i]->GetEntries() && state.doAverage == doAverage) {
+        continue;
+      }
 
-          // find X bin range in source histogram
-          int srcBinXmin = hist[i]->GetXaxis()->FindBin(minX);
-          if (hist[i]->GetXaxis()->GetBinCenter(srcBinXmin) < minX) {
-            srcBinXmin += 1;
-          }
-          int srcBinXmax = hist[i]->GetXaxis()->FindBin(maxX);
-          if (hist[i]->GetXaxis()->GetBinCenter(srcBinXmax) > maxX) {
-            srcBinXmax -= 1;
-          }
+      // the bins mapping is computed on the first update, and only recomputed if the source binning changes
+      BinMapping& mapping = state.mapping[i];
+      if (!mapping.matches(hist[i])) {
+        buildMapping(mapping, hist[i], x0[i], y0[i], g->swapX);
+      }
 
-          // loop on source bins, and compute the sum or average
-          int nBins = 0;
-          float tot = 0;
-          for(int sby = srcBinYmin; sby <= srcBinYmax; sby++) {
-            for(int sbx = srcBinXmin; sbx <= srcBinXmax; sbx++) {
-              float val = hist[i]->GetBinContent(sbx, sby);
-              if (val == 0) {
-                continue;
-              }
-              nBins += 1;
-              tot += val;
-            }
+      for (size_t bin = 0; bin < mapping.bins.size(); bin++) {
+        // loop on source bins, and compute the sum or average
+        int nBins = 0;
+        float tot = 0;
+        for (uint32_t sb = mapping.offsets[bin]; sb < mapping.offsets[bin + 1]; sb++) {
+          float val = hist[i]->GetBinContent(mapping.sourceBins[sb]);
+          if (val == 0) {
+            continue;
           }
+          nBins += 1;
+          tot += val;
+        }
 
-          if (doAverage && (nBins > 0)) {
-            tot /= nBins;
-          }
-          //if(de==800) std::cout<<"DE "<<de<<"  i "<<i<<"  by "<<by<<"  bx "<<bx<<" --> "<<tot<<std::endl;
-          SetBinContent(bx, by, tot);
+        if (doAverage && (nBins > 0)) {
+          tot /= nBins;
         }
+        //if(de==800) std::cout<<"DE "<<de<<"  i "<<i<<"  bin "<<mapping.bins[bin]<<" --> "<<tot<<std::endl;
+        SetBinContent(mapping.bins[bin], tot);
       }
+
+      state.source[i] = hist[i];
+      state.entries[i] = hist[i]->GetEntries();
     }
+    state.doAverage = doAverage;
   }
 }
 
@@ -11,6 +11,14 @@
 #include "MCHMappingInterface/Segmentation.h"
 #endif
 
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 using namespace std;
 
 #define MCH_PAD_ADDR_MAX 100000
@@ -194,6 +202,183 @@ bool MapFEC::getPadByDE(uint32_t de, uint32_t dsid, uint32_t dsch, MapPad& pad)
   return true;
 }
 
+/*
+ * Binary image of the mappings
+ */
+static const char sMappingCacheMagic[8] = { 'M', 'C', 'H', 'M', 'A', 'P', 'B', 0 };
+
+bool MappingCache::load(std::string cruMapFile, std::string fecMapFile, std::string cacheFile, MapCRU& mapCRU, MapFEC& mapFEC)
+{
+  if (read(cruMapFile, fecMapFile, cacheFile, mapCRU, mapFEC)) {
+    return true;
+  }
+
+  if (!mapCRU.readMapping(cruMapFile) || !mapFEC.readDSMapping(fecMapFile)) {
+    return false;
+  }
+  if (!write(cruMapFile, fecMapFile, cacheFile, mapCRU, mapFEC)) {
+    QcInfoLogger::GetInstance() << "[MappingCache::load] can't write file " << cacheFile << AliceO2::InfoLogger::InfoLogger::endm;
+  }
+  return true;
+}
+
+bool MappingCache::read(std::string cruMapFile, std::string fecMapFile, std::string cacheFile, MapCRU& mapCRU, MapFEC& mapFEC)
+{
+  int fd = open(cacheFile.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(Header)) {
+    close(fd);
+    return false;
+  }
+  size_t size = st.st_size;
+  void* image = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (image == MAP_FAILED) {
+    return false;
+  }
+
+  const char* data = static_cast<const char*>(image);
+  Header header;
+  memcpy(&header, data, sizeof(Header));
+  const char* entries = data + sizeof(Header);
+  size_t entriesSize = header.nLinks * sizeof(LinkEntry) + header.nBoards * sizeof(BoardEntry);
+
+  bool valid = memcmp(header.magic, sMappingCacheMagic, sizeof(header.magic)) == 0 &&
+               header.version == sVersion &&
+               size == sizeof(Header) + entriesSize &&
+               header.checksum == checksum(entries, entriesSize);
+
+  // the image is out of date if the text files it was generated from have changed
+  Header source;
+  fillSourceInfo(cruMapFile, fecMapFile, source);
+  for (int i = 0; valid && i < 2; i++) {
+    if (source.sourceSize[i] >= 0 && (source.sourceSize[i] != header.sourceSize[i] || source.sourceTime[i] != header.sourceTime[i])) {
+      valid = false;
+    }
+  }
+
+  if (valid) {
+    const LinkEntry* links = reinterpret_cast<const LinkEntry*>(entries);
+    for (uint32_t i = 0; i < header.nLinks; i++) {
+      if (links[i].cru >= MCH_MAX_CRU_IN_FLP || links[i].link >= 24) {
+        continue;
+      }
+      mapCRU.mSolarMap[links[i].cru][links[i].link].mLink = links[i].link_id;
+    }
+    const BoardEntry* boards = reinterpret_cast<const BoardEntry*>(entries + header.nLinks * sizeof(LinkEntry));
+    for (uint32_t i = 0; i < header.nBoards; i++) {
+      if (boards[i].link_id > LINKID_MAX || boards[i].ds_addr >= 40) {
+        continue;
+      }
+      MapDualSampa& ds = mapFEC.mDsMap[boards[i].link_id][boards[i].ds_addr];
+      ds.mDE = boards[i].de;
+      ds.mIndex = boards[i].dsid;
+      ds.mBad = 0;
+    }
+  }
+
+  munmap(image, size);
+  return valid;
+}
+
+bool MappingCache::write(std::string cruMapFile, std::string fecMapFile, std::string cacheFile, const MapCRU& mapCRU, const MapFEC& mapFEC)
+{
+  std::vector<LinkEntry> links;
+  for (int c = 0; c < MCH_MAX_CRU_IN_FLP; c++) {
+    for (int l = 0; l < 24; l++) {
+      int link_id = mapCRU.mSolarMap[c][l].mLink;
+      if (link_id < 0) {
+        continue;
+      }
+      if (link_id > LINKID_MAX) {
+        return false;
+      }
+      links.push_back({ (uint8_t)c, (uint8_t)l, (uint16_t)link_id });
+    }
+  }
+
+  std::vector<BoardEntry> boards;
+  for (int link_id = 0; link_id <= LINKID_MAX; link_id++) {
+    for (int ds_addr = 0; ds_addr < 40; ds_addr++) {
+      const MapDualSampa& ds = mapFEC.mDsMap[link_id][ds_addr];
+      if (ds.mBad != 0) {
+        continue;
+      }
+      if (ds.mDE < 0 || ds.mDE > UINT16_MAX || ds.mIndex < 0 || ds.mIndex > UINT16_MAX) {
+        return false;
+      }
+      boards.push_back({ (uint16_t)link_id, (uint16_t)ds_addr, (uint16_t)ds.mDE, (uint16_t)ds.mIndex });
+    }
+  }
+
+  std::vector<char> entries(links.size() * sizeof(LinkEntry) + boards.size() * sizeof(BoardEntry));
+  memcpy(entries.data(), links.data(), links.size() * sizeof(LinkEntry));
+  memcpy(entries.data() + links.size() * sizeof(LinkEntry), boards.data(), boards.size() * sizeof(BoardEntry));
+
+  Header header;
+  memset(&header, 0, sizeof(Header));
+  memcpy(header.magic, sMappingCacheMagic, sizeof(header.magic));
+  header.version = sVersion;
+  header.nLinks = links.size();
+  header.nBoards = boards.size();
+  header.checksum = checksum(entries.data(), entries.size());
+  fillSourceInfo(cruMapFile, fecMapFile, header);
+
+  // the image is renamed once complete, so that tasks starting at the same time never map a partial file
+  std::string tmpFile = cacheFile + ".tmp" + std::to_string(getpid());
+  std::ofstream file(tmpFile, std::ios::binary);
+  if (!file) {
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+  file.write(entries.data(), entries.size());
+  file.close();
+  if (!file || rename(tmpFile.c_str(), cacheFile.c_str()) != 0) {
+    unlink(tmpFile.c_str());
+    return false;
+  }
+  return true;
+}
+
+// modification time of a file in nanoseconds, the field holding it is not named the same on all the platforms
+static int64_t getModificationTime(const struct stat& st)
+{
+#if defined(__APPLE__)
+  return (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+  return (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+}
+
+void MappingCache::fillSourceInfo(std::string cruMapFile, std::string fecMapFile, Header& header)
+{
+  std::string files[2] = { cruMapFile, fecMapFile };
+  for (int i = 0; i < 2; i++) {
+    struct stat st;
+    if (stat(files[i].c_str(), &st) == 0) {
+      header.sourceSize[i] = st.st_size;
+      header.sourceTime[i] = getModificationTime(st);
+    } else {
+      header.sourceSize[i] = -1;
+      header.sourceTime[i] = -1;
+    }
+  }
+}
+
+uint32_t MappingCache::checksum(const char* data, size_t size)
+{
+  // FNV-1a
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < size; i++) {
+    hash ^= (uint8_t)data[i];
+    hash *= 16777619u;
+  }
+  return hash;
+}
+
 } // namespace muonchambers
 } // namespace quality_control_modules
 } // namespace o2
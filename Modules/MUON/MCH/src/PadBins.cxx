@@ -0,0 +1,65 @@
+///
+/// \file   PadBins.cxx
+///
+
+#include <TH2.h>
+
+#include "MCHMappingInterface/Segmentation.h"
+#ifdef MCH_HAS_MAPPING_FACTORY
+#include "MCHMappingFactory/CreateSegmentation.h"
+#endif
+#include "MCH/PadBins.h"
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+bool PadBins::init(int de, TH2* reference)
+{
+  mOffsets.clear();
+  mBins.clear();
+  mCathodes.clear();
+
+  try {
+    const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(de);
+
+    int nPads = segment.nofPads();
+    mOffsets.reserve(nPads + 1);
+    mCathodes.reserve(nPads);
+    for (int padid = 0; padid < nPads; padid++) {
+      double padX = segment.padPositionX(padid);
+      double padY = segment.padPositionY(padid);
+      float padSizeX = segment.padSizeX(padid);
+      float padSizeY = segment.padSizeY(padid);
+
+      // the pad edges are moved inwards, such that the pad only covers the bins which are fully inside it
+      int binx_min = reference->GetXaxis()->FindFixBin(padX - padSizeX / 2 + 0.1);
+      int binx_max = reference->GetXaxis()->FindFixBin(padX + padSizeX / 2 - 0.1);
+      int biny_min = reference->GetYaxis()->FindFixBin(padY - padSizeY / 2 + 0.1);
+      int biny_max = reference->GetYaxis()->FindFixBin(padY + padSizeY / 2 - 0.1);
+
+      mOffsets.push_back(mBins.size());
+      for (int by = biny_min; by <= biny_max; by++) {
+        for (int bx = binx_min; bx <= binx_max; bx++) {
+          mBins.push_back(reference->GetBin(bx, by));
+        }
+      }
+      mCathodes.push_back(segment.isBendingPad(padid) ? 0 : 1);
+    }
+    mOffsets.push_back(mBins.size());
+  } catch (const std::exception& e) {
+    mOffsets.clear();
+    mBins.clear();
+    mCathodes.clear();
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
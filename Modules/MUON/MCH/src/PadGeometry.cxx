@@ -0,0 +1,46 @@
+///
+/// \file   PadGeometry.cxx
+///
+
+#include "MCHMappingInterface/Segmentation.h"
+#ifdef MCH_HAS_MAPPING_FACTORY
+#include "MCHMappingFactory/CreateSegmentation.h"
+#endif
+#include "MCH/PadGeometry.h"
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+bool PadGeometry::init(int de)
+{
+  mPads.clear();
+
+  try {
+    const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(de);
+
+    int nPads = segment.nofPads();
+    mPads.reserve(nPads);
+    for (int padid = 0; padid < nPads; padid++) {
+      Pad pad;
+      pad.x = segment.padPositionX(padid);
+      pad.y = segment.padPositionY(padid);
+      pad.sizeX = segment.padSizeX(padid);
+      pad.sizeY = segment.padSizeY(padid);
+      pad.cathode = segment.isBendingPad(padid) ? 0 : 1;
+      mPads.push_back(pad);
+    }
+  } catch (const std::exception& e) {
+    mPads.clear();
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
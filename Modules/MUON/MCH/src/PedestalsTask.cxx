@@ -71,6 +71,60 @@ namespace quality_control_modules
 {
 namespace muonchambers
 {
+
+size_t PedestalAccumulators::addChannel()
+{
+  nSamples.push_back(0);
+  mean.push_back(0);
+  m2.push_back(0);
+  return nSamples.size() - 1;
+}
+
+void PedestalAccumulators::update(size_t index, const uint16_t* samples, uint32_t n)
+{
+  if (n == 0) {
+    return;
+  }
+
+  // the sums of the samples of the hit are exact, and the loop is vectorized
+  uint64_t sum = 0, sum2 = 0;
+  for (uint32_t s = 0; s < n; s++) {
+    uint32_t sample = samples[s];
+    sum += sample;
+    sum2 += sample * sample;
+  }
+  merge(index, n, sum, sum2);
+}
+
+void PedestalAccumulators::update(size_t index, const uint32_t* samples, uint32_t n)
+{
+  if (n == 0) {
+    return;
+  }
+
+  uint64_t sum = 0, sum2 = 0;
+  for (uint32_t s = 0; s < n; s++) {
+    uint64_t sample = samples[s];
+    sum += sample;
+    sum2 += sample * sample;
+  }
+  merge(index, n, sum, sum2);
+}
+
+void PedestalAccumulators::merge(size_t index, uint32_t n, uint64_t sum, uint64_t sum2)
+{
+  double hitMean = static_cast<double>(sum) / n;
+  double hitM2 = static_cast<double>(sum2) - static_cast<double>(sum) * hitMean;
+
+  // merge with the previous samples of the channel
+  double n0 = nSamples[index];
+  double N = n0 + n;
+  double delta = hitMean - mean[index];
+  mean[index] += delta * n / N;
+  m2[index] += hitM2 + delta * delta * n0 * n / N;
+  nSamples[index] += n;
+}
+
 PedestalsTask::PedestalsTask() : TaskInterface()
 {
   flog = nullptr;
@@ -88,37 +142,27 @@ void PedestalsTask::initialize(o2::framework::InitContext& /*ctx*/)
   QcInfoLogger::GetInstance() << "initialize PedestalsTask" << AliceO2::InfoLogger::InfoLogger::endm;
   if (true) {
 
-    for (int c = 0; c < MCH_MAX_CRU_IN_FLP; c++) {
-      for (int l = 0; l < 24; l++) {
-        for (int i = 0; i < 40; i++) {
-          for (int j = 0; j < 64; j++) {
-            nhits[c][l][i][j] = 0;
-            pedestal[c][l][i][j] = noise[c][l][i][j] = 0;
-          }
-        }
-      }
-    }
-
-    for (int de = 0; de < 1100; de++) {
-      for (int padid = 0; padid < 1500; padid++) {
-        nhitsDigits[de][padid] = 0;
-        pedestalDigits[de][padid] = noiseDigits[de][padid] = 0;
-      }
-    }
+    mElecChannelIndex.assign(MCH_MAX_CRU_IN_FLP * 24 * 40 * 64, -1);
+    mDigitPadIndex.assign(sMaxDigitDE * sMaxDigitPadID, -1);
 
     mDecoder.initialize();
+    if (auto param = mCustomParameters.find("decodingThreads"); param != mCustomParameters.end()) {
+      mDecoder.setNumberOfThreads(std::stoi(param->second));
+    }
 
     mHistogramPedestals = new TH2F("QcMuonChambers_Pedestals", "QcMuonChambers - Pedestals",
         (MCH_FFEID_MAX+1)*12*40, 0, (MCH_FFEID_MAX+1)*12*40, 64, 0, 64);
     //getObjectsManager()->startPublishing(mHistogramPedestals);
     mHistogramPedestalsMCH = new GlobalHistogram("QcMuonChambers_Pedestals_AllDE", "Pedestals");
     mHistogramPedestalsMCH->init();
+    mHistogramPedestalsMCH->setIncremental(true);
 
     mHistogramNoise = new TH2F("QcMuonChambers_Noise", "QcMuonChambers - Noise",
         (MCH_FFEID_MAX+1)*12*40, 0, (MCH_FFEID_MAX+1)*12*40, 64, 0, 64);
     //getObjectsManager()->startPublishing(mHistogramNoise);
     mHistogramNoiseMCH = new GlobalHistogram("QcMuonChambers_Noise_AllDE", "Noise");
     mHistogramNoiseMCH->init();
+    mHistogramNoiseMCH->setIncremental(true);
 
     uint32_t dsid;
     std::vector<int> DEs;
@@ -141,27 +185,27 @@ void PedestalsTask::initialize(o2::framework::InitContext& /*ctx*/)
             DEs.push_back(de);
             TH2F* hPedDE = new TH2F(TString::Format("QcMuonChambers_Pedestals_DE%03d", de),
                 TString::Format("QcMuonChambers - Pedestals (DE%03d)", de), 2000, 0, 2000, 64, 0, 64);
-            mHistogramPedestalsDE.insert(make_pair(de, hPedDE));
+            mHistogramPedestalsDE[de] = hPedDE;
             //getObjectsManager()->startPublishing(hPedDE);
             TH2F* hNoiseDE = new TH2F(TString::Format("QcMuonChambers_Noise_DE%03d", de),
                 TString::Format("QcMuonChambers - Noise (DE%03d)", de), 2000, 0, 2000, 64, 0, 64);
-            mHistogramNoiseDE.insert(make_pair(de, hNoiseDE));
+            mHistogramNoiseDE[de] = hNoiseDE;
             //getObjectsManager()->startPublishing(hNoiseDE);
 
             TH1F* hDeltaDE = new TH1F(TString::Format("QcMuonChambers_Delta_b_%03d", de),
                 TString::Format("QcMuonChambers - Delta (DE%03d B)", de), 1000, 0, 1000);
-            mHistogramDeltaDE[0].insert(make_pair(de, hDeltaDE));
+            mHistogramDeltaDE[0][de] = hDeltaDE;
             hDeltaDE = new TH1F(TString::Format("QcMuonChambers_Delta_nb_%03d", de),
                 TString::Format("QcMuonChambers - Delta (DE%03d NB)", de), 1000, 0, 1000);
-            mHistogramDeltaDE[1].insert(make_pair(de, hDeltaDE));
+            mHistogramDeltaDE[1][de] = hDeltaDE;
 
             for (int pi = 0; pi < 5; pi++) {
               TH1F* hNoiseDE = new TH1F(TString::Format("QcMuonChambers_Noise_Distr_DE%03d_b_%d", de, pi),
                   TString::Format("QcMuonChambers - Noise distribution (DE%03d B, %d)", de, pi), 1000, 0, 10);
-              mHistogramNoiseDistributionDE[pi][0].insert(make_pair(de, hNoiseDE));
+              mHistogramNoiseDistributionDE[pi][0][de] = hNoiseDE;
               hNoiseDE = new TH1F(TString::Format("QcMuonChambers_Noise_Distr_DE%03d_nb_%d", de, pi),
                   TString::Format("QcMuonChambers - Noise distribution (DE%03d NB, %d)", de, pi), 1000, 0, 10);
-              mHistogramNoiseDistributionDE[pi][1].insert(make_pair(de, hNoiseDE));
+              mHistogramNoiseDistributionDE[pi][1][de] = hNoiseDE;
             }
 
             float Xsize = 50 * 5;
@@ -171,22 +215,30 @@ void PedestalsTask::initialize(o2::framework::InitContext& /*ctx*/)
             {
               TH2F* hPedXY = new TH2F(TString::Format("QcMuonChambers_Pedestals_XYb_%03d", de),
                   TString::Format("QcMuonChambers - Pedestals XY (DE%03d B)", de), Xsize * 2, -Xsize2, Xsize2, Ysize * 2, -Ysize2, Ysize2);
-              mHistogramPedestalsXY[0].insert(make_pair(de, hPedXY));
+              mHistogramPedestalsXY[0][de] = hPedXY;
               getObjectsManager()->startPublishing(hPedXY);
               TH2F* hNoiseXY = new TH2F(TString::Format("QcMuonChambers_Noise_XYb_%03d", de),
                   TString::Format("QcMuonChambers - Noise XY (DE%03d B)", de), Xsize * 2, -Xsize2, Xsize2, Ysize * 2, -Ysize2, Ysize2);
-              mHistogramNoiseXY[0].insert(make_pair(de, hNoiseXY));
+              mHistogramNoiseXY[0][de] = hNoiseXY;
               getObjectsManager()->startPublishing(hNoiseXY);
             }
             {
               TH2F* hPedXY = new TH2F(TString::Format("QcMuonChambers_Pedestals_XYnb_%03d", de),
                   TString::Format("QcMuonChambers - Pedestals XY (DE%03d NB)", de), Xsize * 2, -Xsize2, Xsize2, Ysize * 2, -Ysize2, Ysize2);
-              mHistogramPedestalsXY[1].insert(make_pair(de, hPedXY));
+              mHistogramPedestalsXY[1][de] = hPedXY;
               getObjectsManager()->startPublishing(hPedXY);
               TH2F* hNoiseXY = new TH2F(TString::Format("QcMuonChambers_Noise_XYnb_%03d", de),
                   TString::Format("QcMuonChambers - Noise XY (DE%03d NB)", de), Xsize * 2, -Xsize2, Xsize2, Ysize * 2, -Ysize2, Ysize2);
-              mHistogramNoiseXY[1].insert(make_pair(de, hNoiseXY));
+              mHistogramNoiseXY[1][de] = hNoiseXY;
               getObjectsManager()->startPublishing(hNoiseXY);
+
+              // all the XY histograms have the same binning
+              PadBins bins;
+              if (bins.init(de, hNoiseXY)) {
+                mPadBins[de] = std::move(bins);
+              } else {
+                QcInfoLogger::GetInstance() << "[MCH] Detection Element " << de << " not found in mapping." << AliceO2::InfoLogger::InfoLogger::endm;
+              }
             }
           }
         }
@@ -209,28 +261,74 @@ void PedestalsTask::startOfCycle()
   QcInfoLogger::GetInstance() << "startOfCycle" << AliceO2::InfoLogger::InfoLogger::endm;
 }
 
+void PedestalsTask::fill_histograms()
+{
+  auto fillXY = [this](int de, int padid, int cathode, double pedestal, double rms) {
+    auto bins = mPadBins.find(de);
+    if (!bins || bins->getCathode(padid) < 0) {
+      return;
+    }
+    auto hPedXY = mHistogramPedestalsXY[cathode].find(de);
+    if (hPedXY && *hPedXY) {
+      for (auto bin = bins->begin(padid); bin != bins->end(padid); bin++) {
+        (*hPedXY)->SetBinContent(*bin, pedestal);
+      }
+    }
+    auto hNoiseXY = mHistogramNoiseXY[cathode].find(de);
+    if (hNoiseXY && *hNoiseXY) {
+      for (auto bin = bins->begin(padid); bin != bins->end(padid); bin++) {
+        (*hNoiseXY)->SetBinContent(*bin, rms);
+      }
+    }
+  };
+
+  // Fill the histograms for each CRU link and for each detection element
+  for (size_t i = 0; i < mElecChannels.size(); i++) {
+    const ElecChannel& channel = mElecChannels[i];
+    double pedestal = mElecPedestals.getPedestal(i);
+    double rms = mElecPedestals.getNoise(i);
+
+    mHistogramPedestals->SetBinContent(channel.xbin, channel.ybin, pedestal);
+    mHistogramNoise->SetBinContent(channel.xbin, channel.ybin, rms);
+
+    auto hPedDE = mHistogramPedestalsDE.find(channel.de);
+    if (hPedDE && *hPedDE) {
+      (*hPedDE)->SetBinContent(channel.dsid + 1, channel.chan_addr + 1, pedestal);
+    }
+    auto hNoiseDE = mHistogramNoiseDE.find(channel.de);
+    if (hNoiseDE && *hNoiseDE) {
+      (*hNoiseDE)->SetBinContent(channel.dsid + 1, channel.chan_addr + 1, rms);
+    }
+
+    fillXY(channel.de, channel.padid, channel.cathode, pedestal, rms);
+  }
+
+  for (size_t i = 0; i < mDigitPads.size(); i++) {
+    const DigitPad& pad = mDigitPads[i];
+    fillXY(pad.de, pad.padid, pad.cathode, mDigitPedestals.getPedestal(i), mDigitPedestals.getNoise(i));
+  }
+}
+
 void PedestalsTask::fill_noise_distributions()
 {
   for (int pi = 0; pi < 5; pi++) {
     for (int i = 0; i < 2; i++) {
-      auto ih = mHistogramNoiseDistributionDE[pi][i].begin();
-      while (ih != mHistogramNoiseDistributionDE[pi][i].end()) {
-        ih->second->Reset();
-        ih++;
+      for (auto h : mHistogramNoiseDistributionDE[pi][i].getObjects()) {
+        h->Reset();
       }
     }
   }
-  auto ih = mHistogramNoiseDE.begin();
-  for (; ih != mHistogramNoiseDE.end(); ih++) {
-    int de = ih->first;
-    if (!ih->second)
+  for (size_t ih = 0; ih < mHistogramNoiseDE.size(); ih++) {
+    int de = mHistogramNoiseDE.getDE(ih);
+    TH2F* hNoise = mHistogramNoiseDE.at(ih);
+    if (!hNoise)
       continue;
-    if (ih->second->GetEntries() < 1)
+    if (hNoise->GetEntries() < 1)
       continue;
 
-    for (int bi = 0; bi < ih->second->GetXaxis()->GetNbins(); bi++) {
-      for (int ci = 0; ci < ih->second->GetYaxis()->GetNbins(); ci++) {
-        float noise = ih->second->GetBinContent(bi + 1, ci + 1);
+    for (int bi = 0; bi < hNoise->GetXaxis()->GetNbins(); bi++) {
+      for (int ci = 0; ci < hNoise->GetYaxis()->GetNbins(); ci++) {
+        float noise = hNoise->GetBinContent(bi + 1, ci + 1);
         if (noise < 0.001)
           continue;
 
@@ -269,8 +367,8 @@ void PedestalsTask::fill_noise_distributions()
           szid = 3;
 
         auto hNoiseDE = mHistogramNoiseDistributionDE[szid][cathode].find(de);
-        if ((hNoiseDE != mHistogramNoiseDistributionDE[szid][cathode].end()) && (hNoiseDE->second != NULL)) {
-          hNoiseDE->second->Fill(noise);
+        if (hNoiseDE && *hNoiseDE) {
+          (*hNoiseDE)->Fill(noise);
         }
       }
     }
@@ -289,46 +387,34 @@ void PedestalsTask::save_histograms()
   mHistogramPedestals->Write();
 
   for (int i = 0; i < 2; i++) {
-    auto ih = mHistogramPedestalsXY[i].begin();
-    while (ih != mHistogramPedestalsXY[i].end()) {
-      ih->second->Write();
-      ih++;
+    for (auto h : mHistogramPedestalsXY[i].getObjects()) {
+      h->Write();
     }
   }
   for (int i = 0; i < 2; i++) {
-    auto ih = mHistogramNoiseXY[i].begin();
-    while (ih != mHistogramNoiseXY[i].end()) {
-      ih->second->Write();
-      ih++;
+    for (auto h : mHistogramNoiseXY[i].getObjects()) {
+      h->Write();
     }
   }
   {
-    auto ih = mHistogramPedestalsDE.begin();
-    while (ih != mHistogramPedestalsDE.end()) {
-      ih->second->Write();
-      ih++;
+    for (auto h : mHistogramPedestalsDE.getObjects()) {
+      h->Write();
     }
   }
   {
-    auto ih = mHistogramNoiseDE.begin();
-    while (ih != mHistogramNoiseDE.end()) {
-      ih->second->Write();
-      ih++;
+    for (auto h : mHistogramNoiseDE.getObjects()) {
+      h->Write();
     }
   }
   for (int pi = 0; pi < 2; pi++) {
-    auto ih = mHistogramDeltaDE[pi].begin();
-    while (ih != mHistogramDeltaDE[pi].end()) {
-      ih->second->Write();
-      ih++;
+    for (auto h : mHistogramDeltaDE[pi].getObjects()) {
+      h->Write();
     }
   }
   for (int pi = 0; pi < 5; pi++) {
     for (int i = 0; i < 2; i++) {
-      auto ih = mHistogramNoiseDistributionDE[pi][i].begin();
-      while (ih != mHistogramNoiseDistributionDE[pi][i].end()) {
-        ih->second->Write();
-        ih++;
+      for (auto h : mHistogramNoiseDistributionDE[pi][i].getObjects()) {
+        h->Write();
       }
     }
   }
@@ -375,101 +461,25 @@ void PedestalsTask::monitorDataReadout(o2::framework::ProcessingContext& ctx)
     fprintf(flog, "hits size: %lu\n", hits.size());
   for (uint32_t i = 0; i < hits.size(); i++) {
     SampaHit& hit = hits[i];
-    if (hit.link_id >= 24 || hit.ds_addr >= 40 || hit.chan_addr >= 64) {
-      fprintf(stdout, "hit[%d]: link_id=%d, ds_addr=%d, chan_addr=%d\n",
-          i, hit.link_id, hit.ds_addr, hit.chan_addr);
+    if (hit.cru_id >= MCH_MAX_CRU_IN_FLP || hit.link_id >= 24 || hit.ds_addr >= 40 || hit.chan_addr >= 64) {
+      fprintf(stdout, "hit[%d]: cru_id=%d, link_id=%d, ds_addr=%d, chan_addr=%d\n",
+          i, hit.cru_id, hit.link_id, hit.ds_addr, hit.chan_addr);
       continue;
     }
 
-    //int ds_group_id = hit.ds_addr / 5;
-    //int ds_id_in_group = hit.ds_addr % 5;
-    //int ds_chan_addr_in_group = hit.chan_addr + 64 * ds_id_in_group;
-
-    // Update the average and RMS of the pedestal values
-    for (uint32_t s = 0; s < hit.samples.size(); s++) {
-      int sample = hit.samples[s];
-
-      nhits[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr] += 1;
-      uint64_t N = nhits[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr];
-
-      double p0 = pedestal[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr];
-      double p = p0 + (sample - p0) / N;
-      pedestal[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr] = p;
-
-      double M0 = noise[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr];
-      double M = M0 + (sample - p0) * (sample - p);
-      noise[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr] = M;
-
-      /*if (false && hit.link_id == 2 && hit.ds_addr == 37 && hit.chan_addr == 30)
-        fprintf(stdout, "M0=%f  sample=%d  M=%f  nhits=%lu  rms=%f\n",
-            (float)M0, sample, (float)M, nhits[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr],
-            (float)std::sqrt(noise[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr] /
-                nhits[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr]));*/
-    }
-
-    // Fill the histograms for each CRU link
-    double rms = std::sqrt(noise[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr] /
-        nhits[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr]);
-
-    /*if( false && hit.cru_id==0 && hit.link_id==0 && hit.ds_addr==0 && hit.chan_addr==0)
-      printf("%d %d %d %d -> %d %f %f\n", (int)hit.cru_id, (int)hit.link_id, (int)hit.ds_addr, (int)hit.chan_addr,
-          (int)nhits[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr],
-          pedestal[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr], rms);*/
-
+    // Update the average and RMS of the pedestal values, the histograms are filled at the end of the cycle
+    int32_t& index = mElecChannelIndex[((hit.cru_id * 24 + hit.link_id) * 40 + hit.ds_addr) * 64 + hit.chan_addr];
+    if (index < 0) {
+      index = mElecPedestals.addChannel();
       int xbin = hit.fee_id * 12 * 40 + (hit.link_id % 12) * 40 + hit.ds_addr + 1;
       int ybin = hit.chan_addr + 1;
-
-      mHistogramPedestals->SetBinContent(xbin, ybin, pedestal[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr]);
-      mHistogramNoise->SetBinContent(xbin, ybin, rms);
-
-    // Fill the histograms for each detection element
-    int de = hit.pad.fDE;
-    int dsid = hit.pad.fDsID;
-    float padX = hit.pad.fX;
-    float padY = hit.pad.fY;
-    float padSizeX = hit.pad.fSizeX;
-    float padSizeY = hit.pad.fSizeY;
-
-    /*if (false) fprintf(flog, "mapping: link_id=%d ds_addr=%d chan_addr=%d  ==>  de=%d dsid=%d x=%f y=%f sx=%f sy=%f\n",
-        hit.link_id, hit.ds_addr, hit.chan_addr, de, dsid, padX, padY, padSizeX, padSizeY);*/
-
-    auto hPedDE = mHistogramPedestalsDE.find(de);
-    if ((hPedDE != mHistogramPedestalsDE.end()) && (hPedDE->second != NULL)) {
-      hPedDE->second->SetBinContent(dsid + 1, hit.chan_addr + 1, pedestal[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr]);
-    }
-    auto hNoiseDE = mHistogramNoiseDE.find(de);
-    if ((hNoiseDE != mHistogramNoiseDE.end()) && (hNoiseDE->second != NULL)) {
-      hNoiseDE->second->SetBinContent(dsid + 1, hit.chan_addr + 1, rms);
-    }
-
-    auto hDeltaDE = mHistogramDeltaDE[hit.pad.fCathode].find(de);
-    if ((hDeltaDE != mHistogramDeltaDE[hit.pad.fCathode].end()) && (hDeltaDE->second != NULL)) {
-      hDeltaDE->second->Fill(hit.delta);
+      mElecChannels.push_back({ xbin, ybin, hit.pad.fDE, hit.pad.fDsID, (int)hit.chan_addr, hit.pad.fAddress, hit.pad.fCathode });
     }
+    mElecPedestals.update(index, mDecoder.getHitSamples(hit), hit.nSamples);
 
-    auto hPedXY = mHistogramPedestalsXY[hit.pad.fCathode].find(de);
-    if ((hPedXY != mHistogramPedestalsXY[hit.pad.fCathode].end()) && (hPedXY->second != NULL)) {
-      int binx_min = hPedXY->second->GetXaxis()->FindBin(padX - padSizeX / 2 + 0.1);
-      int binx_max = hPedXY->second->GetXaxis()->FindBin(padX + padSizeX / 2 - 0.1);
-      int biny_min = hPedXY->second->GetYaxis()->FindBin(padY - padSizeY / 2 + 0.1);
-      int biny_max = hPedXY->second->GetYaxis()->FindBin(padY + padSizeY / 2 - 0.1);
-      for (int by = biny_min; by <= biny_max; by++) {
-        for (int bx = binx_min; bx <= binx_max; bx++) {
-          hPedXY->second->SetBinContent(bx, by, pedestal[hit.cru_id][hit.link_id][hit.ds_addr][hit.chan_addr]);
-        }
-      }
-    }
-    auto hNoiseXY = mHistogramNoiseXY[hit.pad.fCathode].find(de);
-    if ((hNoiseXY != mHistogramNoiseXY[hit.pad.fCathode].end()) && (hNoiseXY->second != NULL)) {
-      int binx_min = hNoiseXY->second->GetXaxis()->FindBin(padX - padSizeX / 2 + 0.1);
-      int binx_max = hNoiseXY->second->GetXaxis()->FindBin(padX + padSizeX / 2 - 0.1);
-      int biny_min = hNoiseXY->second->GetYaxis()->FindBin(padY - padSizeY / 2 + 0.1);
-      int biny_max = hNoiseXY->second->GetYaxis()->FindBin(padY + padSizeY / 2 - 0.1);
-      for (int by = biny_min; by <= biny_max; by++) {
-        for (int bx = binx_min; bx <= binx_max; bx++) {
-          hNoiseXY->second->SetBinContent(bx, by, rms);
-        }
-      }
+    auto hDeltaDE = mHistogramDeltaDE[hit.pad.fCathode].find(hit.pad.fDE);
+    if (hDeltaDE && *hDeltaDE) {
+      (*hDeltaDE)->Fill(hit.delta);
     }
   }
 }
@@ -518,59 +528,25 @@ void PedestalsTask::monitorDataDigits(const o2::framework::DataRef& input)
       continue;
     }
 
-    try {
-      const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(de);
-
-      double padX = segment.padPositionX(padid);
-      double padY = segment.padPositionY(padid);
-      float padSizeX = segment.padSizeX(padid);
-      float padSizeY = segment.padSizeY(padid);
-      int cathode = segment.isBendingPad(padid) ? 0 : 1;
-
-      // Update the average and RMS of the pedestal values
-      nhitsDigits[de][padid] += 1;
-      uint64_t N = nhitsDigits[de][padid];
-
-      double p0 = pedestalDigits[de][padid];
-      double p = p0 + (ADC - p0) / N;
-      pedestalDigits[de][padid] = p;
-
-      double M0 = noiseDigits[de][padid];
-      double M = M0 + (ADC - p0) * (ADC - p);
-      noiseDigits[de][padid] = M;
-
-      double rms = std::sqrt(noiseDigits[de][padid] /
-          nhitsDigits[de][padid]);
-
-      // Fill the histograms for each detection element
-      auto hPedXY = mHistogramPedestalsXY[cathode].find(de);
-      if ((hPedXY != mHistogramPedestalsXY[cathode].end()) && (hPedXY->second != NULL)) {
-        int binx_min = hPedXY->second->GetXaxis()->FindBin(padX - padSizeX / 2 + 0.1);
-        int binx_max = hPedXY->second->GetXaxis()->FindBin(padX + padSizeX / 2 - 0.1);
-        int biny_min = hPedXY->second->GetYaxis()->FindBin(padY - padSizeY / 2 + 0.1);
-        int biny_max = hPedXY->second->GetYaxis()->FindBin(padY + padSizeY / 2 - 0.1);
-        for (int by = biny_min; by <= biny_max; by++) {
-          for (int bx = binx_min; bx <= binx_max; bx++) {
-            hPedXY->second->SetBinContent(bx, by, pedestalDigits[de][padid]);
-          }
-        }
+    if (de >= sMaxDigitDE || padid >= sMaxDigitPadID) {
+      continue;
+    }
+
+    // Update the average and RMS of the pedestal values, the histograms are filled at the end of the cycle
+    int32_t& index = mDigitPadIndex[de * sMaxDigitPadID + padid];
+    if (index < 0) {
+      auto bins = mPadBins.find(de);
+      if (!bins) {
+        continue;
       }
-      auto hNoiseXY = mHistogramNoiseXY[cathode].find(de);
-      if ((hNoiseXY != mHistogramNoiseXY[cathode].end()) && (hNoiseXY->second != NULL)) {
-        int binx_min = hNoiseXY->second->GetXaxis()->FindBin(padX - padSizeX / 2 + 0.1);
-        int binx_max = hNoiseXY->second->GetXaxis()->FindBin(padX + padSizeX / 2 - 0.1);
-        int biny_min = hNoiseXY->second->GetYaxis()->FindBin(padY - padSizeY / 2 + 0.1);
-        int biny_max = hNoiseXY->second->GetYaxis()->FindBin(padY + padSizeY / 2 - 0.1);
-        for (int by = biny_min; by <= biny_max; by++) {
-          for (int bx = binx_min; bx <= binx_max; bx++) {
-            hNoiseXY->second->SetBinContent(bx, by, rms);
-          }
-        }
+      int cathode = bins->getCathode(padid);
+      if (cathode < 0) {
+        continue;
       }
-    } catch (const std::exception& e) {
-      QcInfoLogger::GetInstance() << "[MCH] Detection Element " << de << " not found in mapping." << AliceO2::InfoLogger::InfoLogger::endm;
-      return;
+      index = mDigitPedestals.addChannel();
+      mDigitPads.push_back({ de, padid, cathode });
     }
+    mDigitPedestals.update(index, static_cast<uint32_t>(ADC));
   }
 }
 
@@ -590,6 +566,7 @@ void PedestalsTask::endOfCycle()
 {
   QcInfoLogger::GetInstance() << "endOfCycle" << AliceO2::InfoLogger::InfoLogger::endm;
 
+  fill_histograms();
   mHistogramPedestalsMCH->set(mHistogramPedestalsXY[0], mHistogramPedestalsXY[1], true);
   mHistogramNoiseMCH->set(mHistogramNoiseXY[0], mHistogramNoiseXY[1], true);
 
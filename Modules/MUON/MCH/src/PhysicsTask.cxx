@@ -10,6 +10,7 @@
 #include <TH2.h>
 #include <TFile.h>
 #include <algorithm>
+#include <thread>
 
 #include "Headers/RAWDataHeader.h"
 #include "DPLUtils/DPLRawParser.h"
@@ -29,6 +30,11 @@ using namespace std;
 
 static FILE* flog = NULL;
 
+// smaller sets of preclusters are not worth splitting among threads
+static constexpr size_t sMinPreclustersPerThread = 1000;
+// number of precluster fills which are kept before the histograms are updated
+static constexpr size_t sMaxPendingFills = 1000000;
+
 struct CRUheader {
   uint8_t header_version;
   uint8_t header_size;
@@ -72,6 +78,13 @@ void PhysicsTask::initialize(o2::framework::InitContext& /*ctx*/)
   fprintf(stdout, "initialize PhysicsTask\n");
 
   mDecoder.initialize();
+  if (auto param = mCustomParameters.find("decodingThreads"); param != mCustomParameters.end()) {
+    mDecoder.setNumberOfThreads(std::stoi(param->second));
+  }
+  if (auto param = mCustomParameters.find("preclusterThreads"); param != mCustomParameters.end()) {
+    mPreclusterThreads = std::max(1, std::stoi(param->second));
+  }
+  mPreclusterFills.resize(mPreclusterThreads);
 
   mPrintLevel = 0;
 
@@ -117,7 +130,7 @@ void PhysicsTask::initialize(o2::framework::InitContext& /*ctx*/)
 
           TH1F* h = new TH1F(TString::Format("QcMuonChambers_ADCamplitude_DE%03d", de),
               TString::Format("QcMuonChambers - ADC amplitude (DE%03d)", de), 5000, 0, 5000);
-          mHistogramADCamplitudeDE.insert(make_pair(de, h));
+          mHistogramADCamplitudeDE[de] = h;
           //getObjectsManager()->startPublishing(h);
 
           float Xsize = 40 * 5;
@@ -127,12 +140,19 @@ void PhysicsTask::initialize(o2::framework::InitContext& /*ctx*/)
 
           TH2F* h2 = new TH2F(TString::Format("QcMuonChambers_Nhits_DE%03d", de),
               TString::Format("QcMuonChambers - Number of hits (DE%03d)", de), Xsize * 2, -Xsize2, Xsize2, Ysize * 2, -Ysize2, Ysize2);
-          mHistogramNhitsDE.insert(make_pair(de, h2));
+          mHistogramNhitsDE[de] = h2;
           getObjectsManager()->startPublishing(h2);
           h2 = new TH2F(TString::Format("QcMuonChambers_Nhits_HighAmpl_DE%03d", de),
               TString::Format("QcMuonChambers - Number of hits for Csum>500 (DE%03d)", de), Xsize * 2, -Xsize2, Xsize2, Ysize * 2, -Ysize2, Ysize2);
-          mHistogramNhitsHighAmplDE.insert(make_pair(de, h2));
+          mHistogramNhitsHighAmplDE[de] = h2;
           //getObjectsManager()->startPublishing(h2);
+
+          PadBins bins;
+          if (bins.init(de, h2)) {
+            mPadBins[de] = std::move(bins);
+          } else {
+            QcInfoLogger::GetInstance() << "[MCH] Detection Element " << de << " not found in mapping." << AliceO2::InfoLogger::InfoLogger::endm;
+          }
         }
       }
     }
@@ -142,9 +162,14 @@ void PhysicsTask::initialize(o2::framework::InitContext& /*ctx*/)
     const o2::mch::mapping::Segmentation* segment = &(o2::mch::mapping::segmentation(de));
     if (segment == nullptr) continue;
 
+    PadGeometry geometry;
+    if (geometry.init(de)) {
+      mPadGeometry[de] = std::move(geometry);
+    }
+
     TH1F* h = new TH1F(TString::Format("QcMuonChambers_Cluster_Charge_DE%03d", de),
         TString::Format("QcMuonChambers - cluster charge (DE%03d)", de), 1000, 0, 50000);
-    mHistogramClchgDE.insert(make_pair(de, h));
+    mHistogramClchgDE[de] = h;
 
     float Xsize = 40 * 5;
     float Xsize2 = Xsize / 2;
@@ -154,36 +179,38 @@ void PhysicsTask::initialize(o2::framework::InitContext& /*ctx*/)
     {
       TH2F* hXY = new TH2F(TString::Format("QcMuonChambers_Preclusters_Number_XY_%03d", de),
           TString::Format("QcMuonChambers - Preclusters Number XY (DE%03d B)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPreclustersXY[0].insert(make_pair(de, hXY));
+      mHistogramPreclustersXY[0][de] = hXY;
 
       hXY = new TH2F(TString::Format("QcMuonChambers_Preclusters_B_XY_%03d", de),
           TString::Format("QcMuonChambers - Preclusters XY (DE%03d B)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPreclustersXY[1].insert(make_pair(de, hXY));
+      mHistogramPreclustersXY[1][de] = hXY;
 
       hXY = new TH2F(TString::Format("QcMuonChambers_Preclusters_NB_XY_%03d", de),
           TString::Format("QcMuonChambers - Preclusters XY (DE%03d NB)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPreclustersXY[2].insert(make_pair(de, hXY));
+      mHistogramPreclustersXY[2][de] = hXY;
 
       hXY = new TH2F(TString::Format("QcMuonChambers_Preclusters_BNB_XY_%03d", de),
           TString::Format("QcMuonChambers - Preclusters XY (DE%03d B+NB)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPreclustersXY[3].insert(make_pair(de, hXY));
+      mHistogramPreclustersXY[3][de] = hXY;
 
       hXY = new TH2F(TString::Format("QcMuonChambers_Pseudoeff_B_XY_%03d", de),
           TString::Format("QcMuonChambers - Pseudo-efficiency XY (DE%03d B)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPseudoeffXY[0].insert(make_pair(de, hXY));
+      mHistogramPseudoeffXY[0][de] = hXY;
 
       hXY = new TH2F(TString::Format("QcMuonChambers_Pseudoeff_NB_XY_%03d", de),
           TString::Format("QcMuonChambers - Pseudo-efficiency XY (DE%03d NB)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPseudoeffXY[1].insert(make_pair(de, hXY));
+      mHistogramPseudoeffXY[1][de] = hXY;
 
       hXY = new TH2F(TString::Format("QcMuonChambers_Pseudoeff_BNB_XY_%03d", de),
           TString::Format("QcMuonChambers - Pseudo-efficiency XY (DE%03d B+NB)", de), Xsize / scale, -Xsize2, Xsize2, Ysize / scale, -Ysize2, Ysize2);
-      mHistogramPseudoeffXY[2].insert(make_pair(de, hXY));
+      mHistogramPseudoeffXY[2][de] = hXY;
     }
   }
 
   mHistogramPseudoeff[0] = new GlobalHistogram("QcMuonChambers_Pseudoeff_den", "Pseudo-efficiency");
   mHistogramPseudoeff[0]->init();
+  // the other ones are divided by the denominator after each update
+  mHistogramPseudoeff[0]->setIncremental(true);
   mHistogramPseudoeff[1] = new GlobalHistogram("QcMuonChambers_Pseudoeff", "Pseudo-efficiency");
   mHistogramPseudoeff[1]->init();
   mHistogramPseudoeff[2] = new GlobalHistogram("QcMuonChambers_Pseudoeff_BNB", "Pseudo-efficiency - B+NB");
@@ -313,16 +340,42 @@ void PhysicsTask::monitorDataPreclusters(o2::framework::ProcessingContext& ctx)
 
   //checkPreclusters(preClusters, digits);
 
-  bool print = false;
-  for(auto& p : preClusters) {
-    if (!plotPrecluster(p, digits)) {
-      print = true;
+  // the preclusters are split in contiguous chunks, one per thread, and each thread buffers the histogram fills
+  // of its chunk, such that the histograms are only updated by fillPreclusterHistograms()
+  int nThreads = std::max<int>(1, std::min<size_t>(mPreclusterThreads, preClusters.size() / sMinPreclustersPerThread));
+  std::vector<char> print(nThreads, 0);
+  auto worker = [&](int t) {
+    size_t first = preClusters.size() * t / nThreads;
+    size_t last = preClusters.size() * (t + 1) / nThreads;
+    for (size_t i = first; i < last; i++) {
+      if (!plotPrecluster(preClusters[i], digits, mPreclusterFills[t])) {
+        print[t] = 1;
+      }
+    }
+  };
+  if (nThreads == 1) {
+    worker(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < nThreads; t++) {
+      threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) {
+      thread.join();
     }
   }
 
-  if (print) {
+  if (std::any_of(print.begin(), print.end(), [](char p) { return p != 0; })) {
     printPreclusters(preClusters, digits);
   }
+
+  size_t nFills = 0;
+  for (auto& fills : mPreclusterFills) {
+    nFills += fills.charges.size() + fills.positions.size();
+  }
+  if (nFills > sMaxPendingFills) {
+    fillPreclusterHistograms();
+  }
   //for (uint32_t i = 0; i < digits.size(); i++) {
   //  o2::mch::Digit& digit = digits[i];
   //  plotDigit(digit);
@@ -348,28 +401,28 @@ void PhysicsTask::monitorData(o2::framework::ProcessingContext& ctx)
       //std::cout<<"  de="<<de<<std::endl;
       {
         auto h = mHistogramADCamplitudeDE.find(de);
-        if ((h != mHistogramADCamplitudeDE.end()) && (h->second != NULL)) {
-          h->second->Write();
+        if (h && *h) {
+          (*h)->Write();
         }
       }
       {
         auto h = mHistogramNhitsDE.find(de);
-        if ((h != mHistogramNhitsDE.end()) && (h->second != NULL)) {
-          h->second->Write();
+        if (h && *h) {
+          (*h)->Write();
         }
       }
       {
         auto h = mHistogramNhitsHighAmplDE.find(de);
-        if ((h != mHistogramNhitsHighAmplDE.end()) && (h->second != NULL)) {
-          h->second->Write();
+        if (h && *h) {
+          (*h)->Write();
         }
       }
     }
     {
       for(int i = 0; i < 4; i++) {
-        for(auto& h2 : mHistogramPreclustersXY[i]) {
-          if (h2.second != nullptr) {
-            h2.second->Write();
+        for(auto h2 : mHistogramPreclustersXY[i].getObjects()) {
+          if (h2 != nullptr) {
+            h2->Write();
           }
         }
         //auto h2 = mHistogramPreclustersXY[i].find(de);
@@ -434,62 +487,41 @@ void PhysicsTask::plotDigit(const o2::mch::Digit& digit)
 
   //mHistogramADCamplitudeVsSize->Fill(size, ADC);
 
-  try {
-    const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(de);
+  auto bins = mPadBins.find(de);
+  if (!bins) {
+    return;
+  }
+  int cathode = bins->getCathode(padid);
+  if (cathode < 0) {
+    return;
+  }
 
-    double padX = segment.padPositionX(padid);
-    double padY = segment.padPositionY(padid);
-    float padSizeX = segment.padSizeX(padid);
-    float padSizeY = segment.padSizeY(padid);
-    int cathode = segment.isBendingPad(padid) ? 0 : 1;
+  if (mPrintLevel >= 1)
+    fprintf(flog, "de=%d pad=%d cathode=%d\n", de, padid, cathode);
 
+  auto h = mHistogramADCamplitudeDE.find(de);
+  if (h && *h) {
+    (*h)->Fill(ADC);
+  }
 
-    if (mPrintLevel >= 1)
-      fprintf(flog, "de=%d pad=%d x=%f y=%f\n", de, padid, padX, padY);
-    //if(pad.fX>=32 && pad.fX<=34 && pad.fY>=1.1 && pad.fY<=1.4)
-    //  fprintf(flog, "mapping: link_id=%d ds_addr=%d chan_addr=%d  ==>  de=%d x=%f y=%f A=%d\n",
-    //    hit.link_id, hit.ds_addr, hit.chan_addr, pad.fDE, pad.fX, pad.fY, hit.csum);
-
-    auto h = mHistogramADCamplitudeDE.find(de);
-    if ((h != mHistogramADCamplitudeDE.end()) && (h->second != NULL)) {
-      h->second->Fill(ADC);
-    }
-
-    if (cathode == 0 && ADC > 0) {
-      auto h2 = mHistogramNhitsDE.find(de);
-      if ((h2 != mHistogramNhitsDE.end()) && (h2->second != NULL)) {
-        int binx_min = h2->second->GetXaxis()->FindBin(padX - padSizeX / 2 + 0.1);
-        int binx_max = h2->second->GetXaxis()->FindBin(padX + padSizeX / 2 - 0.1);
-        int biny_min = h2->second->GetYaxis()->FindBin(padY - padSizeY / 2 + 0.1);
-        int biny_max = h2->second->GetYaxis()->FindBin(padY + padSizeY / 2 - 0.1);
-        for (int by = biny_min; by <= biny_max; by++) {
-          float y = h2->second->GetYaxis()->GetBinCenter(by);
-          for (int bx = binx_min; bx <= binx_max; bx++) {
-            float x = h2->second->GetXaxis()->GetBinCenter(bx);
-            h2->second->Fill(x, y);
-          }
-        }
+  // the bins are incremented directly, the statistics are then computed from the bin contents
+  if (cathode == 0 && ADC > 0) {
+    auto h2 = mHistogramNhitsDE.find(de);
+    if (h2 && *h2) {
+      for (auto bin = bins->begin(padid); bin != bins->end(padid); bin++) {
+        (*h2)->AddBinContent(*bin);
       }
+      (*h2)->SetEntries((*h2)->GetEntries() + (bins->end(padid) - bins->begin(padid)));
     }
-    if (cathode == 0 && ADC > 500) {
-      auto h2 = mHistogramNhitsHighAmplDE.find(de);
-      if ((h2 != mHistogramNhitsHighAmplDE.end()) && (h2->second != NULL)) {
-        int binx_min = h2->second->GetXaxis()->FindBin(padX - padSizeX / 2 + 0.1);
-        int binx_max = h2->second->GetXaxis()->FindBin(padX + padSizeX / 2 - 0.1);
-        int biny_min = h2->second->GetYaxis()->FindBin(padY - padSizeY / 2 + 0.1);
-        int biny_max = h2->second->GetYaxis()->FindBin(padY + padSizeY / 2 - 0.1);
-        for (int by = biny_min; by <= biny_max; by++) {
-          float y = h2->second->GetYaxis()->GetBinCenter(by);
-          for (int bx = binx_min; bx <= binx_max; bx++) {
-            float x = h2->second->GetXaxis()->GetBinCenter(bx);
-            h2->second->Fill(x, y);
-          }
-        }
+  }
+  if (cathode == 0 && ADC > 500) {
+    auto h2 = mHistogramNhitsHighAmplDE.find(de);
+    if (h2 && *h2) {
+      for (auto bin = bins->begin(padid); bin != bins->end(padid); bin++) {
+        (*h2)->AddBinContent(*bin);
       }
+      (*h2)->SetEntries((*h2)->GetEntries() + (bins->end(padid) - bins->begin(padid)));
     }
-  } catch (const std::exception& e) {
-    QcInfoLogger::GetInstance() << "[MCH] Detection Element " << de << " not found in mapping." << AliceO2::InfoLogger::InfoLogger::endm;
-    return;
   }
 }
 
@@ -497,7 +529,7 @@ void PhysicsTask::plotDigit(const o2::mch::Digit& digit)
 
 
 //_________________________________________________________________________________________________
-static void CoG(gsl::span<const o2::mch::Digit> precluster, double& Xcog, double& Ycog)
+static void CoG(gsl::span<const o2::mch::Digit> precluster, const PadGeometry& geometry, double& Xcog, double& Ycog)
 {
   double xmin = 1E9;
   double ymin = 1E9;
@@ -512,16 +544,16 @@ static void CoG(gsl::span<const o2::mch::Digit> precluster, double& Xcog, double
   double xsize[] = { 0.0, 0.0 };
   double ysize[] = { 0.0, 0.0 };
 
-  int detid = precluster[0].getDetID();
-  const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(detid);
-
   for ( size_t i = 0; i < precluster.size(); ++i ) {
     const o2::mch::Digit& digit = precluster[i];
-    int padid = digit.getPadID();
+    const PadGeometry::Pad* pad = geometry.find(digit.getPadID());
+    if (!pad) {
+      continue;
+    }
 
     // position and size of current pad
-    double padPosition[2] = {segment.padPositionX(padid), segment.padPositionY(padid)};
-    double padSize[2] = {segment.padSizeX(padid), segment.padSizeY(padid)};
+    double padPosition[2] = {pad->x, pad->y};
+    double padSize[2] = {pad->sizeX, pad->sizeY};
 
     // update of xmin/max et ymin/max
     xmin = std::min(padPosition[0]-0.5*padSize[0],xmin);
@@ -530,7 +562,7 @@ static void CoG(gsl::span<const o2::mch::Digit> precluster, double& Xcog, double
     ymax = std::max(padPosition[1]+0.5*padSize[1],ymax);
 
     // cathode index
-    int cathode = segment.isBendingPad(padid) ? 0 : 1;
+    int cathode = pad->cathode;
 
     // update of the cluster position, size, charge and multiplicity
     x[cathode] += padPosition[0] * digit.getADC();
@@ -587,14 +619,20 @@ void PhysicsTask::checkPreclusters(gsl::span<const o2::mch::PreCluster> preClust
       float chargeMax[2] = {0, 0};
 
       int detid = preClusterDigits[0].getDetID();
-      const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(detid);
+      const PadGeometry* geometry = mPadGeometry.find(detid);
+      if (!geometry) {
+        continue;
+      }
 
       for ( size_t i = 0; i < preClusterDigits.size(); ++i ) {
         const o2::mch::Digit& digit = preClusterDigits[i];
-        int padid = digit.getPadID();
+        const PadGeometry::Pad* pad = geometry->find(digit.getPadID());
+        if (!pad) {
+          continue;
+        }
 
         // cathode index
-        int cid = segment.isBendingPad(padid) ? 0 : 1;
+        int cid = pad->cathode;
         cathode[cid] = true;
         chargeSum[cid] += digit.getADC();
 
@@ -612,7 +650,7 @@ void PhysicsTask::checkPreclusters(gsl::span<const o2::mch::PreCluster> preClust
       }
 
       double Xcog, Ycog;
-      CoG(preClusterDigits, Xcog, Ycog);
+      CoG(preClusterDigits, *geometry, Xcog, Ycog);
       if(pass == 0 && cathode[0] && !cathode[1]) {
         if(Xcog > -30 && Xcog < -10 && Ycog > 6 && Ycog < 14) {
           doPrint = true;
@@ -625,9 +663,10 @@ void PhysicsTask::checkPreclusters(gsl::span<const o2::mch::PreCluster> preClust
 
         std::cout<<"[pre-cluster] charge = "<<chargeSum[0]<<" "<<chargeSum[1]<<"   CoG = "<<Xcog<<" "<<Ycog<<std::endl;
         for (auto& d : preClusterDigits) {
-          float X = segment.padPositionX(d.getPadID());
-          float Y = segment.padPositionY(d.getPadID());
-          bool bend = !segment.isBendingPad(d.getPadID());
+          const PadGeometry::Pad* pad = geometry->find(d.getPadID());
+          float X = pad ? pad->x : 0;
+          float Y = pad ? pad->y : 0;
+          bool bend = pad ? (pad->cathode != 0) : false;
           std::cout << fmt::format("  DE {:4d}  PAD {:5d}  ADC {:6d}  TIME ({} {} {:4d})",
               d.getDetID(), d.getPadID(), d.getADC(), d.getTime().orbit, d.getTime().bunchCrossing, d.getTime().sampaTime);
           std::cout << fmt::format("  CATHODE {}  PAD_XY {:+2.2f} , {:+2.2f}", (int)bend, X, Y);
@@ -651,14 +690,20 @@ void PhysicsTask::printPreclusters(gsl::span<const o2::mch::PreCluster> preClust
     float chargeMax[2] = {0, 0};
 
     int detid = preClusterDigits[0].getDetID();
-    const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(detid);
+    const PadGeometry* geometry = mPadGeometry.find(detid);
+    if (!geometry) {
+      continue;
+    }
 
     for ( size_t i = 0; i < preClusterDigits.size(); ++i ) {
       const o2::mch::Digit& digit = preClusterDigits[i];
-      int padid = digit.getPadID();
+      const PadGeometry::Pad* pad = geometry->find(digit.getPadID());
+      if (!pad) {
+        continue;
+      }
 
       // cathode index
-      int cid = segment.isBendingPad(padid) ? 0 : 1;
+      int cid = pad->cathode;
       cathode[cid] = true;
       chargeSum[cid] += digit.getADC();
 
@@ -668,13 +713,14 @@ void PhysicsTask::printPreclusters(gsl::span<const o2::mch::PreCluster> preClust
     }
 
     double Xcog, Ycog;
-    CoG(preClusterDigits, Xcog, Ycog);
+    CoG(preClusterDigits, *geometry, Xcog, Ycog);
 
     std::cout<<"[pre-cluster] charge = "<<chargeSum[0]<<" "<<chargeSum[1]<<"   CoG = "<<Xcog<<" "<<Ycog<<std::endl;
     for (auto& d : preClusterDigits) {
-      float X = segment.padPositionX(d.getPadID());
-      float Y = segment.padPositionY(d.getPadID());
-      bool bend = !segment.isBendingPad(d.getPadID());
+      const PadGeometry::Pad* pad = geometry->find(d.getPadID());
+      float X = pad ? pad->x : 0;
+      float Y = pad ? pad->y : 0;
+      bool bend = pad ? (pad->cathode != 0) : false;
       std::cout << fmt::format("  DE {:4d}  PAD {:5d}  ADC {:6d}  TIME ({} {} {:4d})",
           d.getDetID(), d.getPadID(), d.getADC(), d.getTime().orbit, d.getTime().bunchCrossing, d.getTime().sampaTime);
       std::cout << fmt::format("  CATHODE {}  PAD_XY {:+2.2f} , {:+2.2f}", (int)bend, X, Y);
@@ -684,7 +730,7 @@ void PhysicsTask::printPreclusters(gsl::span<const o2::mch::PreCluster> preClust
 }
 
 
-bool PhysicsTask::plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::span<const o2::mch::Digit> digits)
+bool PhysicsTask::plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::span<const o2::mch::Digit> digits, PreclusterFills& fills) const
 {
   // get the digits of this precluster
   auto preClusterDigits = digits.subspan(preCluster.firstDigit, preCluster.nDigits);
@@ -694,14 +740,20 @@ bool PhysicsTask::plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::spa
   float chargeMax[2] = {0, 0};
 
   int detid = preClusterDigits[0].getDetID();
-  const o2::mch::mapping::Segmentation& segment = o2::mch::mapping::segmentation(detid);
+  const PadGeometry* geometry = mPadGeometry.find(detid);
+  if (!geometry) {
+    return true;
+  }
 
   for ( size_t i = 0; i < preClusterDigits.size(); ++i ) {
     const o2::mch::Digit& digit = preClusterDigits[i];
-    int padid = digit.getPadID();
+    const PadGeometry::Pad* pad = geometry->find(digit.getPadID());
+    if (!pad) {
+      continue;
+    }
 
     // cathode index
-    int cid = segment.isBendingPad(padid) ? 0 : 1;
+    int cid = pad->cathode;
     cathode[cid] = true;
     chargeSum[cid] += digit.getADC();
 
@@ -737,10 +789,7 @@ bool PhysicsTask::plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::spa
   } else if(cathode[1]) {
     chargeTot = chargeSum[1];
   }*/
-  auto hCharge = mHistogramClchgDE.find(detid);
-  if ((hCharge != mHistogramClchgDE.end()) && (hCharge->second != NULL)) {
-    hCharge->second->Fill(chargeTot);
-  }
+  fills.charges.push_back({ detid, chargeTot });
 
   // filter out clusters with small charge, which are likely to be noise
   if ((chargeSum[0]+chargeSum[1]) < 100) {
@@ -751,71 +800,81 @@ bool PhysicsTask::plotPrecluster(const o2::mch::PreCluster& preCluster, gsl::spa
   }
 
   double Xcog, Ycog;
-  CoG(preClusterDigits, Xcog, Ycog);
+  CoG(preClusterDigits, *geometry, Xcog, Ycog);
 
   if (Ycog < 0) {
     return true;
   }
 
-  auto hXY0 = mHistogramPreclustersXY[0].find(detid);
-  if ((hXY0 != mHistogramPreclustersXY[0].end()) && (hXY0->second != NULL)) {
-    hXY0->second->Fill(Xcog, Ycog);
-  }
-
-  int hid = 1;
+  fills.positions.push_back({ detid, 0, Xcog, Ycog });
   if(cathode[0]) {
-    auto hXY1 = mHistogramPreclustersXY[1].find(detid);
-    if ((hXY1 != mHistogramPreclustersXY[1].end()) && (hXY1->second != NULL)) {
-      hXY1->second->Fill(Xcog, Ycog);
-    }
+    fills.positions.push_back({ detid, 1, Xcog, Ycog });
   }
   if(cathode[1]) {
-    auto hXY1 = mHistogramPreclustersXY[2].find(detid);
-    if ((hXY1 != mHistogramPreclustersXY[2].end()) && (hXY1->second != NULL)) {
-      hXY1->second->Fill(Xcog, Ycog);
-    }
+    fills.positions.push_back({ detid, 2, Xcog, Ycog });
   }
   if(cathode[0] && cathode[1]) {
-    auto hXY1 = mHistogramPreclustersXY[3].find(detid);
-    if ((hXY1 != mHistogramPreclustersXY[3].end()) && (hXY1->second != NULL)) {
-      hXY1->second->Fill(Xcog, Ycog);
-    }
+    fills.positions.push_back({ detid, 3, Xcog, Ycog });
   }
 
   return (cathode[0] && cathode[1]);
 }
 
 
+void PhysicsTask::fillPreclusterHistograms()
+{
+  // the buffers are merged in the order of the chunks
+  for (auto& fills : mPreclusterFills) {
+    for (auto& fill : fills.charges) {
+      auto h = mHistogramClchgDE.find(fill.de);
+      if (h && *h) {
+        (*h)->Fill(fill.charge);
+      }
+    }
+    for (auto& fill : fills.positions) {
+      auto h = mHistogramPreclustersXY[fill.histogram].find(fill.de);
+      if (h && *h) {
+        (*h)->Fill(fill.x, fill.y);
+      }
+    }
+    fills.charges.clear();
+    fills.positions.clear();
+  }
+}
+
+
 void PhysicsTask::endOfCycle()
 {
   QcInfoLogger::GetInstance() << "endOfCycle" << AliceO2::InfoLogger::InfoLogger::endm;
 
+  fillPreclusterHistograms();
+
   for(int de = 100; de <= 1030; de++) {
     for(int i = 0; i < 3; i++) {
       //std::cout<<"DE "<<de<<"  i "<<i<<std::endl;
       auto ih = mHistogramPreclustersXY[i+1].find(de);
-      if (ih == mHistogramPreclustersXY[i+1].end()) {
+      if (!ih) {
         continue;
       }
-      TH2F* hB = ih->second;
+      TH2F* hB = *ih;
       if (!hB) {
         continue;
       }
 
       ih = mHistogramPreclustersXY[0].find(de);
-      if (ih == mHistogramPreclustersXY[0].end()) {
+      if (!ih) {
         continue;
       }
-      TH2F* hAll = ih->second;
+      TH2F* hAll = *ih;
       if (!hAll) {
         continue;
       }
 
       ih = mHistogramPseudoeffXY[i].find(de);
-      if (ih == mHistogramPseudoeffXY[i].end()) {
+      if (!ih) {
         continue;
       }
-      TH2F* hEff = ih->second;
+      TH2F* hEff = *ih;
       if (!hEff) {
         continue;
       }
@@ -846,34 +905,34 @@ void PhysicsTask::endOfCycle()
       //std::cout<<"  de="<<de<<std::endl;
       {
         auto h = mHistogramADCamplitudeDE.find(de);
-        if ((h != mHistogramADCamplitudeDE.end()) && (h->second != NULL)) {
-          h->second->Write();
+        if (h && *h) {
+          (*h)->Write();
         }
       }
       {
         auto h = mHistogramNhitsDE.find(de);
-        if ((h != mHistogramNhitsDE.end()) && (h->second != NULL)) {
-          h->second->Write();
+        if (h && *h) {
+          (*h)->Write();
         }
       }
       {
         auto h = mHistogramNhitsHighAmplDE.find(de);
-        if ((h != mHistogramNhitsHighAmplDE.end()) && (h->second != NULL)) {
-          h->second->Write();
+        if (h && *h) {
+          (*h)->Write();
         }
       }
     }
     {
       for(int i = 0; i < 4; i++) {
-        for(auto& h2 : mHistogramPreclustersXY[i]) {
-          if (h2.second != nullptr) {
-            h2.second->Write();
+        for(auto h2 : mHistogramPreclustersXY[i].getObjects()) {
+          if (h2 != nullptr) {
+            h2->Write();
           }
         }
       }
-      for(auto& h : mHistogramClchgDE) {
-        if (h.second != nullptr) {
-          h.second->Write();
+      for(auto h : mHistogramClchgDE.getObjects()) {
+        if (h != nullptr) {
+          h->Write();
         }
       }
     }
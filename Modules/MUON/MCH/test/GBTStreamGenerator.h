@@ -0,0 +1,196 @@
+///
+/// \file   GBTStreamGenerator.h
+///
+/// Generator of MCH raw data used by the tests and the benchmarks of the decoder
+///
+
+#ifndef QC_MODULE_MUONCHAMBERS_GBTSTREAMGENERATOR_H
+#define QC_MODULE_MUONCHAMBERS_GBTSTREAMGENERATOR_H
+
+#include "Headers/RAWDataHeader.h"
+#include "DetectorsRaw/RDHUtils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <vector>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+constexpr uint64_t SAMPA_SYNC = 0x1555540f00113;
+
+// Generator of the data streams of the 40 dual SAMPA boards of one link, and of the corresponding GBT words
+class GBTStreamGenerator
+{
+ public:
+  GBTStreamGenerator(unsigned int seed) : mGenerator(seed) {}
+
+  void addBits(int board, uint64_t value, int nBits)
+  {
+    for (int b = 0; b < nBits; b++) {
+      mStreams[board].push_back((value >> b) & 0x1);
+    }
+  }
+
+  void addRandomBits(int board, int nBits)
+  {
+    std::uniform_int_distribution<int> bit(0, 1);
+    for (int b = 0; b < nBits; b++) {
+      mStreams[board].push_back(bit(mGenerator));
+    }
+  }
+
+  // SAMPA header with a valid Hamming code and header parity
+  static uint64_t makeHeader(uint64_t pkgType, uint64_t nbOf10BitWords, uint64_t chipAddress, uint64_t channelAddress, uint64_t bxc)
+  {
+    uint64_t header = (pkgType << 7) | (nbOf10BitWords << 10) | (chipAddress << 20) | (channelAddress << 24) | (bxc << 29);
+    // the 43 data bits are placed at the positions of the Hamming code which are not a power of 2
+    uint64_t hamming = 0;
+    int position = 3;
+    for (int i = 0; i < 43; i++, position++) {
+      while ((position & (position - 1)) == 0) {
+        position++;
+      }
+      if ((header >> (7 + i)) & 0x1) {
+        hamming ^= position;
+      }
+    }
+    header |= hamming & 0x3F;
+    uint64_t parity = 0;
+    for (int b = 0; b < 50; b++) {
+      if (b != 6) {
+        parity ^= (header >> b) & 0x1;
+      }
+    }
+    return header | (parity << 6);
+  }
+
+  // Packet with a list of clusters for one channel, returns the number of clusters
+  int addPacket(int board, int chip, int channel, int nClusters)
+  {
+    std::uniform_int_distribution<int> sampleValue(0, 1023);
+    std::uniform_int_distribution<int> clusterSize(1, 20);
+    std::vector<uint64_t> words;
+    for (int c = 0; c < nClusters; c++) {
+      int size = clusterSize(mGenerator);
+      words.push_back(size);
+      words.push_back(sampleValue(mGenerator)); // time
+      for (int s = 0; s < size; s++) {
+        words.push_back(sampleValue(mGenerator));
+      }
+    }
+    addBits(board, makeHeader(4, words.size(), chip, channel, 12345 + board), 50);
+    for (auto word : words) {
+      addBits(board, word, 10);
+    }
+    return nClusters;
+  }
+
+  // Stream made of random bits, sync words and packets, returns the number of clusters
+  int generate(int board)
+  {
+    std::uniform_int_distribution<int> junk(0, 100);
+    std::uniform_int_distribution<int> nClusters(1, 3);
+    int chip0 = (board % 5) * 2;
+    int clusters = 0;
+
+    addRandomBits(board, junk(mGenerator));
+    addBits(board, SAMPA_SYNC, 50);
+    addBits(board, SAMPA_SYNC, 50);
+    // the channel addresses are expected to be read in sequence
+    for (int channel = 0; channel < 32; channel++) {
+      for (int chip = chip0; chip <= chip0 + 1; chip++) {
+        clusters += addPacket(board, chip, channel, nClusters(mGenerator));
+      }
+    }
+    if (board % 3 == 0) {
+      // corrupted header, the decoder has to look for the next sync word
+      uint64_t header = makeHeader(4, 12, chip0, 0, 0) ^ (0x1 << 15);
+      addBits(board, header, 50);
+      addRandomBits(board, junk(mGenerator));
+      addBits(board, SAMPA_SYNC, 50);
+      clusters += addPacket(board, chip0, 0, nClusters(mGenerator));
+    }
+    return clusters;
+  }
+
+  // GBT words of 128 bits, with the board i connected to the bits 2i+1 and 2i
+  std::vector<uint32_t> getGBTWords()
+  {
+    size_t nBits = 0;
+    for (auto& stream : mStreams) {
+      nBits = std::max(nBits, stream.size());
+    }
+    size_t nWords = (nBits + 1) / 2;
+    std::vector<uint32_t> words(nWords * 4, 0);
+    for (int board = 0; board < 40; board++) {
+      auto& stream = mStreams[board];
+      stream.resize(nWords * 2, 0);
+      for (size_t w = 0; w < nWords; w++) {
+        uint32_t pair = (stream[2 * w] << 1) | stream[2 * w + 1];
+        words[w * 4 + board / 16] |= pair << (2 * (board % 16));
+      }
+    }
+    return words;
+  }
+
+ private:
+  std::mt19937 mGenerator;
+  std::vector<uint32_t> mStreams[40];
+};
+
+// all the boards of the 24 links of the CRU 0 are enabled
+inline void writeMappingFiles()
+{
+  std::ofstream cruMap("cru.map");
+  std::ofstream fecMap("fec.map");
+  for (int link = 0; link < 24; link++) {
+    cruMap << link + 1 << " 0 " << link << "\n";
+    for (int group = 0; group < 8; group++) {
+      fecMap << link + 1 << " " << group << " 500 1 2 3 4 5\n";
+    }
+  }
+}
+
+// CRU buffer with the GBT words of each link, split in pages of at most wordsPerPage words
+inline std::vector<char> makeCRUBuffer(const std::vector<std::vector<uint32_t>>& links, size_t wordsPerPage)
+{
+  std::vector<char> buffer;
+  bool morePages = true;
+  for (size_t first = 0; morePages; first += wordsPerPage) {
+    morePages = false;
+    for (size_t link = 0; link < links.size(); link++) {
+      size_t nGBTwords = links[link].size() / 4;
+      if (first >= nGBTwords) {
+        continue;
+      }
+      size_t n = std::min(wordsPerPage, nGBTwords - first);
+      morePages = morePages || (first + n < nGBTwords);
+
+      o2::header::RAWDataHeaderV6 rdh;
+      o2::raw::RDHUtils::setOffsetToNext(rdh, sizeof(rdh) + n * 16);
+      o2::raw::RDHUtils::setMemorySize(rdh, sizeof(rdh) + n * 16);
+      o2::raw::RDHUtils::setCRUID(rdh, 0);
+      o2::raw::RDHUtils::setLinkID(rdh, link % 12);
+      o2::raw::RDHUtils::setEndPointID(rdh, link / 12);
+      o2::raw::RDHUtils::setHeartBeatOrbit(rdh, 1);
+      const char* header = reinterpret_cast<const char*>(&rdh);
+      const char* payload = reinterpret_cast<const char*>(links[link].data() + first * 4);
+      buffer.insert(buffer.end(), header, header + sizeof(rdh));
+      buffer.insert(buffer.end(), payload, payload + n * 16);
+    }
+  }
+  return buffer;
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
+
+#endif // QC_MODULE_MUONCHAMBERS_GBTSTREAMGENERATOR_H
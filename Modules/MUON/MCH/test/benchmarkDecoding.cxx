@@ -0,0 +1,82 @@
+///
+/// \file   benchmarkDecoding.cxx
+///
+
+#include "MCH/Decoding.h"
+#include "GBTStreamGenerator.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <vector>
+
+using namespace o2::quality_control_modules::muonchambers;
+
+// all the heap allocations of the program are counted
+static std::atomic<size_t> gNbAllocations{ 0 };
+
+void* operator new(size_t size)
+{
+  gNbAllocations++;
+  if (void* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  std::free(ptr);
+}
+
+// Decoding rate and number of allocations per CRU buffer, in steady state
+int main(int argc, char** argv)
+{
+  int nBuffers = (argc > 1) ? std::stoi(argv[1]) : 100;
+  int nThreads = (argc > 2) ? std::stoi(argv[2]) : 1;
+
+  writeMappingFiles();
+  std::vector<std::vector<uint32_t>> links;
+  for (int link = 0; link < 24; link++) {
+    GBTStreamGenerator generator(link);
+    for (int board = 0; board < 40; board++) {
+      generator.generate(board);
+    }
+    links.push_back(generator.getGBTWords());
+  }
+  auto buffer = makeCRUBuffer(links, 500);
+
+  // the decoder is too large for the stack
+  auto decoder = std::make_unique<Decoder>();
+  decoder->initialize();
+  decoder->setNumberOfThreads(nThreads);
+
+  // the first buffer sizes the containers of the decoder
+  decoder->processData(buffer.data(), buffer.size());
+  decoder->reset();
+
+  size_t nHits = 0;
+  size_t nAllocations = gNbAllocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int b = 0; b < nBuffers; b++) {
+    decoder->processData(buffer.data(), buffer.size());
+    nHits += decoder->getHits().size();
+    decoder->reset();
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  nAllocations = gNbAllocations - nAllocations;
+
+  printf("%d buffers of %zu bytes, %d thread(s)\n", nBuffers, buffer.size(), nThreads);
+  printf("%-24s %12.0f\n", "hits/s", nHits / elapsed.count());
+  printf("%-24s %12.1f\n", "allocations/buffer", (double)nAllocations / nBuffers);
+
+  return 0;
+}
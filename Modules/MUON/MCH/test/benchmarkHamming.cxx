@@ -0,0 +1,54 @@
+///
+/// \file   benchmarkHamming.cxx
+///
+
+#include "MCH/Decoding.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace o2::quality_control_modules::muonchambers;
+
+// Time spent per header by the Hamming and parity checks of the SAMPA headers
+int main(int argc, char** argv)
+{
+  size_t nHeaders = (argc > 1) ? std::stoul(argv[1]) : 1000000;
+  int nRepetitions = 10;
+
+  std::mt19937_64 generator(1234);
+  std::vector<uint64_t> headers(nHeaders);
+  for (auto& header : headers) {
+    header = generator() & 0x3FFFFFFFFFFFF;
+  }
+
+  // the number of errors is accumulated so that the calls cannot be optimized away
+  auto run = [&](const char* name, auto&& check) {
+    size_t nErrors = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < nRepetitions; r++) {
+      for (auto header : headers) {
+        nErrors += check(header);
+      }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%-24s %8.2f ns/header (%zu errors)\n", name, elapsed.count() / (nHeaders * nRepetitions), nErrors);
+  };
+
+  run("HammingDecode", [](uint64_t header) {
+    unsigned int buffer[2] = { (unsigned int)(header & 0x3FFFFFFF), (unsigned int)(header >> 30) };
+    bool error = false, uncorrectable = false;
+    HammingDecode(buffer, error, uncorrectable, false);
+    return error;
+  });
+  run("FastHammingDecode", [](uint64_t header) {
+    bool error = false, uncorrectable = false;
+    FastHammingDecode(header, error, uncorrectable, false);
+    return error;
+  });
+  run("CheckDataParity", [](uint64_t header) { return CheckDataParity(header); });
+  run("FastCheckDataParity", [](uint64_t header) { return FastCheckDataParity(header); });
+
+  return 0;
+}
@@ -0,0 +1,59 @@
+///
+/// \file   benchmarkInitialize.cxx
+///
+
+#include "MCH/Decoding.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+using namespace o2::quality_control_modules::muonchambers;
+
+// Mapping files as large as the ones of the whole spectrometer
+void writeFullMappingFiles()
+{
+  std::ofstream cruMap("cru.map");
+  std::ofstream fecMap("fec.map");
+  for (int c = 0; c < MCH_MAX_CRU_IN_FLP; c++) {
+    for (int l = 0; l < 24; l++) {
+      cruMap << c * 24 + l << " " << c << " " << l << "\n";
+    }
+  }
+  for (int link_id = 0; link_id <= LINKID_MAX; link_id++) {
+    for (int group = 0; group < 8; group++) {
+      int de = 100 * (1 + link_id % 10) + link_id % 26;
+      fecMap << link_id << " " << group << " " << de << " " << group * 5 + 1 << " " << group * 5 + 2 << " " << group * 5 + 3 << " "
+             << group * 5 + 4 << " " << group * 5 + 5 << "\n";
+    }
+  }
+}
+
+// Time spent by the initialization of the decoder, with the mappings read from the text files or from their binary image
+int main(int argc, char** argv)
+{
+  int nRepetitions = (argc > 1) ? std::stoi(argv[1]) : 20;
+
+  writeFullMappingFiles();
+
+  auto run = [&](const char* name, bool useCache) {
+    double total = 0;
+    for (int r = 0; r < nRepetitions; r++) {
+      if (!useCache) {
+        std::remove("mapping.bin");
+      }
+      // the decoder is too large for the stack
+      auto decoder = std::make_unique<Decoder>();
+      auto start = std::chrono::steady_clock::now();
+      decoder->initialize();
+      std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+      total += elapsed.count();
+    }
+    printf("%-24s %8.2f ms/initialize\n", name, total / nRepetitions);
+  };
+
+  run("text mapping", false);
+  run("binary mapping", true);
+  return 0;
+}
@@ -0,0 +1,57 @@
+///
+/// \file   testDERegistry.cxx
+///
+
+#include "MCH/DERegistry.h"
+
+#define BOOST_TEST_MODULE DERegistry test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+BOOST_AUTO_TEST_CASE(registry_lookup)
+{
+  DERegistry<int*> registry;
+  int values[3] = { 1, 2, 3 };
+
+  BOOST_CHECK_EQUAL(registry.size(), 0);
+  BOOST_CHECK(registry.find(819) == nullptr);
+  BOOST_CHECK(registry.find(-1) == nullptr);
+  BOOST_CHECK(registry.find(MCH_DE_MAX) == nullptr);
+
+  // the objects are stored in the order in which the detection elements are added
+  registry[819] = &values[0];
+  registry[100] = &values[1];
+  registry[1025] = &values[2];
+  BOOST_REQUIRE_EQUAL(registry.size(), 3);
+  BOOST_CHECK_EQUAL(registry.getIndex(819), 0);
+  BOOST_CHECK_EQUAL(registry.getIndex(100), 1);
+  BOOST_CHECK_EQUAL(registry.getIndex(1025), 2);
+  BOOST_CHECK_EQUAL(registry.getDE(1), 100);
+  BOOST_CHECK_EQUAL(registry.at(2), &values[2]);
+
+  BOOST_REQUIRE(registry.find(100) != nullptr);
+  BOOST_CHECK_EQUAL(*registry.find(100), &values[1]);
+  BOOST_CHECK(registry.find(101) == nullptr);
+
+  // adding an existing detection element does not change the registry
+  registry[100] = &values[0];
+  BOOST_CHECK_EQUAL(registry.size(), 3);
+  BOOST_CHECK_EQUAL(*registry.find(100), &values[0]);
+
+  // new objects are value-initialized
+  BOOST_CHECK(registry[500] == nullptr);
+  BOOST_CHECK_EQUAL(registry.size(), 4);
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
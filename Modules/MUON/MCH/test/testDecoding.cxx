@@ -0,0 +1,166 @@
+///
+/// \file   testDecoding.cxx
+///
+
+#include "MCH/Decoding.h"
+#include "GBTStreamGenerator.h"
+
+#define BOOST_TEST_MODULE Decoding test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <memory>
+#include <random>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+bool hitLess(const SampaHit& h1, const SampaHit& h2)
+{
+  return (h1.link_id < h2.link_id) || (h1.link_id == h2.link_id && h1.ds_addr < h2.ds_addr);
+}
+
+void checkSameHits(Decoder& decoder, Decoder& referenceDecoder)
+{
+  std::vector<SampaHit> hits = decoder.getHits();
+  std::vector<SampaHit> reference = referenceDecoder.getHits();
+  // the order of the hits of different boards depends on the number of bits decoded at once,
+  // and the order of the hits of different links on the number of decoding threads
+  std::stable_sort(hits.begin(), hits.end(), hitLess);
+  std::stable_sort(reference.begin(), reference.end(), hitLess);
+
+  BOOST_REQUIRE_EQUAL(hits.size(), reference.size());
+  for (size_t i = 0; i < hits.size(); i++) {
+    BOOST_CHECK_EQUAL(hits[i].cru_id, reference[i].cru_id);
+    BOOST_CHECK_EQUAL(hits[i].link_id, reference[i].link_id);
+    BOOST_CHECK_EQUAL(hits[i].ds_addr, reference[i].ds_addr);
+    BOOST_CHECK_EQUAL(hits[i].chan_addr, reference[i].chan_addr);
+    BOOST_CHECK_EQUAL(hits[i].bxc, reference[i].bxc);
+    BOOST_CHECK_EQUAL(hits[i].size, reference[i].size);
+    BOOST_CHECK_EQUAL(hits[i].time, reference[i].time);
+    BOOST_CHECK_EQUAL(hits[i].csum, reference[i].csum);
+    BOOST_CHECK_EQUAL(hits[i].delta, reference[i].delta);
+    BOOST_REQUIRE_EQUAL(hits[i].nSamples, reference[i].nSamples);
+    const uint16_t* samples = decoder.getHitSamples(hits[i]);
+    const uint16_t* referenceSamples = referenceDecoder.getHitSamples(reference[i]);
+    BOOST_CHECK(std::equal(samples, samples + hits[i].nSamples, referenceSamples));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(word_level_decoding)
+{
+  writeMappingFiles();
+
+  for (unsigned int seed : { 1, 2, 3 }) {
+    GBTStreamGenerator generator(seed);
+    int clusters = 0;
+    for (int board = 0; board < 40; board++) {
+      clusters += generator.generate(board);
+    }
+    auto words = generator.getGBTWords();
+    size_t nGBTwords = words.size() / 4;
+
+    // the decoders are too large for the stack
+    auto reference = std::make_unique<Decoder>();
+    auto decoder = std::make_unique<Decoder>();
+    reference->initialize();
+    decoder->initialize();
+
+    // the data is split in pages whose size is not a multiple of the words decoded at once
+    size_t pageSize = 127 + seed;
+    for (size_t first = 0; first < nGBTwords; first += pageSize) {
+      size_t n = std::min(pageSize, nGBTwords - first);
+      reference->decodeRaw(words.data() + first * 4, n, 0, 0);
+      decoder->decodeRawWords(words.data() + first * 4, n, 0, 0);
+    }
+
+    BOOST_CHECK_EQUAL(reference->getHits().size(), static_cast<size_t>(clusters));
+    checkSameHits(*decoder, *reference);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_decoding)
+{
+  writeMappingFiles();
+
+  int clusters = 0;
+  std::vector<std::vector<uint32_t>> links;
+  for (int link = 0; link < 24; link++) {
+    GBTStreamGenerator generator(100 + link);
+    for (int board = 0; board < 40; board++) {
+      clusters += generator.generate(board);
+    }
+    links.push_back(generator.getGBTWords());
+  }
+  auto buffer = makeCRUBuffer(links, 500);
+
+  auto reference = std::make_unique<Decoder>();
+  auto decoder = std::make_unique<Decoder>();
+  reference->initialize();
+  decoder->initialize();
+  decoder->setNumberOfThreads(4);
+
+  reference->processData(buffer.data(), buffer.size());
+  decoder->processData(buffer.data(), buffer.size());
+
+  BOOST_CHECK_EQUAL(reference->getHits().size(), static_cast<size_t>(clusters));
+  checkSameHits(*decoder, *reference);
+  BOOST_CHECK_EQUAL(decoder->getDigits().size(), reference->getDigits().size());
+  BOOST_CHECK_EQUAL(decoder->getNbErrors(), reference->getNbErrors());
+  BOOST_CHECK_EQUAL(decoder->getNbWarnings(), reference->getNbWarnings());
+}
+
+void checkSameHamming(uint64_t header)
+{
+  for (bool fix : { false, true }) {
+    unsigned int buffer[2] = { (unsigned int)(header & 0x3FFFFFFF), (unsigned int)(header >> 30) };
+    bool error = false, uncorrectable = false;
+    HammingDecode(buffer, error, uncorrectable, fix);
+
+    uint64_t fastHeader = header;
+    bool fastError = false, fastUncorrectable = false;
+    FastHammingDecode(fastHeader, fastError, fastUncorrectable, fix);
+
+    BOOST_REQUIRE_EQUAL(fastError, error);
+    BOOST_REQUIRE_EQUAL(fastUncorrectable, uncorrectable);
+    BOOST_REQUIRE_EQUAL(fastHeader, (uint64_t)buffer[0] | ((uint64_t)buffer[1] << 30));
+  }
+  BOOST_REQUIRE_EQUAL(FastCheckDataParity(header), CheckDataParity(header));
+}
+
+BOOST_AUTO_TEST_CASE(hamming_equivalence)
+{
+  std::mt19937_64 generator(42);
+
+  // all the combinations of the Hamming code, the header parity and the following 13 bits
+  for (int i = 0; i < 3; i++) {
+    uint64_t high = generator() & 0x3FFFFFFF00000;
+    for (uint64_t low = 0; low < (1 << 20); low++) {
+      checkSameHamming(high | low);
+    }
+  }
+
+  // all the single and double bit errors of valid headers
+  for (int i = 0; i < 10; i++) {
+    uint64_t header = GBTStreamGenerator::makeHeader(generator() & 0x7, generator() & 0x3FF, generator() & 0xF, generator() & 0x1F, generator() & 0xFFFFF);
+    bool error = true, uncorrectable = true;
+    FastHammingDecode(header, error, uncorrectable, false);
+    BOOST_CHECK(!error);
+    for (int b1 = 0; b1 < 50; b1++) {
+      checkSameHamming(header ^ (((uint64_t)1) << b1));
+      for (int b2 = b1 + 1; b2 < 50; b2++) {
+        checkSameHamming(header ^ (((uint64_t)1) << b1) ^ (((uint64_t)1) << b2));
+      }
+    }
+  }
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
@@ -0,0 +1,150 @@
+///
+/// \file   testMappingCache.cxx
+///
+
+#include "MCH/Mapping.h"
+
+#define BOOST_TEST_MODULE MappingCache test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+const std::string cruMapFile = "testMappingCache_cru.map";
+const std::string fecMapFile = "testMappingCache_fec.map";
+const std::string cacheFile = "testMappingCache.bin";
+
+void writeMappingFiles(int firstDE)
+{
+  std::ofstream cruMap(cruMapFile);
+  std::ofstream fecMap(fecMapFile);
+  for (int c = 0; c < 3; c++) {
+    for (int l = 0; l < 24; l++) {
+      int link_id = c * 24 + l + 1;
+      cruMap << link_id << " " << c << " " << l << "\n";
+      for (int group = 0; group < 8; group++) {
+        fecMap << link_id << " " << group << " " << firstDE + link_id << " " << group * 5 + 1 << " " << group * 5 + 2 << " 0 "
+               << group * 5 + 4 << " " << group * 5 + 5 << "\n";
+      }
+    }
+  }
+}
+
+void checkSameMapping(MapCRU& mapCRU, MapFEC& mapFEC, MapCRU& referenceCRU, MapFEC& referenceFEC)
+{
+  for (int c = 0; c < MCH_MAX_CRU_IN_FLP; c++) {
+    for (int l = 0; l < 24; l++) {
+      BOOST_REQUIRE_EQUAL(mapCRU.getLink(c, l), referenceCRU.getLink(c, l));
+    }
+  }
+  for (uint32_t link_id = 0; link_id <= LINKID_MAX; link_id++) {
+    for (uint32_t ds_addr = 0; ds_addr < 40; ds_addr++) {
+      uint32_t de = 0, dsid = 0, referenceDE = 0, referenceDsid = 0;
+      bool found = mapFEC.getDSMapping(link_id, ds_addr, de, dsid);
+      BOOST_REQUIRE_EQUAL(found, referenceFEC.getDSMapping(link_id, ds_addr, referenceDE, referenceDsid));
+      BOOST_REQUIRE_EQUAL(de, referenceDE);
+      BOOST_REQUIRE_EQUAL(dsid, referenceDsid);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cache_same_as_text)
+{
+  writeMappingFiles(100);
+  std::remove(cacheFile.c_str());
+
+  auto referenceCRU = std::make_unique<MapCRU>();
+  auto referenceFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(referenceCRU->readMapping(cruMapFile));
+  BOOST_REQUIRE(referenceFEC->readDSMapping(fecMapFile));
+
+  // the first load reads the text files and generates the image
+  auto mapCRU = std::make_unique<MapCRU>();
+  auto mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(!MappingCache::read(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  BOOST_REQUIRE(MappingCache::load(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  checkSameMapping(*mapCRU, *mapFEC, *referenceCRU, *referenceFEC);
+
+  mapCRU = std::make_unique<MapCRU>();
+  mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(MappingCache::read(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  checkSameMapping(*mapCRU, *mapFEC, *referenceCRU, *referenceFEC);
+
+  // the image can be used without the text files
+  std::remove(cruMapFile.c_str());
+  std::remove(fecMapFile.c_str());
+  mapCRU = std::make_unique<MapCRU>();
+  mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(MappingCache::load(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  checkSameMapping(*mapCRU, *mapFEC, *referenceCRU, *referenceFEC);
+}
+
+BOOST_AUTO_TEST_CASE(cache_out_of_date)
+{
+  writeMappingFiles(100);
+  auto mapCRU = std::make_unique<MapCRU>();
+  auto mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(MappingCache::load(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+
+  // a change of the text files invalidates the image, which is regenerated
+  // (the new detection element numbers are longer, so that the change does not rely only on the modification time)
+  writeMappingFiles(1000);
+  auto referenceCRU = std::make_unique<MapCRU>();
+  auto referenceFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(referenceCRU->readMapping(cruMapFile));
+  BOOST_REQUIRE(referenceFEC->readDSMapping(fecMapFile));
+
+  mapCRU = std::make_unique<MapCRU>();
+  mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(!MappingCache::read(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  BOOST_REQUIRE(MappingCache::load(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  checkSameMapping(*mapCRU, *mapFEC, *referenceCRU, *referenceFEC);
+
+  mapCRU = std::make_unique<MapCRU>();
+  mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(MappingCache::read(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+  checkSameMapping(*mapCRU, *mapFEC, *referenceCRU, *referenceFEC);
+}
+
+BOOST_AUTO_TEST_CASE(cache_corrupted)
+{
+  writeMappingFiles(100);
+  auto mapCRU = std::make_unique<MapCRU>();
+  auto mapFEC = std::make_unique<MapFEC>();
+  BOOST_REQUIRE(MappingCache::load(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+
+  // a flipped byte in the entries is caught by the checksum
+  {
+    std::fstream file(cacheFile, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekg(-3, std::ios::end);
+    char c = file.get();
+    file.seekp(-3, std::ios::end);
+    file.put(c ^ 0x10);
+  }
+  BOOST_CHECK(!MappingCache::read(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+
+  // as well as a truncated file
+  {
+    std::ofstream file(cacheFile, std::ios::binary);
+    file << "MCHMAPB";
+  }
+  BOOST_CHECK(!MappingCache::read(cruMapFile, fecMapFile, cacheFile, *mapCRU, *mapFEC));
+
+  std::remove(cacheFile.c_str());
+  std::remove(cruMapFile.c_str());
+  std::remove(fecMapFile.c_str());
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
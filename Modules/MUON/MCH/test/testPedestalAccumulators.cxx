@@ -0,0 +1,118 @@
+///
+/// \file   testPedestalAccumulators.cxx
+///
+
+#include "MCH/PedestalsTask.h"
+
+#define BOOST_TEST_MODULE PedestalAccumulators test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+namespace o2
+{
+namespace quality_control_modules
+{
+namespace muonchambers
+{
+
+// reference: Welford's algorithm, updated with one sample at a time
+struct Welford {
+  uint64_t n = 0;
+  double mean = 0;
+  double m2 = 0;
+
+  void update(double sample)
+  {
+    n += 1;
+    double delta = sample - mean;
+    mean += delta / n;
+    m2 += delta * (sample - mean);
+  }
+  double getNoise() const { return (n > 0) ? std::sqrt(m2 / n) : 0; }
+};
+
+void checkChannel(const PedestalAccumulators& accumulators, size_t index, const Welford& reference)
+{
+  BOOST_CHECK_EQUAL(accumulators.nSamples[index], reference.n);
+  BOOST_CHECK_CLOSE(accumulators.getPedestal(index), reference.mean, 1e-9);
+  BOOST_CHECK_CLOSE(accumulators.getNoise(index), reference.getNoise(), 1e-6);
+}
+
+BOOST_AUTO_TEST_CASE(hits_merged_as_single_samples)
+{
+  std::mt19937 generator(1234);
+  std::normal_distribution<double> pedestal(150, 2);
+  std::uniform_int_distribution<uint32_t> hitSize(1, 40);
+
+  PedestalAccumulators accumulators;
+  std::vector<Welford> references(3);
+  for (size_t c = 0; c < references.size(); c++) {
+    BOOST_CHECK_EQUAL(accumulators.addChannel(), c);
+  }
+  BOOST_CHECK_EQUAL(accumulators.size(), references.size());
+
+  // each hit is merged at once with the previous samples of its channel
+  std::vector<uint16_t> samples;
+  for (int hit = 0; hit < 1000; hit++) {
+    size_t c = hit % references.size();
+    samples.resize(hitSize(generator));
+    for (auto& sample : samples) {
+      sample = static_cast<uint16_t>(std::lround(pedestal(generator)) & 0x3FF);
+      references[c].update(sample);
+    }
+    accumulators.update(c, samples.data(), samples.size());
+  }
+  // empty hits do not change anything
+  accumulators.update(0, samples.data(), 0);
+
+  for (size_t c = 0; c < references.size(); c++) {
+    checkChannel(accumulators, c, references[c]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(single_samples)
+{
+  PedestalAccumulators accumulators;
+  Welford reference;
+  accumulators.addChannel();
+  BOOST_CHECK_EQUAL(accumulators.getNoise(0), 0);
+
+  for (uint16_t sample : { 100, 104, 98, 101, 97, 103 }) {
+    accumulators.update(0, sample);
+    reference.update(sample);
+    checkChannel(accumulators, 0, reference);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(wide_digit_amplitudes)
+{
+  std::mt19937 generator(5678);
+  std::uniform_int_distribution<uint32_t> amplitude(60000, 1 << 20);
+
+  // the amplitudes of the digits do not fit in 16 bits
+  PedestalAccumulators accumulators;
+  Welford reference;
+  accumulators.addChannel();
+  for (int i = 0; i < 1000; i++) {
+    uint32_t adc = amplitude(generator);
+    accumulators.update(0, adc);
+    reference.update(adc);
+  }
+  checkChannel(accumulators, 0, reference);
+
+  std::vector<uint32_t> samples(100);
+  for (auto& sample : samples) {
+    sample = amplitude(generator);
+    reference.update(sample);
+  }
+  accumulators.update(0, samples.data(), samples.size());
+  checkChannel(accumulators, 0, reference);
+}
+
+} // namespace muonchambers
+} // namespace quality_control_modules
+} // namespace o2
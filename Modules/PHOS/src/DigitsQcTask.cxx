@@ -90,7 +90,7 @@ void DigitsQcTask::monitorData(o2::framework::ProcessingContext& ctx)
   for (auto trg : triggerrecords) {
     if (!trg.getNumberOfObjects())
       continue;
-    QcInfoLogger::GetInstance() << QcInfoLogger::Debug << "Next event " << eventcouter << " has " << trg.getNumberOfObjects() << " digits" << QcInfoLogger::endm;
+    ILOG_FILTERED(Debug) << "Next event " << eventcouter << " has " << trg.getNumberOfObjects() << " digits" << ENDM;
     gsl::span<const o2::phos::Digit> eventdigits(digitcontainer.data() + trg.getFirstEntry(), trg.getNumberOfObjects());
     processPhysicsEvent(eventdigits);
     //OR Pedestal or LED event
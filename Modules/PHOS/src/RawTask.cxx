@@ -223,7 +223,7 @@ void RawTask::monitorData(o2::framework::ProcessingContext& ctx)
   //  using CHTYP = o2::phos::ChannelType_t;
 
   Int_t nPagesMessage = 0, nSuperpagesMessage = 0;
-  QcInfoLogger::GetInstance() << QcInfoLogger::Debug << " Processing message " << mNumberOfMessages << AliceO2::InfoLogger::InfoLogger::endm;
+  ILOG_FILTERED(Debug) << " Processing message " << mNumberOfMessages << ENDM;
   mNumberOfMessages++;
   mMessageCounter->Fill(1);
 
@@ -235,11 +235,11 @@ void RawTask::monitorData(o2::framework::ProcessingContext& ctx)
       const auto* header = header::get<header::DataHeader*>(input.header);
       // get payload of a specific input, which is a char array.
       // const char* payload = input.payload;
-      QcInfoLogger::GetInstance() << QcInfoLogger::Debug << "Processing superpage " << mNumberOfSuperpages << AliceO2::InfoLogger::InfoLogger::endm;
+      ILOG_FILTERED(Debug) << "Processing superpage " << mNumberOfSuperpages << ENDM;
       mNumberOfSuperpages++;
       nSuperpagesMessage++;
       mSuperpageCounter->Fill(1);
-      QcInfoLogger::GetInstance() << QcInfoLogger::Debug << " PHOS Reading Payload size: " << header->payloadSize << " for " << header->dataOrigin << AliceO2::InfoLogger::InfoLogger::endm;
+      ILOG_FILTERED(Debug) << " PHOS Reading Payload size: " << header->payloadSize << " for " << header->dataOrigin << ENDM;
 
       //fill the histogram with payload sizes
       mHistogram->Fill(header->payloadSize);
@@ -252,7 +252,7 @@ void RawTask::monitorData(o2::framework::ProcessingContext& ctx)
       // short int maxADCMod[20];
       // short int minADCMod[20];
       // while (rawreader.hasNext()) {
-      //   QcInfoLogger::GetInstance() << QcInfoLogger::Debug << " Processing page " << mNumberOfPages << AliceO2::InfoLogger::InfoLogger::endm;
+      //   ILOG_FILTERED(Debug) << " Processing page " << mNumberOfPages << ENDM;
       //   mNumberOfPages++;
       //   nPagesMessage++;
       //   mPageCounter->Fill(1);
@@ -0,0 +1,127 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   BinnedFills.h
+///
+
+#ifndef QC_MODULE_TOF_BINNEDFILLS_H
+#define QC_MODULE_TOF_BINNEDFILLS_H
+
+// ROOT includes
+#include "TH1.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace o2::quality_control_modules::tof
+{
+
+/// \brief Class to count the fills of a histogram per bin, such that they are added at once to the histogram.
+/// It does not touch the histogram while counting, so that each thread can count the fills of its own data.
+/// The values filled with Fill are taken into account in the statistics of the histogram, as with TH1::Fill.
+/// The bins filled with FillBin are not, in this case the statistics are recomputed from the bin contents.
+class BinnedFills
+{
+ public:
+  /// Function to take the binning of a histogram, the x axis must have bins of the same width
+  void SetBinning(const TH1* h)
+  {
+    counts.assign(h->GetNcells(), 0);
+    nbins = h->GetNbinsX();
+    xmin = h->GetXaxis()->GetXmin();
+    xmax = h->GetXaxis()->GetXmax();
+    Reset();
+  }
+  /// Function to count a value of a 1D histogram
+  void Fill(double x)
+  {
+    entries++;
+    if (x < xmin) {
+      counts[0]++;
+    } else if (!(x < xmax)) {
+      counts[nbins + 1]++;
+    } else {
+      counts[1 + int(nbins * (x - xmin) / (xmax - xmin))]++;
+      sumw++;
+      sumwx += x;
+      sumwx2 += x * x;
+    }
+  }
+  /// Function to count a fill of a bin, given by its global bin number
+  void FillBin(int bin)
+  {
+    entries++;
+    counts[bin]++;
+    statsFromBins = true;
+  }
+  /// Function to add the counted fills to a histogram with the same binning
+  void AddTo(TH1* h) const
+  {
+    if (entries == 0) {
+      return;
+    }
+    Double_t stats[TH1::kNstat] = { 0 };
+    h->GetStats(stats);
+    const Double_t hentries = h->GetEntries();
+    for (size_t bin = 0; bin < counts.size(); bin++) {
+      if (counts[bin] > 0) {
+        h->AddBinContent(bin, counts[bin]);
+        if (h->GetSumw2N() > 0) {
+          (*h->GetSumw2())[bin] += counts[bin];
+        }
+      }
+    }
+    if (statsFromBins) {
+      h->ResetStats();
+      return;
+    }
+    stats[0] += sumw;
+    stats[1] += sumw;
+    stats[2] += sumwx;
+    stats[3] += sumwx2;
+    h->PutStats(stats);
+    h->SetEntries(hentries + entries);
+  }
+  /// Function to reset the counted fills
+  void Reset()
+  {
+    if (entries > 0) {
+      std::fill(counts.begin(), counts.end(), 0);
+    }
+    entries = 0;
+    sumw = 0;
+    sumwx = 0;
+    sumwx2 = 0;
+    statsFromBins = false;
+  }
+  /// Getter for the number of counted fills
+  uint64_t GetEntries() const { return entries; }
+
+ private:
+  /// Fills per global bin, including the underflow and the overflow
+  std::vector<uint32_t> counts;
+  /// Binning of the x axis
+  int nbins = 0;
+  double xmin = 0;
+  double xmax = 0;
+  /// Statistics of the counted values, as in TH1
+  uint64_t entries = 0;
+  double sumw = 0;
+  double sumwx = 0;
+  double sumwx2 = 0;
+  /// Flag set when bins are filled without their value
+  bool statsFromBins = false;
+};
+
+} // namespace o2::quality_control_modules::tof
+
+#endif // QC_MODULE_TOF_BINNEDFILLS_H
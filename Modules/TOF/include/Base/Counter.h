@@ -29,6 +29,9 @@ namespace o2::quality_control_modules::tof
 {
 
 /// \brief Class to count events
+/// The counter keeps track of whether it changed since it was last filled into a histogram, such that only the
+/// changed counters need to be rendered. The logging is only compiled in the debug mode, as Count is called for
+/// each decoded word.
 /// \author Nicolo' Jacazio
 template <typename Tc>
 class Counter
@@ -41,28 +44,37 @@ class Counter
   /// Function to increment a counter
   void Count(UInt_t v)
   {
-    if (v > Tc::size) {
+    if (v >= Tc::size) {
       ILOG(Error) << "Incrementing counter too far! " << v << "/" << Size() << ENDM;
+      return;
     }
 #ifdef ENABLE_COUNTER_DEBUG_MODE
     ILOG(Info) << "Incrementing " << v << "/" << Size() << " to " << counter[v] << ENDM;
 #endif
     counter[v]++;
+    changed = true;
   }
   /// Function to reset counters
   void Reset()
   {
+#ifdef ENABLE_COUNTER_DEBUG_MODE
     ILOG(Info) << "Resetting Counter" << ENDM;
+#endif
     for (UInt_t i = 0; i < Tc::size; i++) {
       counter[i] = 0;
     }
+    changed = true;
   }
   /// Function to get how many counts where observed
   uint32_t HowMany(UInt_t pos) const { return counter[pos]; }
+  /// Function to know if the counters changed since the last time they were filled into a histogram
+  bool IsChanged() const { return changed; }
   /// Function to make a histogram out of the counters
   void MakeHistogram(TH1* h) const
   {
+#ifdef ENABLE_COUNTER_DEBUG_MODE
     ILOG(Info) << "Making Histogram " << h->GetName() << " out of counter" << ENDM;
+#endif
     h->Reset();
     h->GetXaxis()->Set(Tc::size, 0, Tc::size);
     UInt_t binx = 1;
@@ -77,10 +89,12 @@ class Counter
     h->Print("All");
 #endif
   }
-  /// Function to fill a histogram with the counters
-  void FillHistogram(TH1* h, UInt_t biny = 0, UInt_t binz = 0) const
+  /// Function to fill a histogram with the counters, after which the counters are not changed anymore
+  void FillHistogram(TH1* h, UInt_t biny = 0, UInt_t binz = 0)
   {
+#ifdef ENABLE_COUNTER_DEBUG_MODE
     ILOG(Info) << "Filling Histogram " << h->GetName() << " out of counter" << ENDM;
+#endif
     UInt_t binx = 1;
     for (UInt_t i = 0; i < Tc::size; i++) {
       if (Tc::names[i].IsNull()) {
@@ -100,6 +114,7 @@ class Counter
       }
       binx++;
     }
+    changed = false;
 #ifdef ENABLE_COUNTER_DEBUG_MODE
     h->Print("All");
 #endif
@@ -112,6 +127,8 @@ class Counter
   static_assert(std::is_same<decltype(Tc::names), const TString[Tc::size]>::value, "names must be const TString arrays");
   /// Containers to fill
   uint32_t counter[Tc::size] = { 0 };
+  /// Flag set when the counters change, cleared when they are filled into a histogram
+  bool changed = false;
 };
 
 } // namespace o2::quality_control_modules::tof
@@ -17,6 +17,10 @@
 #define QC_MODULE_TOF_TOFDECODERCOMPRESSED_H
 
 #include "TH1.h"
+#include "TH2.h"
+
+#include <memory>
+#include <vector>
 
 // O2 includes
 #include "TOFReconstruction/DecoderBase.h"
@@ -38,11 +42,17 @@ class TOFDecoderCompressed final : public DecoderBase
   /// Destructor
   ~TOFDecoderCompressed() = default;
 
-  /// Function to run decoding
+  /// Function to run decoding, the histograms are up to date when it returns
   void decode();
 
-  /// Histograms to fill
-  std::map<std::string, std::shared_ptr<TH1>> mHistos;
+  /// Histograms to fill, set by the task before decoding
+  std::shared_ptr<TH1> mHits;         /// Number of TOF hits per frame
+  std::shared_ptr<TH1> mTime;         /// Time
+  std::shared_ptr<TH1> mTimeBC;       /// Time in Bunch Crossing
+  std::shared_ptr<TH1> mTOT;          /// Time-Over-Threshold
+  std::shared_ptr<TH1> mIndexE;       /// Index in electronic
+  std::shared_ptr<TH2> mSlotPartMask; /// Participating slot
+  std::shared_ptr<TH2> mDiagnostic;   /// Diagnostic histogram
 
   Int_t rdhread = 0; /// Number of times a RDH is read
 
@@ -55,6 +65,36 @@ class TOFDecoderCompressed final : public DecoderBase
   void trailerHandler(const CrateHeader_t* crateHeader, const CrateOrbit_t* crateOrbit,
                       const CrateTrailer_t* crateTrailer, const Diagnostic_t* diagnostics,
                       const Error_t* errors) override;
+
+  /// Fills all the buffered values into the histograms
+  void flush();
+
+  /// Values to be filled at once into a 1D histogram with FillN
+  struct Buffer1D {
+    std::vector<double> x;
+    void add(double value) { x.push_back(value); }
+    void flush(TH1* h);
+  };
+  /// Values to be filled at once into a 2D histogram with FillN
+  struct Buffer2D {
+    std::vector<double> x;
+    std::vector<double> y;
+    void add(double valueX, double valueY)
+    {
+      x.push_back(valueX);
+      y.push_back(valueY);
+    }
+    void flush(TH2* h);
+  };
+
+  static constexpr size_t sMaxBufferedHits = 4096; /// the buffers are flushed when they have more hits
+  Buffer1D mHitsBuffer;
+  Buffer1D mTimeBuffer;
+  Buffer1D mTimeBCBuffer;
+  Buffer1D mTOTBuffer;
+  Buffer1D mIndexEBuffer;
+  Buffer2D mSlotPartMaskBuffer;
+  Buffer2D mDiagnosticBuffer;
 };
 
 } // namespace o2::quality_control_modules::tof
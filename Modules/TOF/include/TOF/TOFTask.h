@@ -17,6 +17,10 @@
 #define QC_MODULE_TOF_TOFTASK_H
 
 #include "QualityControl/TaskInterface.h"
+#include "Base/BinnedFills.h"
+
+#include <cstdint>
+#include <vector>
 
 class TH1F;
 class TH2F;
@@ -58,6 +62,29 @@ class TOFTask final : public TaskInterface
   static const Int_t fgkFiredMacropadLimit; /// Limit on cut on number of fired macropad
 
  private:
+  /// \brief Geometry of a TOF channel, computed once for all the channels
+  struct ChannelGeometry {
+    int32_t hitMapBin; /// Global bin of the channel in mTOFRawHitMap
+    int32_t side;      /// Side of the channel: 0 for I/A, 1 for O/A, 2 for I/C and 3 for O/C
+  };
+  /// \brief Histogram fills of the readout windows analysed by one thread, which are added at the end of the cycle
+  struct DigitFills {
+    BinnedFills multi;        /// Fills of mTOFRawsMulti
+    BinnedFills multiSide[4]; /// Fills of the multiplicity per side
+    BinnedFills time[4];      /// Fills of the hit time per side, summed for mTOFRawsTime
+    BinnedFills tot[4];       /// Fills of the hit ToT per side, summed for mTOFRawsToT
+    BinnedFills hitMap;       /// Fills of mTOFRawHitMap
+  };
+
+  /// Fills the digit fills of all the threads into the histograms
+  void fillDigitHistograms();
+  /// Resets the digit fills of all the threads
+  void resetDigitFills();
+
+  std::vector<ChannelGeometry> mChannelGeometry; /// Geometry of the channels, indexed by channel number
+  int mDigitThreads = 1;                         /// Number of threads analysing the readout windows
+  std::vector<DigitFills> mDigitFills;           /// Digit fills, one per thread
+
   std::shared_ptr<TH1I> mTOFRawsMulti;   /// TOF raw hit multiplicity per event
   std::shared_ptr<TH1I> mTOFRawsMultiIA; /// TOF raw hit multiplicity per event - I/A side
   std::shared_ptr<TH1I> mTOFRawsMultiOA; /// TOF raw hit multiplicity per event - O/A side
@@ -51,6 +51,9 @@ class TaskDiagnostics    /*final*/
   void reset() override;
 
  private:
+  /// Fills the counters which changed since the previous call into the histograms, or all of them if requested
+  void fillHistograms(bool all);
+
   // Histograms
 #ifdef ENABLE_2D_HISTOGRAMS
   std::shared_ptr<TH2F> mRDHCounterHisto;                                                    /// Words per RDH
@@ -64,7 +67,8 @@ class TaskDiagnostics    /*final*/
   std::shared_ptr<TH1F> mTRMChainCounterHisto[Diagnostics::ncrates][Diagnostics::ntrms][Diagnostics::ntrmschains]; /// Words per TRM Chain
 #endif
 
-  Diagnostics mCounter; /// Decoder and counter for TOF Compressed data useful for the Task
+  Diagnostics mCounter;         /// Decoder and counter for TOF Compressed data useful for the Task
+  bool mFillAllCounters = true; /// The histograms were reset, so all the counters have to be filled again
 };
 
 } // namespace o2::quality_control_modules::tof
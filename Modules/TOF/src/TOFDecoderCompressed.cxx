@@ -33,13 +33,42 @@ namespace o2::quality_control_modules::tof
 void TOFDecoderCompressed::decode()
 {
   DecoderBase::run();
+  flush();
+}
+
+void TOFDecoderCompressed::Buffer1D::flush(TH1* h)
+{
+  if (!x.empty()) {
+    h->FillN(x.size(), x.data(), nullptr);
+    x.clear();
+  }
+}
+
+void TOFDecoderCompressed::Buffer2D::flush(TH2* h)
+{
+  if (!x.empty()) {
+    h->FillN(x.size(), x.data(), y.data(), nullptr);
+    x.clear();
+    y.clear();
+  }
+}
+
+void TOFDecoderCompressed::flush()
+{
+  mHitsBuffer.flush(mHits.get());
+  mTimeBuffer.flush(mTime.get());
+  mTimeBCBuffer.flush(mTimeBC.get());
+  mTOTBuffer.flush(mTOT.get());
+  mIndexEBuffer.flush(mIndexE.get());
+  mSlotPartMaskBuffer.flush(mSlotPartMask.get());
+  mDiagnosticBuffer.flush(mDiagnostic.get());
 }
 
 void TOFDecoderCompressed::headerHandler(const CrateHeader_t* crateHeader, const CrateOrbit_t* /*crateOrbit*/)
 {
   for (int ibit = 0; ibit < 11; ++ibit) {
     if (crateHeader->slotPartMask & (1 << ibit)) {
-      mHistos.at("hSlotPartMask")->Fill(crateHeader->drmID, ibit + 2);
+      mSlotPartMaskBuffer.add(crateHeader->drmID, ibit + 2);
     }
   }
 }
@@ -47,7 +76,11 @@ void TOFDecoderCompressed::headerHandler(const CrateHeader_t* crateHeader, const
 void TOFDecoderCompressed::frameHandler(const CrateHeader_t* crateHeader, const CrateOrbit_t* /*crateOrbit*/,
                                         const FrameHeader_t* frameHeader, const PackedHit_t* packedHits)
 {
-  mHistos.at("hHits")->Fill(frameHeader->numberOfHits);
+  // the values are buffered and filled at once, which avoids the overhead of TH1::Fill for each hit
+  if (mIndexEBuffer.x.size() + frameHeader->numberOfHits > sMaxBufferedHits) {
+    flush();
+  }
+  mHitsBuffer.add(frameHeader->numberOfHits);
   for (int i = 0; i < frameHeader->numberOfHits; ++i) {
     auto packedHit = packedHits + i;
     auto indexE = packedHit->channel +
@@ -59,10 +92,10 @@ void TOFDecoderCompressed::frameHandler(const CrateHeader_t* crateHeader, const
     int timebc = time % 1024;
     time += (frameHeader->frameID << 13);
 
-    mHistos.at("hIndexE")->Fill(indexE);
-    mHistos.at("hTime")->Fill(time);
-    mHistos.at("hTimeBC")->Fill(timebc);
-    mHistos.at("hTOT")->Fill(packedHit->tot);
+    mIndexEBuffer.add(indexE);
+    mTimeBuffer.add(time);
+    mTimeBCBuffer.add(timebc);
+    mTOTBuffer.add(packedHit->tot);
   }
 }
 
@@ -72,7 +105,7 @@ void TOFDecoderCompressed::trailerHandler(const CrateHeader_t* crateHeader, cons
 {
   for (int i = 0; i < crateTrailer->numberOfDiagnostics; ++i) {
     auto diagnostic = diagnostics + i;
-    mHistos.at("hDiagnostic")->Fill(crateHeader->drmID, diagnostic->slotID);
+    mDiagnosticBuffer.add(crateHeader->drmID, diagnostic->slotID);
   }
 }
 
@@ -21,6 +21,9 @@
 #include <TH1I.h>
 #include <TH2I.h>
 
+#include <algorithm>
+#include <thread>
+
 // O2 includes
 #include "TOFBase/Digit.h"
 #include "TOFBase/Geo.h"
@@ -32,6 +35,9 @@
 namespace o2::quality_control_modules::tof
 {
 
+// smaller sets of digits are not worth splitting among threads
+static constexpr size_t sMinDigitsPerThread = 10000;
+
 Int_t TOFTask::fgNbinsMultiplicity = 2000;       /// Number of bins in multiplicity plot
 Int_t TOFTask::fgRangeMinMultiplicity = 0;       /// Min range in multiplicity plot
 Int_t TOFTask::fgRangeMaxMultiplicity = 1000;    /// Max range in multiplicity plot
@@ -231,11 +237,48 @@ void TOFTask::initialize(o2::framework::InitContext& /*ctx*/)
 
   mNfiredMacropad.reset(new TH1I("NfiredMacropad", "Number of fired TOF macropads per event; number of fired macropads; Events ", 50, 0, 50));
   getObjectsManager()->startPublishing(mNfiredMacropad.get());
+
+  if (auto param = mCustomParameters.find("digitThreads"); param != mCustomParameters.end()) {
+    mDigitThreads = std::max(1, std::stoi(param->second));
+  }
+  mDigitFills.resize(mDigitThreads);
+  for (auto& fills : mDigitFills) {
+    fills.multi.SetBinning(mTOFRawsMulti.get());
+    for (Int_t i = 0; i < 4; i++) {
+      fills.multiSide[i].SetBinning(mTOFRawsMulti.get());
+      fills.time[i].SetBinning(mTOFRawsTime.get());
+      fills.tot[i].SetBinning(mTOFRawsToT.get());
+    }
+    fills.hitMap.SetBinning(mTOFRawHitMap.get());
+  }
+
+  // SM in side I: 14-17, 0-4 -> 4 + 5
+  // SM in side O: 5-13 -> 9
+  // phi is counted every pad starting from SM 0.
+  // There are 48 pads per SM. Side I is from phi 0:48*4 and 48*14:48*18
+  const Int_t phi_I1 = 48 * 4;
+  const Int_t phi_I2 = 48 * 14;
+  // eta is counted every half strip starting from strip 0.
+  // Halves strips in side A 0-90, in side C 91-181
+  const Int_t half_eta = 91;
+  Int_t eta, phi;
+  o2::tof::Digit digit;
+  mChannelGeometry.resize(o2::tof::Geo::NCHANNELS);
+  for (Int_t ch = 0; ch < o2::tof::Geo::NCHANNELS; ch++) {
+    const Int_t strip = ((ch / 96) % 91); // Strip index
+    const Int_t ech = o2::tof::Geo::getECHFromCH(ch);
+    mChannelGeometry[ch].hitMapBin = mTOFRawHitMap->FindBin(Float_t(o2::tof::Geo::getCrateFromECH(ech)) / 4.f, strip);
+    digit.setChannel(ch);
+    digit.getPhiAndEtaIndex(phi, eta);
+    const Bool_t isSectorI = phi < phi_I1 || phi > phi_I2;
+    mChannelGeometry[ch].side = (eta < half_eta ? 0 : 2) + (isSectorI ? 0 : 1);
+  }
 }
 
 void TOFTask::startOfActivity(Activity& /*activity*/)
 {
   ILOG(Info) << "startOfActivity" << ENDM;
+  resetDigitFills();
   mTOFRawsMulti->Reset();
   mTOFRawsMultiIA->Reset();
   mTOFRawsMultiOA->Reset();
@@ -296,74 +339,49 @@ void TOFTask::monitorData(o2::framework::ProcessingContext& ctx)
   auto rows = ctx.inputs().get<std::vector<o2::tof::ReadoutWindowData>>("readoutwin");
   LOG(INFO) << "ReadoutWindow size::: " << rows.size();
 
-  Int_t eta, phi;
-  // Int_t det[5] = { 0 }; // Coordinates
-  Int_t strip = 0; // Strip (Put it into Geo.h?)
-  Float_t tdc_time = 0;
-  Float_t tot_time = 0;
-  // SM in side I: 14-17, 0-4 -> 4 + 5
-  // SM in side O: 5-13 -> 9
-  // phi is counted every pad starting from SM 0.
-  // There are 48 pads per SM. Side I is from phi 0:48*4 and 48*14:48*18
-  const Int_t phi_I1 = 48 * 4;
-  const Int_t phi_I2 = 48 * 14;
-  // eta is counted every half strip starting from strip 0.
-  // Halves strips in side A 0-90, in side C 91-181
-  const Int_t half_eta = 91;
-  Bool_t isSectorI = kFALSE;
-  Int_t ndigits[4] = { 0 }; // Number of digits per side I/A,O/A,I/C,O/C
-
-  // Loop on readout windows
-  for (const auto& row : rows) {
-    mTOFRawsMulti->Fill(row.size());                      // Number of digits inside a readout window
-    auto digits_in_row = row.getBunchChannelData(digits); // Digits inside a readout window
-    // Loop on digits
-    for (auto const& digit : digits_in_row) {
-      strip = ((digit.getChannel() / 96) % 91); // Strip index
-      // o2::tof::Geo::getVolumeIndices(digit.getChannel(), det);
-      // LOG(INFO) << "Filling digit #" << ndigits << " in sector #" << det[0] << " and strip #" << strip;
-      Int_t ech = o2::tof::Geo::getECHFromCH(digit.getChannel());
-      // mTOFRawHitMap->Fill(det[0], strip);
-      mTOFRawHitMap->Fill(Float_t(o2::tof::Geo::getCrateFromECH(ech)) / 4.f, strip);
-      // TDC time and ToT time
-      tdc_time = digit.getTDC() * o2::tof::Geo::TDCBIN * 0.001;
-      tot_time = digit.getTOT() * o2::tof::Geo::TOTBIN_NS;
-      mTOFRawsTime->Fill(tdc_time);
-      mTOFRawsToT->Fill(tot_time);
-      digit.getPhiAndEtaIndex(phi, eta);
-      isSectorI = phi < phi_I1 || phi > phi_I2;
-      if (eta < half_eta) { // Sector A
-        if (isSectorI) {    // Sector I/A
-          mTOFRawsTimeIA->Fill(tdc_time);
-          mTOFRawsToTIA->Fill(tot_time);
-          ndigits[0]++;
-        } else { // Sector O/A
-          mTOFRawsTimeOA->Fill(tdc_time);
-          mTOFRawsToTOA->Fill(tot_time);
-          ndigits[1]++;
-        }
-      } else {           // Sector C
-        if (isSectorI) { // Sector I/C
-          mTOFRawsTimeIC->Fill(tdc_time);
-          mTOFRawsToTIC->Fill(tot_time);
-          ndigits[2]++;
-        } else { // Sector O/C
-          mTOFRawsTimeOC->Fill(tdc_time);
-          mTOFRawsToTOC->Fill(tot_time);
-          ndigits[3]++;
+  // the readout windows are split in contiguous chunks, one per thread, and each thread counts the histogram fills
+  // of its chunk, such that the histograms are only updated by fillDigitHistograms()
+  const Int_t nThreads = std::max<Int_t>(1, std::min<size_t>(mDigitThreads, digits.size() / sMinDigitsPerThread));
+  auto worker = [&](Int_t t) {
+    auto& fills = mDigitFills[t];
+    const size_t first = rows.size() * t / nThreads;
+    const size_t last = rows.size() * (t + 1) / nThreads;
+    // Loop on readout windows
+    for (size_t i = first; i < last; i++) {
+      const auto& row = rows[i];
+      fills.multi.Fill(row.size());                         // Number of digits inside a readout window
+      auto digits_in_row = row.getBunchChannelData(digits); // Digits inside a readout window
+      Int_t ndigits[4] = { 0 };                             // Number of digits per side I/A,O/A,I/C,O/C
+      // Loop on digits
+      for (auto const& digit : digits_in_row) {
+        if (digit.getChannel() < 0 || digit.getChannel() >= o2::tof::Geo::NCHANNELS) {
+          continue;
         }
+        const auto& geometry = mChannelGeometry[digit.getChannel()];
+        fills.hitMap.FillBin(geometry.hitMapBin);
+        // TDC time and ToT time
+        const Float_t tdc_time = digit.getTDC() * o2::tof::Geo::TDCBIN * 0.001;
+        const Float_t tot_time = digit.getTOT() * o2::tof::Geo::TOTBIN_NS;
+        fills.time[geometry.side].Fill(tdc_time);
+        fills.tot[geometry.side].Fill(tot_time);
+        ndigits[geometry.side]++;
+      }
+      // Filling histograms of hit multiplicity
+      for (Int_t side = 0; side < 4; side++) {
+        fills.multiSide[side].Fill(ndigits[side]);
       }
     }
-    // Filling histograms of hit multiplicity
-    mTOFRawsMultiIA->Fill(ndigits[0]);
-    mTOFRawsMultiOA->Fill(ndigits[1]);
-    mTOFRawsMultiIC->Fill(ndigits[2]);
-    mTOFRawsMultiOC->Fill(ndigits[3]);
-    //
-    ndigits[0] = 0;
-    ndigits[1] = 0;
-    ndigits[2] = 0;
-    ndigits[3] = 0;
+  };
+  if (nThreads == 1) {
+    worker(0);
+  } else {
+    std::vector<std::thread> threads;
+    for (Int_t t = 0; t < nThreads; t++) {
+      threads.emplace_back(worker, t);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
   }
 
   // LOG(INFO) << "Digits counted:::::::: " << ndigits << "stop";
@@ -413,6 +431,7 @@ void TOFTask::monitorData(o2::framework::ProcessingContext& ctx)
 void TOFTask::endOfCycle()
 {
   ILOG(Info) << "endOfCycle" << ENDM;
+  fillDigitHistograms();
 }
 
 void TOFTask::endOfActivity(Activity& /*activity*/)
@@ -420,11 +439,44 @@ void TOFTask::endOfActivity(Activity& /*activity*/)
   ILOG(Info) << "endOfActivity" << ENDM;
 }
 
+void TOFTask::fillDigitHistograms()
+{
+  std::shared_ptr<TH1I> multiSide[4] = { mTOFRawsMultiIA, mTOFRawsMultiOA, mTOFRawsMultiIC, mTOFRawsMultiOC };
+  std::shared_ptr<TH1F> timeSide[4] = { mTOFRawsTimeIA, mTOFRawsTimeOA, mTOFRawsTimeIC, mTOFRawsTimeOC };
+  std::shared_ptr<TH1F> totSide[4] = { mTOFRawsToTIA, mTOFRawsToTOA, mTOFRawsToTIC, mTOFRawsToTOC };
+  for (const auto& fills : mDigitFills) {
+    fills.multi.AddTo(mTOFRawsMulti.get());
+    for (Int_t side = 0; side < 4; side++) {
+      fills.multiSide[side].AddTo(multiSide[side].get());
+      fills.time[side].AddTo(timeSide[side].get());
+      fills.time[side].AddTo(mTOFRawsTime.get());
+      fills.tot[side].AddTo(totSide[side].get());
+      fills.tot[side].AddTo(mTOFRawsToT.get());
+    }
+    fills.hitMap.AddTo(mTOFRawHitMap.get());
+  }
+  resetDigitFills();
+}
+
+void TOFTask::resetDigitFills()
+{
+  for (auto& fills : mDigitFills) {
+    fills.multi.Reset();
+    for (Int_t side = 0; side < 4; side++) {
+      fills.multiSide[side].Reset();
+      fills.time[side].Reset();
+      fills.tot[side].Reset();
+    }
+    fills.hitMap.Reset();
+  }
+}
+
 void TOFTask::reset()
 {
   // clean all the monitor objects here
 
   ILOG(Info) << "Resetting the histogram" << ENDM;
+  resetDigitFills();
   mTOFRawsMulti->Reset();
   mTOFRawsMultiIA->Reset();
   mTOFRawsMultiOA->Reset();
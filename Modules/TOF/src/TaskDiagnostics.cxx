@@ -92,44 +92,65 @@ void TaskDiagnostics::monitorData(o2::framework::ProcessingContext& ctx)
     mCounter.setDecoderBufferSize(payloadInSize);
     mCounter.decode();
   }
+  // the histograms are only filled at the end of the cycle
+}
+
+void TaskDiagnostics::endOfCycle()
+{
+  ILOG(Info) << "endOfCycle" << ENDM;
+  fillHistograms(mFillAllCounters);
+  mFillAllCounters = false;
+}
+
+void TaskDiagnostics::endOfActivity(Activity& /*activity*/)
+{
+  ILOG(Info) << "endOfActivity" << ENDM;
+}
+
+void TaskDiagnostics::fillHistograms(bool all)
+{
 #ifdef ENABLE_2D_HISTOGRAMS
   for (Int_t i = 0; i < Diagnostics::ncrates; i++) {
-    mCounter.mDRMCounter[i].FillHistogram(mDRMCounterHisto.get(), i + 1);
+    if (all || mCounter.mDRMCounter[i].IsChanged()) {
+      mCounter.mDRMCounter[i].FillHistogram(mDRMCounterHisto.get(), i + 1);
+    }
     for (Int_t j = 0; j < Diagnostics::ntrms; j++) {
-      mCounter.mTRMCounter[i][j].FillHistogram(mTRMCounterHisto[j].get(), i + 1);
+      if (all || mCounter.mTRMCounter[i][j].IsChanged()) {
+        mCounter.mTRMCounter[i][j].FillHistogram(mTRMCounterHisto[j].get(), i + 1);
+      }
       for (Int_t k = 0; k < Diagnostics::ntrmschains; k++) {
-        mCounter.mTRMChainCounter[i][j][k].FillHistogram(mTRMChainCounterHisto[j][k].get(), i + 1);
+        if (all || mCounter.mTRMChainCounter[i][j][k].IsChanged()) {
+          mCounter.mTRMChainCounter[i][j][k].FillHistogram(mTRMChainCounterHisto[j][k].get(), i + 1);
+        }
       }
     }
   }
 #else
   for (Int_t i = 0; i < Diagnostics::ncrates; i++) {
-    mCounter.mDRMCounter[i].FillHistogram(mDRMCounterHisto[i].get());
+    if (all || mCounter.mDRMCounter[i].IsChanged()) {
+      mCounter.mDRMCounter[i].FillHistogram(mDRMCounterHisto[i].get());
+    }
     for (Int_t j = 0; j < Diagnostics::ntrms; j++) {
-      mCounter.mTRMCounter[i][j].FillHistogram(mTRMCounterHisto[i][j].get());
+      if (all || mCounter.mTRMCounter[i][j].IsChanged()) {
+        mCounter.mTRMCounter[i][j].FillHistogram(mTRMCounterHisto[i][j].get());
+      }
       for (Int_t k = 0; k < Diagnostics::ntrmschains; k++) {
-        mCounter.mTRMChainCounter[i][j][k].FillHistogram(mTRMChainCounterHisto[i][j][k].get());
+        if (all || mCounter.mTRMChainCounter[i][j][k].IsChanged()) {
+          mCounter.mTRMChainCounter[i][j][k].FillHistogram(mTRMChainCounterHisto[i][j][k].get());
+        }
       }
     }
   }
 #endif
 }
 
-void TaskDiagnostics::endOfCycle()
-{
-  ILOG(Info) << "endOfCycle" << ENDM;
-}
-
-void TaskDiagnostics::endOfActivity(Activity& /*activity*/)
-{
-  ILOG(Info) << "endOfActivity" << ENDM;
-}
-
 void TaskDiagnostics::reset()
 {
   // clean all the monitor objects here
 
   ILOG(Info) << "Resetting the histogram" << ENDM;
+  // the counters are not reset, thus all of them are needed to fill the histograms again
+  mFillAllCounters = true;
 #ifdef ENABLE_2D_HISTOGRAMS
   mDRMCounterHisto->Reset();
   for (Int_t j = 0; j < Diagnostics::ntrms; j++) {
@@ -0,0 +1,138 @@
+// Copyright CERN and copyright holders of ALICE O2. This software is
+// distributed under the terms of the GNU General Public License v3 (GPL
+// Version 3), copied verbatim in the file "COPYING".
+//
+// See http://alice-o2.web.cern.ch/license for full licensing information.
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   benchmarkDecoderCompressed.cxx
+///
+
+#include "QualityControl/QcInfoLogger.h"
+#include "TOF/TOFDecoderCompressed.h"
+#include "Headers/RAWDataHeader.h"
+
+#include <TH1F.h>
+#include <TH2F.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace o2::quality_control_modules::tof;
+
+namespace
+{
+
+template <typename T>
+void push(std::vector<char>& buffer, const T& word)
+{
+  const char* data = reinterpret_cast<const char*>(&word);
+  buffer.insert(buffer.end(), data, data + sizeof(T));
+}
+
+// One HBF per crate and orbit: an RDH with the crate payload, then a closing RDH
+void generateHBF(std::vector<char>& buffer, std::mt19937& generator, int crate, int orbit, int hitsPerFrame)
+{
+  std::vector<char> payload;
+  CrateHeader_t crateHeader{};
+  crateHeader.drmID = crate;
+  crateHeader.slotPartMask = 0x7FF;
+  crateHeader.mustBeOne = 1;
+  push(payload, crateHeader);
+  CrateOrbit_t crateOrbit{};
+  crateOrbit.orbitID = orbit;
+  push(payload, crateOrbit);
+
+  for (int trm = 3; trm <= 12; trm++) {
+    FrameHeader_t frameHeader{};
+    frameHeader.numberOfHits = hitsPerFrame;
+    frameHeader.frameID = generator() % 256;
+    frameHeader.trmID = trm;
+    push(payload, frameHeader);
+    for (int i = 0; i < hitsPerFrame; i++) {
+      PackedHit_t hit{};
+      hit.chain = generator() % 2;
+      hit.tdcID = generator() % 15;
+      hit.channel = generator() % 8;
+      hit.time = generator() % 8192;
+      hit.tot = generator() % 2048;
+      push(payload, hit);
+    }
+  }
+
+  CrateTrailer_t crateTrailer{};
+  crateTrailer.numberOfDiagnostics = 1;
+  crateTrailer.eventCounter = orbit;
+  crateTrailer.mustBeOne = 1;
+  push(payload, crateTrailer);
+  Diagnostic_t diagnostic{};
+  diagnostic.slotID = 3 + generator() % 10;
+  push(payload, diagnostic);
+
+  o2::header::RAWDataHeader rdh;
+  rdh.feeId = crate;
+  rdh.memorySize = rdh.headerSize + payload.size();
+  rdh.offsetToNext = rdh.memorySize;
+  rdh.stop = 0;
+  push(buffer, rdh);
+  buffer.insert(buffer.end(), payload.begin(), payload.end());
+
+  rdh.memorySize = rdh.headerSize;
+  rdh.offsetToNext = rdh.headerSize;
+  rdh.stop = 1;
+  push(buffer, rdh);
+}
+
+} // namespace
+
+// Decoding time of synthetic compressed data, where the 72 crates send one HBF per orbit with one frame per TRM.
+// The histograms are binned like the ones of TOFTaskCompressed.
+int main(int argc, char** argv)
+{
+  int nOrbits = (argc > 1) ? std::stoi(argv[1]) : 100;
+  int hitsPerFrame = (argc > 2) ? std::stoi(argv[2]) : 16;
+  int nRepetitions = (argc > 3) ? std::stoi(argv[3]) : 10;
+  const int nCrates = 72;
+
+  std::mt19937 generator(1234);
+  std::vector<char> buffer;
+  for (int orbit = 0; orbit < nOrbits; orbit++) {
+    for (int crate = 0; crate < nCrates; crate++) {
+      generateHBF(buffer, generator, crate, orbit, hitsPerFrame);
+    }
+  }
+  size_t nHits = (size_t)nOrbits * nCrates * 10 * hitsPerFrame;
+
+  // the decoder is too large for the stack
+  auto decoder = std::make_unique<TOFDecoderCompressed>();
+  decoder->mHits = std::make_shared<TH1F>("hHits", "hHits;Number of hits", 1000, 0., 1000.);
+  decoder->mTime = std::make_shared<TH1F>("hTime", "hTime;time (24.4 ps)", 2097152, 0., 2097152.);
+  decoder->mTimeBC = std::make_shared<TH1F>("hTimeBC", "hTimeBC;time (24.4 ps)", 1024, 0., 1024.);
+  decoder->mTOT = std::make_shared<TH1F>("hTOT", "hTOT;ToT (48.8 ps)", 2048, 0., 2048.);
+  decoder->mIndexE = std::make_shared<TH1F>("hIndexE", "hIndexE;index EO", 172800, 0., 172800.);
+  decoder->mSlotPartMask = std::make_shared<TH2F>("hSlotPartMask", "hSlotPartMask;crate;slot", 72, 0., 72., 12, 1., 13.);
+  decoder->mDiagnostic = std::make_shared<TH2F>("hDiagnostic", "hDiagnostic;crate;slot", 72, 0., 72., 12, 1., 13.);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < nRepetitions; i++) {
+    decoder->setDecoderBuffer(buffer.data());
+    decoder->setDecoderBufferSize(buffer.size());
+    decoder->decode();
+  }
+  std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+
+  printf("%d orbits of %d crates, %d hits per frame, %zu bytes\n", nOrbits, nCrates, hitsPerFrame, buffer.size());
+  printf("%-32s %12.1f\n", "decoding (ns/hit)", time.count() * 1e9 / (nHits * nRepetitions));
+  printf("%-32s %12.1f\n", "throughput (MB/s)", buffer.size() * nRepetitions / time.count() / 1e6);
+  printf("%-32s %12.0f (expected %zu)\n", "hits in hIndexE", decoder->mIndexE->GetEntries(), nHits * nRepetitions);
+  return 0;
+}
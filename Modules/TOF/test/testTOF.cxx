@@ -14,16 +14,57 @@
 ///
 
 #include "QualityControl/TaskFactory.h"
+#include "Base/BinnedFills.h"
 
 #define BOOST_TEST_MODULE Publisher test
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 
 #include <boost/test/unit_test.hpp>
+#include <TH1F.h>
+#include <TH2F.h>
 
 namespace o2::quality_control_modules::tof
 {
 
 BOOST_AUTO_TEST_CASE(instantiate_task) { BOOST_CHECK(true); }
 
+BOOST_AUTO_TEST_CASE(binned_fills)
+{
+  TH1F filled("filled", "filled", 10, 0., 5.);
+  TH1F added("added", "added", 10, 0., 5.);
+  BinnedFills fills;
+  fills.SetBinning(&added);
+  for (double x : { -1., 0., 0.3, 2.5, 4.99, 5., 7., 1.2, 1.2 }) {
+    filled.Fill(x);
+    filled.Fill(x);
+    fills.Fill(x);
+  }
+  BOOST_CHECK_EQUAL(fills.GetEntries(), 9);
+  fills.AddTo(&added);
+  fills.AddTo(&added);
+  fills.Reset();
+  fills.AddTo(&added);
+  for (int bin = 0; bin <= 11; bin++) {
+    BOOST_CHECK_EQUAL(added.GetBinContent(bin), filled.GetBinContent(bin));
+  }
+  BOOST_CHECK_EQUAL(added.GetEntries(), filled.GetEntries());
+  BOOST_CHECK_CLOSE(added.GetMean(), filled.GetMean(), 1e-6);
+  BOOST_CHECK_CLOSE(added.GetRMS(), filled.GetRMS(), 1e-6);
+
+  TH2F filled2D("filled2D", "filled2D", 4, 0., 4., 3, 0., 3.);
+  TH2F added2D("added2D", "added2D", 4, 0., 4., 3, 0., 3.);
+  BinnedFills fills2D;
+  fills2D.SetBinning(&added2D);
+  filled2D.Fill(1.5, 2.5);
+  filled2D.Fill(3.5, 0.5);
+  fills2D.FillBin(added2D.FindBin(1.5, 2.5));
+  fills2D.FillBin(added2D.FindBin(3.5, 0.5));
+  fills2D.AddTo(&added2D);
+  BOOST_CHECK_EQUAL(added2D.GetBinContent(2, 3), 1);
+  BOOST_CHECK_EQUAL(added2D.GetBinContent(4, 1), 1);
+  BOOST_CHECK_EQUAL(added2D.GetEntries(), filled2D.GetEntries());
+  BOOST_CHECK_CLOSE(added2D.GetMean(1), filled2D.GetMean(1), 1e-6);
+}
+
 } // namespace o2::quality_control_modules::tof